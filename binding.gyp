@@ -5,10 +5,21 @@
       'target_name': 'dvBinding',
       'sources': [
         'src/Matrix.cc',
+        'src/blur.cc',
+        'src/compressedimage.cc',
+        'src/deskew.cc',
         'src/image.cc',
+        'src/imagereader.cc',
+        'src/pixpool.cc',
+        'src/projection.cc',
+        'src/resample.cc',
+        'src/runlength.cc',
+        'src/runlengthimage.cc',
         'src/tesseract.cc',
+        'src/tiffreader.cc',
         'src/util.cc',
         'src/zxing.cc',
+        'src/barcodetracker.cc',
         'src/module.cc',
       ],
       'libraries': [
@@ -1,3 +1,7 @@
+# The dependencies are built for the CPU of the build machine
+# (-march=native). Their SIMD code paths are therefore chosen at compile
+# time from the predefined macros (__SSE2__, __SSE4_1__, __AVX2__), with
+# scalar fallbacks, and there is no runtime CPU dispatch.
 {
   'target_defaults': {
     'conditions': [
@@ -47,7 +47,9 @@
  *      pixel per 120 PIII clock cycles, for a horizontal or vertical
  *      erosion or dilation.  The computation time doubles for opening
  *      or closing, or for a square SE, as expected, and is independent
- *      of the size of the SE.
+ *      of the size of the SE.  The low-level functions now process
+ *      16 or more pixels at once with SIMD min/max where available,
+ *      which makes them several times faster.
  *
  *      A faster implementation can be made directly for brick Sels
  *      of maximum size 3.  We unroll the computation for sets of 8 bytes.
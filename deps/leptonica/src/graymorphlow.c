@@ -88,10 +88,37 @@
  *      at least this many words, so if this isn't clear, see the
  *      leptonica documentation on grayscale morphology.
  *
+ *      The window arrays are computed for many pixels at once, so
+ *      that the inner loops run over contiguous bytes and can use
+ *      SIMD min/max instructions.  A vertical pass sweeps whole rows
+ *      (the byte order within the words does not matter there),
+ *      in strips of columns that keep the window in the cache.
+ *      A horizontal pass transposes blocks of rows into a buffer
+ *      where each column is contiguous, and then works the same way.
  */
 
+#include <string.h>
 #include "allheaders.h"
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+    /* Number of rows transposed together in a horizontal pass */
+static const l_int32  ROWS_PER_BLOCK = 16;
+    /* Number of bytes of a row in a strip of a vertical pass */
+static const l_int32  BYTES_PER_STRIP = 1024;
+
+static l_int32 grayMorphLow(l_uint32 *datad, l_int32 w, l_int32 h,
+                            l_int32 wpld, l_uint32 *datas, l_int32 wpls,
+                            l_int32 size, l_int32 direction, l_int32 type);
+static void grayMorphLinesLow(l_uint8 *lined, l_uint8 **lines,
+                              l_int32 stride, l_uint8 *window,
+                              l_uint8 *forward, l_int32 n,
+                              l_int32 size, l_int32 type);
+static void grayMinMaxLow(l_uint8 *datad, const l_uint8 *data1,
+                          const l_uint8 *data2, l_int32 n, l_int32 type);
+
 
 /*-----------------------------------------------------------------*
  *              Low-level gray morphological operations            *
@@ -118,6 +145,9 @@
  *          the end the border is removed.
  *
  *    Method: Algorithm by van Herk and Gil and Werman
+ *
+ *    Note: buffer and maxarray are only used if there is not enough
+ *          memory for processing many pixels at once.
  */
 void
 dilateGrayLow(l_uint32  *datad,
@@ -136,6 +166,10 @@ l_int32    hsize, nsteps, startmax, startx, starty;
 l_uint8    maxval;
 l_uint32  *lines, *lined;
 
+    if (grayMorphLow(datad, w, h, wpld, datas, wpls, size, direction,
+                     L_MORPH_DILATE) == 0)
+        return;
+
     if (direction == L_HORIZ) {
         hsize = size / 2;
         nsteps = (w - 2 * hsize) / size;
@@ -234,6 +268,8 @@ l_uint32  *lines, *lined;
  *
  *    Method: Algorithm by van Herk and Gil and Werman
  *
+ *    Note: buffer and minarray are only used if there is not enough
+ *          memory for processing many pixels at once.
  */
 void
 erodeGrayLow(l_uint32  *datad,
@@ -252,6 +288,10 @@ l_int32    hsize, nsteps, startmin, startx, starty;
 l_uint8    minval;
 l_uint32  *lines, *lined;
 
+    if (grayMorphLow(datad, w, h, wpld, datas, wpls, size, direction,
+                     L_MORPH_ERODE) == 0)
+        return;
+
     if (direction == L_HORIZ) {
         hsize = size / 2;
         nsteps = (w - 2 * hsize) / size;
@@ -325,3 +365,213 @@ l_uint32  *lines, *lined;
 
     return;
 }
+
+
+/*-----------------------------------------------------------------*
+ *          Helpers for processing many lines at once              *
+ *-----------------------------------------------------------------*/
+/*!
+ *  grayMorphLow()
+ *
+ *    Input: datad, w, h, wpld (8 bpp image)
+ *           datas, wpls  (8 bpp image, of same dimensions)
+ *           size  (full length of SEL; restricted to odd numbers)
+ *           direction  (L_HORIZ or L_VERT)
+ *           type  (L_MORPH_DILATE or L_MORPH_ERODE)
+ *    Return: 0 if OK, 1 if the work arrays could not be made
+ *
+ *    Notes:
+ *        (1) This gives the same result as the scalar code in
+ *            dilateGrayLow() and erodeGrayLow(), and is called by them.
+ *        (2) A vertical pass works on strips of up to BYTES_PER_STRIP
+ *            bytes of each row.  A horizontal pass transposes blocks of
+ *            ROWS_PER_BLOCK rows, so that pixel j of all rows in the
+ *            block is found at bytes [j * ROWS_PER_BLOCK, ...).
+ */
+static l_int32
+grayMorphLow(l_uint32  *datad,
+             l_int32    w,
+             l_int32    h,
+             l_int32    wpld,
+             l_uint32  *datas,
+             l_int32    wpls,
+             l_int32    size,
+             l_int32    direction,
+             l_int32    type)
+{
+l_int32    i, j, k, n, nrows, nbytes, hsize, nsteps;
+l_uint8   *window, *forward, *trans, *transd;
+l_uint8  **lines;
+l_uint32  *lined;
+
+    hsize = size / 2;
+    if (direction == L_HORIZ) {
+        nsteps = (w - 2 * hsize) / size;
+        if (nsteps <= 0)
+            return 0;
+        n = ROWS_PER_BLOCK;
+        nbytes = w * ROWS_PER_BLOCK;
+        trans = (l_uint8 *)CALLOC(2 * nbytes, sizeof(l_uint8));
+        window = (l_uint8 *)CALLOC(size * n, sizeof(l_uint8));
+        forward = (l_uint8 *)CALLOC(n, sizeof(l_uint8));
+        lines = (l_uint8 **)CALLOC(2 * size, sizeof(l_uint8 *));
+        if (!trans || !window || !forward || !lines) {
+            FREE(trans);
+            FREE(window);
+            FREE(forward);
+            FREE(lines);
+            return 1;
+        }
+        transd = trans + nbytes;
+
+        for (i = 0; i < h; i += ROWS_PER_BLOCK) {
+            nrows = L_MIN(ROWS_PER_BLOCK, h - i);
+
+                /* transpose the rows of the block */
+            for (k = 0; k < nrows; k++) {
+                l_uint32 *line = datas + (i + k) * wpls;
+                for (j = 0; j < w; j++)
+                    trans[j * ROWS_PER_BLOCK + k] = GET_DATA_BYTE(line, j);
+            }
+
+            for (j = 0; j < nsteps; j++) {
+                for (k = 0; k < 2 * size - 1; k++)
+                    lines[k] = trans + (j * size + k) * ROWS_PER_BLOCK;
+                grayMorphLinesLow(transd + (hsize + j * size) * ROWS_PER_BLOCK,
+                                  lines, ROWS_PER_BLOCK, window, forward, n,
+                                  size, type);
+            }
+
+                /* transpose the result back */
+            for (k = 0; k < nrows; k++) {
+                lined = datad + (i + k) * wpld;
+                for (j = hsize; j < hsize + nsteps * size; j++)
+                    SET_DATA_BYTE(lined, j, transd[j * ROWS_PER_BLOCK + k]);
+            }
+        }
+
+        FREE(trans);
+    }
+    else {   /* direction == L_VERT */
+        nsteps = (h - 2 * hsize) / size;
+        if (nsteps <= 0)
+            return 0;
+            /* byte order within words is irrelevant here */
+        nbytes = 4 * L_MIN(wpls, wpld);
+        n = L_MIN(nbytes, BYTES_PER_STRIP);
+        window = (l_uint8 *)CALLOC(size * n, sizeof(l_uint8));
+        forward = (l_uint8 *)CALLOC(n, sizeof(l_uint8));
+        lines = (l_uint8 **)CALLOC(2 * size, sizeof(l_uint8 *));
+        if (!window || !forward || !lines) {
+            FREE(window);
+            FREE(forward);
+            FREE(lines);
+            return 1;
+        }
+
+        for (j = 0; j < nbytes; j += n) {
+            n = L_MIN(n, nbytes - j);
+            for (i = 0; i < nsteps; i++) {
+                for (k = 0; k < 2 * size - 1; k++)
+                    lines[k] = (l_uint8 *)(datas + (i * size + k) * wpls) + j;
+                lined = datad + (hsize + i * size) * wpld;
+                grayMorphLinesLow((l_uint8 *)lined + j, lines, 4 * wpld,
+                                  window, forward, n, size, type);
+            }
+        }
+    }
+
+    FREE(window);
+    FREE(forward);
+    FREE(lines);
+    return 0;
+}
+
+
+/*!
+ *  grayMorphLinesLow()
+ *
+ *    Input: lined  (first of size dest lines, each of n bytes)
+ *           lines  (array of 2 * size - 1 src lines, each of n bytes)
+ *           stride  (bytes between the dest lines)
+ *           window  (work array of size * n bytes)
+ *           forward  (work array of n bytes)
+ *           n  (number of bytes in each line)
+ *           size  (full length of SEL)
+ *           type  (L_MORPH_DILATE or L_MORPH_ERODE)
+ *    Return: void
+ *
+ *    Notes:
+ *        (1) This is one step of vHGW for n pixels in parallel.  The
+ *            window holds the backward partial extrema from the
+ *            center line lines[size - 1]; the forward extrema are
+ *            accumulated in place while the dest lines are written.
+ */
+static void
+grayMorphLinesLow(l_uint8   *lined,
+                  l_uint8  **lines,
+                  l_int32    stride,
+                  l_uint8   *window,
+                  l_uint8   *forward,
+                  l_int32    n,
+                  l_int32    size,
+                  l_int32    type)
+{
+l_int32  k;
+
+    memcpy(window + (size - 1) * n, lines[size - 1], n);
+    for (k = size - 2; k >= 0; k--)
+        grayMinMaxLow(window + k * n, window + (k + 1) * n, lines[k], n, type);
+
+    memcpy(forward, lines[size - 1], n);
+    memcpy(lined, window, n);
+    for (k = 1; k < size; k++) {
+        grayMinMaxLow(forward, forward, lines[size - 1 + k], n, type);
+        grayMinMaxLow(lined + k * stride, window + k * n, forward, n, type);
+    }
+    return;
+}
+
+
+/*!
+ *  grayMinMaxLow()
+ *
+ *    Input: datad  (n bytes; may be the same as data1)
+ *           data1, data2  (n bytes each)
+ *           n  (number of bytes)
+ *           type  (L_MORPH_DILATE for max, L_MORPH_ERODE for min)
+ *    Return: void
+ */
+static void
+grayMinMaxLow(l_uint8        *datad,
+              const l_uint8  *data1,
+              const l_uint8  *data2,
+              l_int32         n,
+              l_int32         type)
+{
+l_int32  i = 0;
+
+    if (type == L_MORPH_DILATE) {
+#ifdef __SSE2__
+        for (; i + 16 <= n; i += 16) {
+            _mm_storeu_si128((__m128i *)(datad + i),
+                _mm_max_epu8(_mm_loadu_si128((const __m128i *)(data1 + i)),
+                             _mm_loadu_si128((const __m128i *)(data2 + i))));
+        }
+#endif
+        for (; i < n; i++)
+            datad[i] = L_MAX(data1[i], data2[i]);
+    }
+    else {
+#ifdef __SSE2__
+        for (; i + 16 <= n; i += 16) {
+            _mm_storeu_si128((__m128i *)(datad + i),
+                _mm_min_epu8(_mm_loadu_si128((const __m128i *)(data1 + i)),
+                             _mm_loadu_si128((const __m128i *)(data2 + i))));
+        }
+#endif
+        for (; i < n; i++)
+            datad[i] = L_MIN(data1[i], data2[i]);
+    }
+    return;
+}
@@ -46,6 +46,15 @@
  *         PIX     *pixCloseCompBrickExtendDwa()
  *         l_int32  getExtendedCompositeParameters()
  *
+ *    Binary exact morphological (dwa) ops with chains of linear brick Sels
+ *         PIX     *pixDilateBrickChainDwa()
+ *         PIX     *pixErodeBrickChainDwa()
+ *         PIX     *pixOpenBrickChainDwa()
+ *         PIX     *pixCloseBrickChainDwa()
+ *         PIX     *pixCloseSafeBrickChainDwa()
+ *         static PIX  *pixMorphBrickChainDwa()
+ *         static l_int32  pixFMorphopChainGen_1()
+ *
  *    These are higher-level interfaces for dwa morphology with brick Sels.
  *    Because many morphological operations are performed using
  *    separable brick Sels, it is useful to have a simple interface
@@ -1597,3 +1606,313 @@ l_int32  n, extra, fact1, fact2;
     *pextra = extra;
     return 0;
 }
+
+
+/*-----------------------------------------------------------------*
+ *   Binary exact morphological (dwa) ops with chains of linear    *
+ *   brick Sels                                                    *
+ *-----------------------------------------------------------------*/
+    /* Sizes of the linear brick Sels compiled into fmorphgen.1.c */
+static const l_int32  dwa_linear[] = {2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13,
+                                      14, 15, 20, 21, 25, 30, 31, 35, 40, 41,
+                                      45, 50, 51};
+
+static PIX *pixMorphBrickChainDwa(PIX *pixs, l_int32 hsize, l_int32 vsize,
+                                  l_int32 operation);
+static l_int32 pixFMorphopChainGen_1(PIX **ppixt1, PIX **ppixt2,
+                                     l_int32 operation, l_int32 size,
+                                     l_int32 direction);
+
+
+/*!
+ *  pixDilateBrickChainDwa()
+ *
+ *      Input:  pixs (1 bpp)
+ *              hsize (width of brick Sel)
+ *              vsize (height of brick Sel)
+ *      Return: pixd, or null on error
+ *
+ *  Notes:
+ *      (1) This gives the same result as pixDilateBrick() for any
+ *          brick size, unlike pixDilateCompBrickExtendDwa(), which can
+ *          be off by up to 2 pixels in each direction.
+ *      (2) Each direction is done by a chain of the linear dwa Sels in
+ *          fmorphgen.1.c.  Applying Sels of lengths a and b in turn is
+ *          the same as applying one of length a + b - 1, as long as the
+ *          origins add up, which they do if at most one length is even.
+ *          So we use the largest odd Sels until the rest of the length
+ *          is one that was generated.
+ *      (3) The border is added once for the whole chain, and each step
+ *          is a single pass over the image, so that large bricks cost
+ *          a few passes over memory instead of one rasterop per pixel
+ *          of the Sel.
+ */
+PIX *
+pixDilateBrickChainDwa(PIX     *pixs,
+                       l_int32  hsize,
+                       l_int32  vsize)
+{
+    PROCNAME("pixDilateBrickChainDwa");
+
+    if (!pixs)
+        return (PIX *)ERROR_PTR("pixs not defined", procName, NULL);
+    if (pixGetDepth(pixs) != 1)
+        return (PIX *)ERROR_PTR("pixs not 1 bpp", procName, NULL);
+    if (hsize < 1 || vsize < 1)
+        return (PIX *)ERROR_PTR("hsize and vsize not >= 1", procName, NULL);
+
+    return pixMorphBrickChainDwa(pixs, hsize, vsize, L_MORPH_DILATE);
+}
+
+
+/*!
+ *  pixErodeBrickChainDwa()
+ *
+ *      Input:  pixs (1 bpp)
+ *              hsize (width of brick Sel)
+ *              vsize (height of brick Sel)
+ *      Return: pixd, or null on error
+ *
+ *  Notes:
+ *      (1) This gives the same result as pixErodeBrick() for any
+ *          brick size.  See pixDilateBrickChainDwa().
+ */
+PIX *
+pixErodeBrickChainDwa(PIX     *pixs,
+                      l_int32  hsize,
+                      l_int32  vsize)
+{
+    PROCNAME("pixErodeBrickChainDwa");
+
+    if (!pixs)
+        return (PIX *)ERROR_PTR("pixs not defined", procName, NULL);
+    if (pixGetDepth(pixs) != 1)
+        return (PIX *)ERROR_PTR("pixs not 1 bpp", procName, NULL);
+    if (hsize < 1 || vsize < 1)
+        return (PIX *)ERROR_PTR("hsize and vsize not >= 1", procName, NULL);
+
+    return pixMorphBrickChainDwa(pixs, hsize, vsize, L_MORPH_ERODE);
+}
+
+
+/*!
+ *  pixOpenBrickChainDwa()
+ *
+ *      Input:  pixs (1 bpp)
+ *              hsize (width of brick Sel)
+ *              vsize (height of brick Sel)
+ *      Return: pixd, or null on error
+ *
+ *  Notes:
+ *      (1) This gives the same result as pixOpenBrick() for any
+ *          brick size.  See pixDilateBrickChainDwa().
+ */
+PIX *
+pixOpenBrickChainDwa(PIX     *pixs,
+                     l_int32  hsize,
+                     l_int32  vsize)
+{
+    PROCNAME("pixOpenBrickChainDwa");
+
+    if (!pixs)
+        return (PIX *)ERROR_PTR("pixs not defined", procName, NULL);
+    if (pixGetDepth(pixs) != 1)
+        return (PIX *)ERROR_PTR("pixs not 1 bpp", procName, NULL);
+    if (hsize < 1 || vsize < 1)
+        return (PIX *)ERROR_PTR("hsize and vsize not >= 1", procName, NULL);
+
+    return pixMorphBrickChainDwa(pixs, hsize, vsize, L_MORPH_OPEN);
+}
+
+
+/*!
+ *  pixCloseBrickChainDwa()
+ *
+ *      Input:  pixs (1 bpp)
+ *              hsize (width of brick Sel)
+ *              vsize (height of brick Sel)
+ *      Return: pixd, or null on error
+ *
+ *  Notes:
+ *      (1) This gives the same result as pixCloseBrick() for any
+ *          brick size.  See pixDilateBrickChainDwa().
+ */
+PIX *
+pixCloseBrickChainDwa(PIX     *pixs,
+                      l_int32  hsize,
+                      l_int32  vsize)
+{
+    PROCNAME("pixCloseBrickChainDwa");
+
+    if (!pixs)
+        return (PIX *)ERROR_PTR("pixs not defined", procName, NULL);
+    if (pixGetDepth(pixs) != 1)
+        return (PIX *)ERROR_PTR("pixs not 1 bpp", procName, NULL);
+    if (hsize < 1 || vsize < 1)
+        return (PIX *)ERROR_PTR("hsize and vsize not >= 1", procName, NULL);
+
+    return pixMorphBrickChainDwa(pixs, hsize, vsize, L_MORPH_CLOSE);
+}
+
+
+/*!
+ *  pixCloseSafeBrickChainDwa()
+ *
+ *      Input:  pixs (1 bpp)
+ *              hsize (width of brick Sel)
+ *              vsize (height of brick Sel)
+ *      Return: pixd, or null on error
+ *
+ *  Notes:
+ *      (1) This gives the same result as pixCloseSafeBrick() for any
+ *          brick size.  See pixDilateBrickChainDwa().
+ *      (2) As in pixCloseSafeBrick(), with asymmetric b.c. the image
+ *          is embedded in enough OFF pixels for the dilation, so that
+ *          the erosion does not remove pixels near the edges.
+ */
+PIX *
+pixCloseSafeBrickChainDwa(PIX     *pixs,
+                          l_int32  hsize,
+                          l_int32  vsize)
+{
+l_int32  maxtrans, bordsize;
+PIX     *pixsb, *pixdb, *pixd;
+
+    PROCNAME("pixCloseSafeBrickChainDwa");
+
+    if (!pixs)
+        return (PIX *)ERROR_PTR("pixs not defined", procName, NULL);
+    if (pixGetDepth(pixs) != 1)
+        return (PIX *)ERROR_PTR("pixs not 1 bpp", procName, NULL);
+    if (hsize < 1 || vsize < 1)
+        return (PIX *)ERROR_PTR("hsize and vsize not >= 1", procName, NULL);
+
+        /* Symmetric b.c. handles correctly without added pixels */
+    if (getMorphBorderPixelColor(L_MORPH_ERODE, 1) == 1)
+        return pixMorphBrickChainDwa(pixs, hsize, vsize, L_MORPH_CLOSE);
+
+    maxtrans = L_MAX(hsize / 2, vsize / 2);
+    bordsize = 32 * ((maxtrans + 31) / 32);  /* full 32 bit words */
+    if ((pixsb = pixAddBorder(pixs, bordsize, 0)) == NULL)
+        return (PIX *)ERROR_PTR("pixsb not made", procName, NULL);
+    pixdb = pixMorphBrickChainDwa(pixsb, hsize, vsize, L_MORPH_CLOSE);
+    pixDestroy(&pixsb);
+    if (!pixdb)
+        return (PIX *)ERROR_PTR("pixdb not made", procName, NULL);
+    pixd = pixRemoveBorder(pixdb, bordsize);
+    pixDestroy(&pixdb);
+    return pixd;
+}
+
+
+/*!
+ *  pixMorphBrickChainDwa()
+ *
+ *      Input:  pixs (1 bpp)
+ *              hsize, vsize (of brick Sel)
+ *              operation (L_MORPH_DILATE, L_MORPH_ERODE, L_MORPH_OPEN
+ *                         or L_MORPH_CLOSE)
+ *      Return: pixd, or null on error
+ */
+static PIX *
+pixMorphBrickChainDwa(PIX     *pixs,
+                      l_int32  hsize,
+                      l_int32  vsize,
+                      l_int32  operation)
+{
+l_int32  i, ret;
+l_int32  ops[2];
+PIX     *pixt1, *pixt2, *pixd;
+
+    PROCNAME("pixMorphBrickChainDwa");
+
+    if ((pixt1 = pixAddBorder(pixs, 32, 0)) == NULL)
+        return (PIX *)ERROR_PTR("pixt1 not made", procName, NULL);
+    if ((pixt2 = pixCreateTemplate(pixt1)) == NULL) {
+        pixDestroy(&pixt1);
+        return (PIX *)ERROR_PTR("pixt2 not made", procName, NULL);
+    }
+
+    if (operation == L_MORPH_OPEN) {
+        ops[0] = L_MORPH_ERODE;
+        ops[1] = L_MORPH_DILATE;
+    }
+    else if (operation == L_MORPH_CLOSE) {
+        ops[0] = L_MORPH_DILATE;
+        ops[1] = L_MORPH_ERODE;
+    }
+    else {
+        ops[0] = operation;
+        ops[1] = 0;
+    }
+
+    ret = 0;
+    for (i = 0; i < 2 && ops[i] != 0 && ret == 0; i++) {
+        ret = pixFMorphopChainGen_1(&pixt1, &pixt2, ops[i], hsize, L_HORIZ);
+        if (ret == 0)
+            ret = pixFMorphopChainGen_1(&pixt1, &pixt2, ops[i], vsize, L_VERT);
+    }
+
+    pixd = (ret == 0) ? pixRemoveBorder(pixt1, 32) : NULL;
+    pixDestroy(&pixt1);
+    pixDestroy(&pixt2);
+    if (!pixd)
+        return (PIX *)ERROR_PTR("pixd not made", procName, NULL);
+    return pixd;
+}
+
+
+/*!
+ *  pixFMorphopChainGen_1()
+ *
+ *      Input:  &pixt1 (1 bpp, with a border of 32 pixels; this holds
+ *                      the input, and is replaced by the result)
+ *              &pixt2 (1 bpp, same size; work image)
+ *              operation (L_MORPH_DILATE or L_MORPH_ERODE)
+ *              size (length of linear brick Sel)
+ *              direction (L_HORIZ or L_VERT)
+ *      Return: 0 if OK, 1 on error
+ */
+static l_int32
+pixFMorphopChainGen_1(PIX    **ppixt1,
+                      PIX    **ppixt2,
+                      l_int32  operation,
+                      l_int32  size,
+                      l_int32  direction)
+{
+char     selname[32];
+l_int32  i, nsizes, length, found;
+PIX     *pixt;
+
+    PROCNAME("pixFMorphopChainGen_1");
+
+    nsizes = sizeof(dwa_linear) / sizeof(l_int32);
+    while (size > 1) {
+        found = FALSE;
+        for (i = 0; i < nsizes; i++) {
+            if (dwa_linear[i] == size) {
+                found = TRUE;
+                break;
+            }
+        }
+        if (found) {
+            length = size;
+        }
+        else {  /* largest odd Sel that is shorter */
+            for (i = nsizes - 1; i >= 0; i--) {
+                if ((dwa_linear[i] & 1) && dwa_linear[i] < size)
+                    break;
+            }
+            length = dwa_linear[i];
+        }
+        snprintf(selname, sizeof(selname), "sel_%d%c", length,
+                 (direction == L_HORIZ) ? 'h' : 'v');
+        if (pixFMorphopGen_1(*ppixt2, *ppixt1, operation, selname) == NULL)
+            return ERROR_INT("dwa op failed", procName, 1);
+        pixt = *ppixt1;
+        *ppixt1 = *ppixt2;
+        *ppixt2 = pixt;
+        size -= length - 1;
+    }
+    return 0;
+}
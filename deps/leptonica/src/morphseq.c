@@ -434,7 +434,9 @@ SARRAY  *sa;
  *      (1) This does dwa morphology on binary images.
  *      (2) This runs a pipeline of operations; no branching is allowed.
  *      (3) This only uses brick Sels that have been pre-compiled with
- *          dwa code.
+ *          dwa code.  Other sizes are made with chains of them, so the
+ *          result is the same as that of pixMorphSequence() for any
+ *          brick size.
  *      (4) A new image is always produced; the input image is not changed.
  *      (5) This contains an interpreter, allowing sequences to be
  *          generated and run.
@@ -491,24 +493,26 @@ SARRAY  *sa;
         case 'd':
         case 'D':
             sscanf(&op[1], "%d.%d", &w, &h);
-            pixt2 = pixDilateBrickDwa(NULL, pixt1, w, h);
+            pixt2 = pixDilateBrickChainDwa(pixt1, w, h);
             pixSwapAndDestroy(&pixt1, &pixt2);
             break;
         case 'e':
         case 'E':
             sscanf(&op[1], "%d.%d", &w, &h);
-            pixt2 = pixErodeBrickDwa(NULL, pixt1, w, h);
+            pixt2 = pixErodeBrickChainDwa(pixt1, w, h);
             pixSwapAndDestroy(&pixt1, &pixt2);
             break;
         case 'o':
         case 'O':
             sscanf(&op[1], "%d.%d", &w, &h);
-            pixOpenBrickDwa(pixt1, pixt1, w, h);
+            pixt2 = pixOpenBrickChainDwa(pixt1, w, h);
+            pixSwapAndDestroy(&pixt1, &pixt2);
             break;
         case 'c':
         case 'C':
             sscanf(&op[1], "%d.%d", &w, &h);
-            pixCloseBrickDwa(pixt1, pixt1, w, h);
+            pixt2 = pixCloseSafeBrickChainDwa(pixt1, w, h);
+            pixSwapAndDestroy(&pixt1, &pixt2);
             break;
         case 'r':
         case 'R':
@@ -37,6 +37,7 @@
 #include "paramsd.h"
 #include "output.h"
 #include "globals.h"
+#include "helpers.h"
 #include "edgblob.h"
 #include "equationdetect.h"
 #include "tessbox.h"
@@ -76,6 +77,11 @@ const char kUNLVSuspect = '^';
 const char* kInputFile = "noname.tif";
 /** Temp file used for storing current parameters before applying retry values. */
 const char* kOldVarsFile = "failed_vars.txt";
+/**
+ * Text is scaled down to tessedit_target_xheight only by factors smaller than
+ * this, as smaller reductions do not pay for the resampling.
+ */
+const float kMaxScaleToDownscale = 0.8f;
 /** Max string length of an int.  */
 const int kMaxIntSize = 22;
 /**
@@ -96,6 +102,7 @@ TessBaseAPI::TessBaseAPI()
     thresholder_(NULL),
     paragraph_models_(NULL),
     block_list_(NULL),
+    blocks_(NULL),
     page_res_(NULL),
     input_file_(NULL),
     output_file_(NULL),
@@ -103,6 +110,7 @@ TessBaseAPI::TessBaseAPI()
     language_(NULL),
     last_oem_requested_(OEM_DEFAULT),
     recognition_done_(false),
+    adaptive_classifier_imported_(false),
     truth_cb_(NULL),
     rect_left_(0), rect_top_(0), rect_width_(0), rect_height_(0),
     image_width_(0), image_height_(0) {
@@ -214,6 +222,7 @@ int TessBaseAPI::Init(const char* datapath, const char* language,
       (datapath_ == NULL || language_ == NULL ||
        *datapath_ != datapath || last_oem_requested_ != oem ||
        (*language_ != language && tesseract_->lang != language))) {
+    DeleteLineWorkers();
     delete tesseract_;
     tesseract_ = NULL;
   }
@@ -242,6 +251,7 @@ int TessBaseAPI::Init(const char* datapath, const char* language,
 
   // For same language and datapath, just reset the adaptive classifier.
   if (reset_classifier) tesseract_->ResetAdaptiveClassifier();
+  adaptive_classifier_imported_ = false;
 
   return 0;
 }
@@ -367,6 +377,9 @@ void TessBaseAPI::ReadDebugConfigFile(const char* filename) {
 void TessBaseAPI::SetPageSegMode(PageSegMode mode) {
   if (tesseract_ == NULL)
     tesseract_ = new Tesseract;
+  // The layout found in another mode is no longer valid.
+  if (mode != static_cast<int>(tesseract_->tessedit_pageseg_mode))
+    ClearResults();
   tesseract_->tessedit_pageseg_mode.set_value(mode);
 }
 
@@ -418,6 +431,31 @@ void TessBaseAPI::ClearAdaptiveClassifier() {
     return;
   tesseract_->ResetAdaptiveClassifier();
   tesseract_->ResetDocumentDictionary();
+  adaptive_classifier_imported_ = false;
+}
+
+/**
+ * Write the adaptive classifier data to fp, so that this or another
+ * instance for the same languages can continue from it with
+ * ReadAdaptiveClassifier. Returns false on error.
+ */
+bool TessBaseAPI::WriteAdaptiveClassifier(FILE* fp) {
+  if (tesseract_ == NULL)
+    return false;
+  return tesseract_->WriteAdaptiveClassifier(fp);
+}
+
+/**
+ * Replace the adaptive classifier data with the data written to fp by
+ * WriteAdaptiveClassifier. Returns false, leaving the classifier alone,
+ * if there is none, it belongs to other languages, or it is truncated or
+ * damaged. fp must be seekable.
+ */
+bool TessBaseAPI::ReadAdaptiveClassifier(FILE* fp) {
+  if (tesseract_ == NULL || !tesseract_->ReadAdaptiveClassifier(fp))
+    return false;
+  adaptive_classifier_imported_ = true;
+  return true;
 }
 
 /**
@@ -471,6 +509,18 @@ void TessBaseAPI::SetRectangle(int left, int top, int width, int height) {
   ClearResults();
 }
 
+/**
+ * Use the given boxes, in image coordinates, as the text blocks of the page
+ * instead of running page layout analysis.
+ */
+void TessBaseAPI::SetBlocks(Boxa* blocks) {
+  if (blocks_ != NULL)
+    boxaDestroy(&blocks_);
+  if (blocks != NULL)
+    blocks_ = boxaCopy(blocks, L_COPY);
+  ClearResults();
+}
+
 /**
  * ONLY available if you have Leptonica installed.
  * Get a copy of the internal thresholded image from Tesseract.
@@ -590,7 +640,7 @@ Boxa* TessBaseAPI::GetComponentImages(PageIteratorLevel level,
   return boxa;
 }
 
-int TessBaseAPI::GetThresholdedImageScaleFactor() const {
+float TessBaseAPI::GetThresholdedImageScaleFactor() const {
   if (thresholder_ == NULL) {
     return 0;
   }
@@ -673,17 +723,21 @@ int CubeAPITest(Boxa* boxa_blocks, Pixa* pixa_blocks,
  * DetectOS, or anything else that changes the internal PAGE_RES.
  */
 PageIterator* TessBaseAPI::AnalyseLayout() {
-  if (FindLines() == 0) {
+  // Any results of the current image already hold its layout.
+  if (page_res_ == NULL) {
+    if (FindLines() != 0)
+      return NULL;
     if (block_list_->empty())
       return NULL;  // The page was empty.
     page_res_ = new PAGE_RES(block_list_, NULL);
     DetectParagraphs(false);
-    return new PageIterator(
-        page_res_, tesseract_, thresholder_->GetScaleFactor(),
-        thresholder_->GetScaledYResolution(),
-        rect_left_, rect_top_, rect_width_, rect_height_);
   }
-  return NULL;
+  if (block_list_->empty())
+    return NULL;
+  return new PageIterator(
+      page_res_, tesseract_, thresholder_->GetScaleFactor(),
+      thresholder_->GetScaledYResolution(),
+      rect_left_, rect_top_, rect_width_, rect_height_);
 }
 
 /**
@@ -741,7 +795,14 @@ int TessBaseAPI::Recognize(ETEXT_DESC* monitor) {
     fclose(training_output_file);
   } else {
     // Now run the main recognition.
-    if (tesseract_->recog_all_words(page_res_, monitor, NULL, NULL, 0)) {
+    // The progress monitor is not shared between threads and cube keeps a
+    // page image of its own, so those run on the calling thread only.
+    int num_threads = tesseract_->tessedit_parallel_threads;
+    bool recognized = num_threads > 1 && monitor == NULL &&
+        tesseract_->tessedit_ocr_engine_mode == OEM_TESSERACT_ONLY
+        ? RecognizeLinesInParallel(num_threads)
+        : tesseract_->recog_all_words(page_res_, monitor, NULL, NULL, 0);
+    if (recognized) {
       DetectParagraphs(true);
     } else {
       result = -1;
@@ -750,6 +811,206 @@ int TessBaseAPI::Recognize(ETEXT_DESC* monitor) {
   return result;
 }
 
+/** Work of one thread of RecognizeLinesInParallel. */
+struct LineRecognitionJob {
+  Tesseract* tesseract;
+  PAGE_RES* page_res;
+  bool result;
+};
+
+static void* RecognizeLinesThread(void* arg) {
+  LineRecognitionJob* job = static_cast<LineRecognitionJob*>(arg);
+  job->result = job->tesseract->recog_all_words(job->page_res, NULL, NULL,
+                                                NULL, 0);
+  return NULL;
+}
+
+/** Makes a BLOCK_RES for the same block as src, without any rows. */
+static BLOCK_RES* EmptyBlockResLike(const BLOCK_RES& src) {
+  BLOCK_RES* block_res = new BLOCK_RES;
+  block_res->block = src.block;
+  block_res->char_count = 0;
+  block_res->rej_count = 0;
+  block_res->font_class = src.font_class;
+  block_res->row_count = 0;
+  block_res->x_height = src.x_height;
+  block_res->font_assigned = src.font_assigned;
+  block_res->bold = src.bold;
+  block_res->italic = src.italic;
+  return block_res;
+}
+
+bool TessBaseAPI::RecognizeLinesInParallel(int num_threads) {
+  // Count the words on each line to balance the work between the threads.
+  GenericVector<int> line_words;
+  int total_words = 0;
+  BLOCK_RES_IT block_it(&page_res_->block_res_list);
+  for (block_it.mark_cycle_pt(); !block_it.cycled_list(); block_it.forward()) {
+    ROW_RES_IT row_it(&block_it.data()->row_res_list);
+    for (row_it.mark_cycle_pt(); !row_it.cycled_list(); row_it.forward()) {
+      line_words.push_back(row_it.data()->word_res_list.length());
+      total_words += line_words.back();
+    }
+  }
+  int num_lines = line_words.size();
+  if (num_threads > num_lines)
+    num_threads = num_lines;
+  if (num_threads < 2 || !PrepareLineWorkers(num_threads - 1))
+    return tesseract_->recog_all_words(page_res_, NULL, NULL, NULL, 0);
+
+  // Give each thread a contiguous run of lines with about the same number of
+  // words, and at least one line.
+  GenericVector<int> line_part;
+  int part = 0;
+  int words = 0;
+  for (int line = 0; line < num_lines; ++line) {
+    if (part + 1 < num_threads && line > 0 &&
+        (words * num_threads >= total_words * (part + 1) ||
+         num_lines - line == num_threads - part - 1)) {
+      ++part;
+    }
+    line_part.push_back(part);
+    words += line_words[line];
+  }
+
+  // Move the lines to the page of their thread, in partial copies of their
+  // blocks. The BLOCKs themselves stay in block_list_.
+  PAGE_RES* parts = new PAGE_RES[num_threads];
+  GenericVector<BLOCK_RES*> whole_blocks;
+  GenericVector<BLOCK_RES*> partial_blocks;
+  int line = 0;
+  for (block_it.mark_cycle_pt(); !block_it.cycled_list(); block_it.forward()) {
+    BLOCK_RES* block_res = block_it.data();
+    BLOCK_RES* partial = NULL;
+    int partial_part = -1;
+    ROW_RES_IT row_it(&block_res->row_res_list);
+    ROW_RES_IT partial_it;
+    for (row_it.mark_cycle_pt(); !row_it.cycled_list(); row_it.forward()) {
+      part = line_part[line++];
+      if (partial == NULL || partial_part != part) {
+        partial = EmptyBlockResLike(*block_res);
+        partial_part = part;
+        BLOCK_RES_IT part_it(&parts[part].block_res_list);
+        part_it.add_to_end(partial);
+        partial_it.set_to_list(&partial->row_res_list);
+        whole_blocks.push_back(block_res);
+        partial_blocks.push_back(partial);
+      }
+      partial_it.add_to_end(row_it.extract());
+      ++partial->row_count;
+    }
+  }
+
+  GenericVector<Tesseract*> engines;
+  engines.push_back(tesseract_);
+  for (int i = 0; i < line_workers_.size(); ++i)
+    engines.push_back(line_workers_[i]);
+  LineRecognitionJob* jobs = new LineRecognitionJob[num_threads];
+  CCUtilThread* threads = new CCUtilThread[num_threads];
+  for (int t = 0; t < num_threads; ++t) {
+    if (!adaptive_classifier_imported_)
+      engines[t]->ResetAdaptiveClassifier();
+    parts[t].prev_word_best_choice = &engines[t]->prev_word_best_choice_;
+    jobs[t].tesseract = engines[t];
+    jobs[t].page_res = &parts[t];
+    jobs[t].result = false;
+  }
+  for (int t = 1; t < num_threads; ++t)
+    threads[t].Start(RecognizeLinesThread, &jobs[t]);
+  RecognizeLinesThread(&jobs[0]);
+  bool result = jobs[0].result;
+  for (int t = 1; t < num_threads; ++t) {
+    threads[t].Join();
+    result = result && jobs[t].result;
+  }
+
+  // Put the lines back in reading order and sum up the statistics.
+  for (int i = 0; i < partial_blocks.size(); ++i) {
+    BLOCK_RES* block_res = whole_blocks[i];
+    BLOCK_RES* partial = partial_blocks[i];
+    ROW_RES_IT row_it(&block_res->row_res_list);
+    row_it.move_to_last();
+    row_it.add_list_after(&partial->row_res_list);
+    block_res->char_count += partial->char_count;
+    block_res->rej_count += partial->rej_count;
+  }
+  for (int t = 0; t < num_threads; ++t) {
+    page_res_->char_count += parts[t].char_count;
+    page_res_->rej_count += parts[t].rej_count;
+    if (parts[t].rejected)
+      page_res_->rejected = TRUE;
+    for (int i = 0; i < parts[t].blame_reasons.size(); ++i)
+      page_res_->blame_reasons[i] += parts[t].blame_reasons[i];
+    for (int i = 0; i < parts[t].misadaption_log.size(); ++i)
+      page_res_->misadaption_log.push_back(parts[t].misadaption_log[i]);
+  }
+  delete [] threads;
+  delete [] jobs;
+  delete [] parts;
+  return result;
+}
+
+bool TessBaseAPI::PrepareLineWorkers(int num_workers) {
+  if (line_workers_.size() < num_workers) {
+    // Init parameters can't be copied once the data is loaded.
+    GenericVector<STRING> init_names;
+    GenericVector<STRING> init_values;
+    ParamUtils::GetInitParams(*tesseract_->params(), &init_names,
+                              &init_values);
+    while (line_workers_.size() < num_workers) {
+      Tesseract* worker = new Tesseract;
+      if (worker->init_tesseract(
+              datapath_->string(),
+              output_file_ != NULL ? output_file_->string() : NULL,
+              language_->string(), last_oem_requested_, NULL, 0,
+              &init_names, &init_values, false) != 0) {
+        delete worker;
+        return false;
+      }
+      line_workers_.push_back(worker);
+    }
+  }
+  FILE* classifier_fp = NULL;
+  if (adaptive_classifier_imported_) {
+    classifier_fp = tmpfile();
+    if (classifier_fp == NULL)
+      return false;
+    if (!tesseract_->WriteAdaptiveClassifier(classifier_fp)) {
+      fclose(classifier_fp);
+      return false;
+    }
+  }
+  for (int i = 0; i < num_workers; ++i) {
+    Tesseract* worker = line_workers_[i];
+    if (classifier_fp != NULL) {
+      rewind(classifier_fp);
+      if (!worker->ReadAdaptiveClassifier(classifier_fp)) {
+        fclose(classifier_fp);
+        return false;
+      }
+    }
+    ParamUtils::CopyParams(*tesseract_->params(), worker->params());
+    worker->SetBlackAndWhitelist();
+    *worker->mutable_pix_binary() = pixClone(tesseract_->pix_binary());
+    if (tesseract_->pix_grey() != NULL)
+      worker->set_pix_grey(pixClone(tesseract_->pix_grey()));
+    worker->set_source_resolution(tesseract_->source_resolution());
+    for (int s = 0; s < worker->num_sub_langs(); ++s) {
+      *worker->get_sub_lang(s)->mutable_pix_binary() =
+          pixClone(tesseract_->pix_binary());
+    }
+  }
+  if (classifier_fp != NULL)
+    fclose(classifier_fp);
+  return true;
+}
+
+void TessBaseAPI::DeleteLineWorkers() {
+  for (int i = 0; i < line_workers_.size(); ++i)
+    delete line_workers_[i];
+  line_workers_.clear();
+}
+
 /** Tests the chopper by exhaustively running chop_one_blob. */
 int TessBaseAPI::RecognizeForChopTest(ETEXT_DESC* monitor) {
   if (tesseract_ == NULL)
@@ -1515,11 +1776,14 @@ void TessBaseAPI::End() {
     delete block_list_;
     block_list_ = NULL;
   }
+  if (blocks_ != NULL)
+    boxaDestroy(&blocks_);
   if (paragraph_models_ != NULL) {
     paragraph_models_->delete_data_pointers();
     delete paragraph_models_;
     paragraph_models_ = NULL;
   }
+  DeleteLineWorkers();
   if (tesseract_ != NULL) {
     delete tesseract_;
     if (osd_tesseract_ == tesseract_)
@@ -1635,11 +1899,10 @@ bool TessBaseAPI::InternalSetImage() {
  */
 void TessBaseAPI::Threshold(Pix** pix) {
   ASSERT_HOST(pix != NULL);
-  if (!thresholder_->IsBinary()) {
-    tesseract_->set_pix_grey(thresholder_->GetPixRectGrey());
-  }
   if (*pix != NULL)
     pixDestroy(pix);
+  // Start from the source image, not the scale of the previous page.
+  thresholder_->SetScaleFactor(1.0f);
   // Zero resolution messes up the algorithms, so make sure it is credible.
   int y_res = thresholder_->GetScaledYResolution();
   if (y_res < kMinCredibleResolution || y_res > kMaxCredibleResolution) {
@@ -1648,6 +1911,22 @@ void TessBaseAPI::Threshold(Pix** pix) {
     thresholder_->SetSourceYResolution(kMinCredibleResolution);
   }
   thresholder_->ThresholdToPix(pix);
+  int target_x_height = tesseract_->tessedit_target_xheight;
+  if (target_x_height > 0) {
+    // Text larger than needed only makes layout analysis and classification
+    // slower, so scale it down to the target size and threshold again.
+    int x_height = ImageThresholder::EstimateXHeight(*pix);
+    if (x_height > 0 &&
+        target_x_height < x_height * kMaxScaleToDownscale) {
+      thresholder_->SetScaleFactor(static_cast<float>(target_x_height) /
+                                   x_height);
+      pixDestroy(pix);
+      thresholder_->ThresholdToPix(pix);
+    }
+  }
+  if (!thresholder_->IsBinary()) {
+    tesseract_->set_pix_grey(thresholder_->GetPixRectGrey());
+  }
   thresholder_->GetImageSizes(&rect_left_, &rect_top_,
                               &rect_width_, &rect_height_,
                               &image_width_, &image_height_);
@@ -1691,6 +1970,13 @@ int TessBaseAPI::FindLines() {
 
   tesseract_->PrepareForPageseg();
 
+  if (blocks_ != NULL) {
+    // SegmentPage uses the blocks already in the list like a UNLV zone file.
+    AddGivenBlocks();
+    if (block_list_->empty())
+      return 0;  // No block overlaps the rectangle.
+  }
+
   if (tesseract_->textord_equation_detect) {
     if (equ_detect_ == NULL && datapath_ != NULL) {
       equ_detect_ = new EquationDetect(datapath_->string(), NULL);
@@ -1700,25 +1986,8 @@ int TessBaseAPI::FindLines() {
 
   Tesseract* osd_tess = osd_tesseract_;
   OSResults osr;
-  if (PSM_OSD_ENABLED(tesseract_->tessedit_pageseg_mode) && osd_tess == NULL) {
-    if (strcmp(language_->string(), "osd") == 0) {
-      osd_tess = tesseract_;
-    } else {
-      osd_tesseract_ = new Tesseract;
-      if (osd_tesseract_->init_tesseract(
-          datapath_->string(), NULL, "osd", OEM_TESSERACT_ONLY,
-          NULL, 0, NULL, NULL, false) == 0) {
-        osd_tess = osd_tesseract_;
-        osd_tesseract_->set_source_resolution(
-            thresholder_->GetSourceYResolution());
-      } else {
-        tprintf("Warning: Auto orientation and script detection requested,"
-                " but osd language failed to load\n");
-        delete osd_tesseract_;
-        osd_tesseract_ = NULL;
-      }
-    }
-  }
+  if (PSM_OSD_ENABLED(tesseract_->tessedit_pageseg_mode) && osd_tess == NULL)
+    osd_tess = OsdTesseract();
 
   if (tesseract_->SegmentPage(input_file_, block_list_, osd_tess, &osr) < 0)
     return -1;
@@ -1728,6 +1997,33 @@ int TessBaseAPI::FindLines() {
   return 0;
 }
 
+/**
+ * Add the blocks given by SetBlocks to block_list_, converted to the
+ * bottom-up coordinates of the thresholded rectangle and clipped to it.
+ */
+void TessBaseAPI::AddGivenBlocks() {
+  Pix* pix_binary = tesseract_->pix_binary();
+  int width = pixGetWidth(pix_binary);
+  int height = pixGetHeight(pix_binary);
+  float scale = thresholder_->GetScaleFactor();
+  BLOCK_IT block_it(block_list_);
+  for (int i = 0; i < boxaGetCount(blocks_); ++i) {
+    l_int32 x, y, w, h;
+    if (boxaGetBoxGeometry(blocks_, i, &x, &y, &w, &h) != 0)
+      continue;
+    int left = MAX(IntCastRounded((x - rect_left_) * scale), 0);
+    int top = MAX(IntCastRounded((y - rect_top_) * scale), 0);
+    int right = MIN(IntCastRounded((x + w - rect_left_) * scale), width);
+    int bottom = MIN(IntCastRounded((y + h - rect_top_) * scale), height);
+    if (left >= right || top >= bottom)
+      continue;
+    BLOCK* block = new BLOCK("", TRUE, 0, 0, left, height - bottom,
+                             right, height - top);
+    block->set_right_to_left(tesseract_->right_to_left());
+    block_it.add_to_end(block);
+  }
+}
+
 /** Delete the pageres and clear the block list ready for a new page. */
 void TessBaseAPI::ClearResults() {
   if (tesseract_ != NULL) {
@@ -1794,7 +2090,55 @@ bool TessBaseAPI::DetectOS(OSResults* osr) {
     Threshold(tesseract_->mutable_pix_binary());
   if (input_file_ == NULL)
     input_file_ = new STRING(kInputFile);
-  return orientation_and_script_detection(*input_file_, osr, tesseract_);
+  return orientation_and_script_detection(*input_file_, osr, tesseract_,
+                                          tesseract_, kMaxCharactersToTry);
+}
+
+bool TessBaseAPI::DetectOS(OSResults* osr, int max_blobs) {
+  if (tesseract_ == NULL || thresholder_ == NULL || thresholder_->IsEmpty())
+    return false;
+  ClearResults();
+  Tesseract* osd_tess = OsdTesseract();
+  if (osd_tess == NULL)
+    osd_tess = tesseract_;
+  // Detection switches the classifier to character normalized matching.
+  bool cn_matching = osd_tess->tess_cn_matching;
+  bool bn_matching = osd_tess->tess_bn_matching;
+  Threshold(tesseract_->mutable_pix_binary());
+  if (input_file_ == NULL)
+    input_file_ = new STRING(kInputFile);
+  int num_blobs = orientation_and_script_detection(*input_file_, osr,
+                                                   tesseract_, osd_tess,
+                                                   max_blobs);
+  osd_tess->tess_cn_matching.set_value(cn_matching);
+  osd_tess->tess_bn_matching.set_value(bn_matching);
+  // Lines and images were erased from the binary image to find the blobs.
+  ClearResults();
+  return num_blobs > 0;
+}
+
+/**
+ * Return the engine for orientation and script detection, which is loaded
+ * with the osd language when first needed, or NULL if that fails.
+ */
+Tesseract* TessBaseAPI::OsdTesseract() {
+  if (osd_tesseract_ != NULL)
+    return osd_tesseract_;
+  if (strcmp(language_->string(), "osd") == 0)
+    return tesseract_;
+  osd_tesseract_ = new Tesseract;
+  if (osd_tesseract_->init_tesseract(
+      datapath_->string(), NULL, "osd", OEM_TESSERACT_ONLY,
+      NULL, 0, NULL, NULL, false) == 0) {
+    osd_tesseract_->set_source_resolution(
+        thresholder_->GetSourceYResolution());
+    return osd_tesseract_;
+  }
+  tprintf("Warning: Auto orientation and script detection requested,"
+          " but osd language failed to load\n");
+  delete osd_tesseract_;
+  osd_tesseract_ = NULL;
+  return NULL;
 }
 
 void TessBaseAPI::set_min_orientation_margin(double margin) {
@@ -292,6 +292,21 @@ class TESS_API TessBaseAPI {
    */
   void ClearAdaptiveClassifier();
 
+  /**
+   * Write the adaptive classifier data to fp, so that this or another
+   * instance for the same languages can continue from it with
+   * ReadAdaptiveClassifier. Returns false on error.
+   */
+  bool WriteAdaptiveClassifier(FILE* fp);
+
+  /**
+   * Replace the adaptive classifier data with the data written to fp by
+   * WriteAdaptiveClassifier. Returns false, leaving the classifier alone,
+   * if there is none, it belongs to other languages, or it is truncated or
+   * damaged. fp must be seekable.
+   */
+  bool ReadAdaptiveClassifier(FILE* fp);
+
   /**
    * @defgroup AdvancedAPI Advanced API
    * The following methods break TesseractRect into pieces, so you can
@@ -337,6 +352,23 @@ class TESS_API TessBaseAPI {
    */
   void SetRectangle(int left, int top, int width, int height);
 
+  /**
+   * Use the given boxes, in image coordinates, as the text blocks of the
+   * page instead of running page layout analysis, like a UNLV zone file.
+   * Lines and words are still found within each block. The boxes are copied
+   * and clipped to the rectangle, and kept for the following images until
+   * SetBlocks(NULL) restores automatic page segmentation.
+   * Clears the recognition results.
+   */
+  void SetBlocks(Boxa* blocks);
+
+  /**
+   * Delete the page layout and recognition results of the current image, so
+   * that the next AnalyseLayout or Recognize starts over, e.g. after
+   * changing variables that affect them.
+   */
+  void ClearResults();
+
   /**
    * In extreme cases only, usually with a subclass of Thresholder, it
    * is possible to provide a different Thresholder. The Thresholder may
@@ -419,7 +451,7 @@ class TESS_API TessBaseAPI {
    * GetComponentImages().
    * Returns 0 if no thresholder has been set.
    */
-  int GetThresholdedImageScaleFactor() const;
+  float GetThresholdedImageScaleFactor() const;
 
   /**
    * Dump the internal binary image to a PGM file.
@@ -432,6 +464,9 @@ class TESS_API TessBaseAPI {
    * Runs page layout analysis in the mode set by SetPageSegMode.
    * May optionally be called prior to Recognize to get access to just
    * the page layout results. Returns an iterator to the results.
+   * The layout is kept until the image, rectangle, blocks or page
+   * segmentation mode change, so calling it again or after Recognize does
+   * not analyse the page again, and Recognize reuses it.
    * Returns NULL on error.
    * The returned iterator must be deleted after use.
    * WARNING! This class points to data held within the TessBaseAPI class, and
@@ -449,6 +484,14 @@ class TESS_API TessBaseAPI {
    */
   int Recognize(ETEXT_DESC* monitor);
 
+  /**
+   * Returns true if the current results come from Recognize, so they can be
+   * read without recognizing the image again.
+   */
+  bool IsRecognized() const {
+    return recognition_done_;
+  }
+
   /**
    * Methods to retrieve information after SetAndThresholdImage(),
    * Recognize() or TesseractRect(). (Recognize is called implicitly if needed.)
@@ -603,6 +646,14 @@ class TESS_API TessBaseAPI {
    */
   bool DetectOS(OSResults*);
 
+  /**
+   * Like DetectOS, but classifies at most max_blobs of the blobs on the page
+   * instead of 250. Fewer blobs are faster but give a less certain estimate.
+   * The blobs are classified with the osd language if it can be loaded, and
+   * the recognition results of the image are cleared.
+   */
+  bool DetectOS(OSResults* osr, int max_blobs);
+
   /** This method returns the features associated with the input image. */
   void GetFeaturesForBlob(TBLOB* blob, const DENORM& denorm,
                           INT_FEATURE_ARRAY int_features,
@@ -699,8 +750,14 @@ class TESS_API TessBaseAPI {
    */
   TESS_LOCAL int FindLines();
 
-  /** Delete the pageres and block list ready for a new page. */
-  TESS_LOCAL void ClearResults();
+  /** Add the blocks given by SetBlocks to the BLOCK_LIST. */
+  TESS_LOCAL void AddGivenBlocks();
+
+  /**
+   * Return the engine for orientation and script detection, which is loaded
+   * with the osd language when first needed, or NULL if that fails.
+   */
+  TESS_LOCAL Tesseract* OsdTesseract();
 
   /**
    * Return an LTR Result Iterator -- used only for training, as we really want
@@ -735,6 +792,28 @@ class TESS_API TessBaseAPI {
   TESS_LOCAL PAGE_RES* RecognitionPass1(BLOCK_LIST* block_list);
   TESS_LOCAL PAGE_RES* RecognitionPass2(BLOCK_LIST* block_list, PAGE_RES* pass1_result);
 
+  /**
+   * Runs the main recognition passes on page_res_ with num_threads engines,
+   * each recognizing a contiguous run of text lines on its own thread.
+   * The lines are put back in reading order afterwards. Each engine starts
+   * the page with an empty adaptive classifier, so the result only depends
+   * on the page and num_threads. If the classifier was imported with
+   * ReadAdaptiveClassifier, each engine starts from the one of tesseract_
+   * instead. Returns false if recognition failed.
+   */
+  TESS_LOCAL bool RecognizeLinesInParallel(int num_threads);
+  /**
+   * Makes num_workers engines like tesseract_ available in line_workers_
+   * and copies the current parameters and page images to them, and the
+   * adaptive classifier if it was imported. The engines are loaded with the
+   * init parameters of tesseract_ and kept for later pages. They share the
+   * dawgs with tesseract_, but load their own classifier templates.
+   * Returns false if an engine could not be initialized.
+   */
+  TESS_LOCAL bool PrepareLineWorkers(int num_workers);
+  /** Deletes the engines made by PrepareLineWorkers. */
+  TESS_LOCAL void DeleteLineWorkers();
+
   //// paragraphs.cpp ////////////////////////////////////////////////////
   TESS_LOCAL void DetectParagraphs(bool after_text_recognition);
 
@@ -759,10 +838,12 @@ class TESS_API TessBaseAPI {
  protected:
   Tesseract*        tesseract_;       ///< The underlying data object.
   Tesseract*        osd_tesseract_;   ///< For orientation & script detection.
+  GenericVector<Tesseract*> line_workers_;  ///< For parallel recognition.
   EquationDetect*   equ_detect_;      ///<The equation detector.
   ImageThresholder* thresholder_;     ///< Image thresholding module.
   GenericVector<ParagraphModel *>* paragraph_models_;
   BLOCK_LIST*       block_list_;      ///< The page layout.
+  Boxa*             blocks_;          ///< Blocks given by SetBlocks.
   PAGE_RES*         page_res_;        ///< The page-level data.
   STRING*           input_file_;      ///< Name used by training code.
   STRING*           output_file_;     ///< Name used by debug code.
@@ -770,6 +851,8 @@ class TESS_API TessBaseAPI {
   STRING*           language_;        ///< Last initialized language.
   OcrEngineMode last_oem_requested_;  ///< Last ocr language mode requested.
   bool          recognition_done_;   ///< page_res_ contains recognition data.
+  /** The adaptive classifier was set by ReadAdaptiveClassifier. */
+  bool          adaptive_classifier_imported_;
   TruthCallback *truth_cb_;           /// fxn for setting truth_* in WERD_RES
 
   /**
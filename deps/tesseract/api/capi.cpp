@@ -257,7 +257,7 @@ TESS_API struct Boxa* TESS_CALL TessBaseAPIGetComponentImages(TessBaseAPI* handl
     return handle->GetComponentImages(level, text_only != FALSE, pixa, blockids);
 }
 
-TESS_API int TESS_CALL TessBaseAPIGetThresholdedImageScaleFactor(const TessBaseAPI* handle)
+TESS_API float TESS_CALL TessBaseAPIGetThresholdedImageScaleFactor(const TessBaseAPI* handle)
 {
     return handle->GetThresholdedImageScaleFactor();
 }
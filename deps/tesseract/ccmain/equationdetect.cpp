@@ -136,6 +136,16 @@ EquationDetect::~EquationDetect() {
 
 void EquationDetect::SetLangTesseract(Tesseract* lang_tesseract) {
   lang_tesseract_ = lang_tesseract;
+
+  // Exclude some special texts that are likely to be confused as math symbol.
+  static const char* kCharsToEx[] = {"'", "`", "\"", "\\", ",", ".",
+      "〈", "〉", "《", "》", "」", "「", NULL};
+  ids_to_exclude_.clear();
+  for (int i = 0; kCharsToEx[i] != NULL; ++i) {
+    ids_to_exclude_.push_back(
+        lang_tesseract_->unicharset.unichar_to_id(kCharsToEx[i]));
+  }
+  ids_to_exclude_.sort();
 }
 
 void EquationDetect::SetResolution(const int resolution) {
@@ -244,19 +254,7 @@ BlobSpecialTextType EquationDetect::EstimateTypeForUnichar(
   }
 
   if (unicharset.get_ispunctuation(id)) {
-    // Exclude some special texts that are likely to be confused as math symbol.
-    static GenericVector<UNICHAR_ID> ids_to_exclude;
-    if (ids_to_exclude.empty()) {
-      static const STRING kCharsToEx[] = {"'", "`", "\"", "\\", ",", ".",
-          "〈", "〉", "《", "》", "」", "「", ""};
-      int i = 0;
-      while (kCharsToEx[i] != "") {
-        ids_to_exclude.push_back(
-            unicharset.unichar_to_id(kCharsToEx[i++].string()));
-      }
-      ids_to_exclude.sort();
-    }
-    return ids_to_exclude.bool_binary_search(id) ? BSTT_NONE : BSTT_MATH;
+    return ids_to_exclude_.bool_binary_search(id) ? BSTT_NONE : BSTT_MATH;
   }
 
   // Check if it is digit. In addition to the isdigit attribute, we also check
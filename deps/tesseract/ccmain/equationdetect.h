@@ -265,6 +265,10 @@ class EquationDetect : public EquationDetectBase {
   // The seed ColPartition for equation region.
   GenericVector<ColPartition*> cp_seeds_;
 
+  // The sorted ids of the lang_tesseract_ punctuation that is never labelled
+  // as math, see EstimateTypeForUnichar.
+  GenericVector<UNICHAR_ID> ids_to_exclude_;
+
   // The resolution (dpi) of the processing image.
   int resolution_;
 
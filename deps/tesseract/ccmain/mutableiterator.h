@@ -45,7 +45,7 @@ class MutableIterator : public ResultIterator {
  public:
   // See argument descriptions in ResultIterator()
   MutableIterator(PAGE_RES* page_res, Tesseract* tesseract,
-                  int scale, int scaled_yres,
+                  float scale, int scaled_yres,
                   int rect_left, int rect_top,
                   int rect_width, int rect_height)
       : ResultIterator(
@@ -33,9 +33,6 @@
 #include "tesseractclass.h"
 #include "textord.h"
 
-const int kMinCharactersToTry = 50;
-const int kMaxCharactersToTry = 5 * kMinCharactersToTry;
-
 const float kSizeRatioToReject = 2.0;
 const int kMinAcceptableBlobHeight = 10;
 
@@ -184,11 +181,14 @@ void remove_nontext_regions(tesseract::Tesseract *tess, BLOCK_LIST *blocks,
 }
 
 // Find connected components in the page and process a subset until finished or
-// a stopping criterion is met.
+// a stopping criterion is met. The components are found in the image of tess
+// and classified by osd_tess, which may be the same.
 // Returns the number of blobs used in making the estimate. 0 implies failure.
 int orientation_and_script_detection(STRING& filename,
                                      OSResults* osr,
-                                     tesseract::Tesseract* tess) {
+                                     tesseract::Tesseract* tess,
+                                     tesseract::Tesseract* osd_tess,
+                                     int max_blobs) {
   STRING name = filename;        //truncated name
   const char *lastdot;           //of name
   TBOX page_box;
@@ -227,14 +227,14 @@ int orientation_and_script_detection(STRING& filename,
                                           &port_blocks, true);
   }
 
-  return os_detect(&port_blocks, osr, tess);
+  return os_detect(&port_blocks, osr, osd_tess, max_blobs);
 }
 
 // Filter and sample the blobs.
 // Returns a non-zero number of blobs if the page was successfully processed, or
 // zero if the page had too few characters to be reliable
 int os_detect(TO_BLOCK_LIST* port_blocks, OSResults* osr,
-              tesseract::Tesseract* tess) {
+              tesseract::Tesseract* tess, int max_blobs) {
   int blobs_total = 0;
   TO_BLOCK_IT block_it;
   block_it.set_to_list(port_blocks);
@@ -266,14 +266,14 @@ int os_detect(TO_BLOCK_LIST* port_blocks, OSResults* osr,
       filtered_it.add_to_end(bbox);
     }
   }
-  return os_detect_blobs(&filtered_list, osr, tess);
+  return os_detect_blobs(&filtered_list, osr, tess, max_blobs);
 }
 
 // Detect orientation and script from a list of blobs.
 // Returns a non-zero number of blobs if the list was successfully processed, or
 // zero if the list had too few characters to be reliable
 int os_detect_blobs(BLOBNBOX_CLIST* blob_list, OSResults* osr,
-                    tesseract::Tesseract* tess) {
+                    tesseract::Tesseract* tess, int max_blobs) {
   OSResults osr_;
   if (osr == NULL)
     osr = &osr_;
@@ -283,13 +283,13 @@ int os_detect_blobs(BLOBNBOX_CLIST* blob_list, OSResults* osr,
   ScriptDetector s(osr, tess);
 
   BLOBNBOX_C_IT filtered_it(blob_list);
-  int real_max = MIN(filtered_it.length(), kMaxCharactersToTry);
+  int real_max = MIN(filtered_it.length(), max_blobs);
   // tprintf("Total blobs found = %d\n", blobs_total);
   // tprintf("Number of blobs post-filtering = %d\n", filtered_it.length());
   // tprintf("Number of blobs to try = %d\n", real_max);
 
   // If there are too few characters, skip this page entirely.
-  if (real_max < kMinCharactersToTry / 2) {
+  if (filtered_it.length() < kMinCharactersToTry / 2 || real_max <= 0) {
     tprintf("Too few characters. Skipping this page\n");
     return 0;
   }
@@ -35,6 +35,11 @@ class Tesseract;
 // Max number of scripts in ICU + "NULL" + Japanese and Korean + Fraktur
 const int kMaxNumberOfScripts = 116 + 1 + 2 + 1;
 
+// Detection stops early once it is certain after this many blobs, and by
+// default tries no more than kMaxCharactersToTry of them.
+const int kMinCharactersToTry = 50;
+const int kMaxCharactersToTry = 5 * kMinCharactersToTry;
+
 struct OSBestResult {
   OSBestResult() : orientation_id(0), script_id(0), sconfidence(0.0),
                    oconfidence(0.0) {}
@@ -112,15 +117,19 @@ class ScriptDetector {
 
 int orientation_and_script_detection(STRING& filename,
                                      OSResults*,
-                                     tesseract::Tesseract*);
+                                     tesseract::Tesseract* tess,
+                                     tesseract::Tesseract* osd_tess,
+                                     int max_blobs);
 
 int os_detect(TO_BLOCK_LIST* port_blocks,
               OSResults* osr,
-              tesseract::Tesseract* tess);
+              tesseract::Tesseract* tess,
+              int max_blobs = kMaxCharactersToTry);
 
 int os_detect_blobs(BLOBNBOX_CLIST* blob_list,
                     OSResults* osr,
-                    tesseract::Tesseract* tess);
+                    tesseract::Tesseract* tess,
+                    int max_blobs = kMaxCharactersToTry);
 
 bool os_detect_blob(BLOBNBOX* bbox, OrientationDetector* o,
                     ScriptDetector* s, OSResults*,
@@ -19,6 +19,7 @@
 ///////////////////////////////////////////////////////////////////////
 
 #include "pageiterator.h"
+#include <math.h>
 #include "allheaders.h"
 #include "helpers.h"
 #include "pageres.h"
@@ -27,7 +28,7 @@
 namespace tesseract {
 
 PageIterator::PageIterator(PAGE_RES* page_res, Tesseract* tesseract,
-                           int scale, int scaled_yres,
+                           float scale, int scaled_yres,
                            int rect_left, int rect_top,
                            int rect_width, int rect_height)
   : page_res_(page_res), tesseract_(tesseract),
@@ -306,13 +307,13 @@ bool PageIterator::BoundingBox(PageIteratorLevel level,
   if (!BoundingBoxInternal(level, left, top, right, bottom))
     return false;
   // Convert to the coordinate system of the original image.
-  *left = ClipToRange(*left / scale_ + rect_left_,
+  *left = ClipToRange(static_cast<int>(floor(*left / scale_)) + rect_left_,
                       rect_left_, rect_left_ + rect_width_);
-  *top = ClipToRange(*top / scale_ + rect_top_,
+  *top = ClipToRange(static_cast<int>(floor(*top / scale_)) + rect_top_,
                      rect_top_, rect_top_ + rect_height_);
-  *right = ClipToRange((*right + scale_ - 1) / scale_ + rect_left_,
+  *right = ClipToRange(static_cast<int>(ceil(*right / scale_)) + rect_left_,
                        *left, rect_left_ + rect_width_);
-  *bottom = ClipToRange((*bottom + scale_ - 1) / scale_ + rect_top_,
+  *bottom = ClipToRange(static_cast<int>(ceil(*bottom / scale_)) + rect_top_,
                         *top, rect_top_ + rect_height_);
   return true;
 }
@@ -460,10 +461,11 @@ bool PageIterator::Baseline(PageIteratorLevel level,
   // Rotate to image coordinates and convert to global image coords.
   startpt.rotate(it_->block()->block->re_rotation());
   endpt.rotate(it_->block()->block->re_rotation());
-  *x1 = startpt.x() / scale_ + rect_left_;
-  *y1 = (rect_height_ - startpt.y()) / scale_ + rect_top_;
-  *x2 = endpt.x() / scale_ + rect_left_;
-  *y2 = (rect_height_ - endpt.y()) / scale_ + rect_top_;
+  const int pix_height = pixGetHeight(tesseract_->pix_binary());
+  *x1 = IntCastRounded(startpt.x() / scale_) + rect_left_;
+  *y1 = IntCastRounded((pix_height - startpt.y()) / scale_) + rect_top_;
+  *x2 = IntCastRounded(endpt.x() / scale_) + rect_left_;
+  *y2 = IntCastRounded((pix_height - endpt.y()) / scale_) + rect_top_;
   return true;
 }
 
@@ -65,7 +65,7 @@ class TESS_API PageIterator {
    * After the constructor, Begin has already been called.
    */
   PageIterator(PAGE_RES* page_res, Tesseract* tesseract,
-               int scale, int scaled_yres,
+               float scale, int scaled_yres,
                int rect_left, int rect_top,
                int rect_width, int rect_height);
   virtual ~PageIterator();
@@ -314,7 +314,7 @@ class TESS_API PageIterator {
    */
   C_BLOB_IT* cblob_it_;
   /** Parameters saved from the Thresholder. Needed to rebuild coordinates.*/
-  int scale_;
+  float scale_;
   int scaled_yres_;
   int rect_left_;
   int rect_top_;
@@ -129,7 +129,7 @@ int Tesseract::SegmentPage(const STRING* input_file, BLOCK_LIST* blocks,
     block->set_right_to_left(right_to_left());
     block_it.add_to_end(block);
   } else {
-    // UNLV file present. Use PSM_SINGLE_BLOCK.
+    // Blocks given by the API or a UNLV file. Use PSM_SINGLE_BLOCK.
     pageseg_mode = PSM_SINGLE_BLOCK;
   }
   int auto_page_seg_ret_val = 0;
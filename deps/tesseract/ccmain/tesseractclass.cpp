@@ -61,6 +61,14 @@ Tesseract::Tesseract()
                     " (no Cube,no combiner)."
                     " Values from OcrEngineMode enum in tesseractclass.h)",
                this->params()),
+    INT_MEMBER(tessedit_parallel_threads, 0,
+               "Number of threads recognizing the text lines of a page,"
+               " 0 or 1 to recognize on the calling thread only",
+               this->params()),
+    INT_MEMBER(tessedit_target_xheight, 0,
+               "If > 0, scale images down before thresholding so that the"
+               " estimated x-height of their text becomes this many pixels",
+               this->params()),
     STRING_MEMBER(tessedit_char_blacklist, "",
                   "Blacklist of chars not to recognize", this->params()),
     STRING_MEMBER(tessedit_char_whitelist, "",
@@ -437,6 +445,39 @@ void Tesseract::ResetAdaptiveClassifier() {
   }
 }
 
+// Write the adapted templates of this and all subclassifiers to fp.
+// Returns false on error.
+bool Tesseract::WriteAdaptiveClassifier(FILE* fp) {
+  if (!Classify::WriteAdaptiveClassifier(fp))
+    return false;
+  for (int i = 0; i < sub_langs_.size(); ++i) {
+    if (!sub_langs_[i]->Classify::WriteAdaptiveClassifier(fp))
+      return false;
+  }
+  return true;
+}
+
+// Replace the adapted templates of this and all subclassifiers with the
+// ones written to fp by WriteAdaptiveClassifier of an instance for the
+// same languages. Returns false, changing nothing, if fp holds templates
+// for other languages or they are truncated or damaged. fp must be
+// seekable, as the templates of every language are checked before any of
+// them are used.
+bool Tesseract::ReadAdaptiveClassifier(FILE* fp) {
+  GenericVector<long> positions;
+  positions.push_back(CheckAdaptiveClassifier(fp));
+  for (int i = 0; i < sub_langs_.size() && positions.back() >= 0; ++i)
+    positions.push_back(sub_langs_[i]->CheckAdaptiveClassifier(fp));
+  if (positions.back() < 0)
+    return false;
+  long end = ftell(fp);
+  LoadAdaptiveClassifier(fp, positions[0]);
+  for (int i = 0; i < sub_langs_.size(); ++i)
+    sub_langs_[i]->LoadAdaptiveClassifier(fp, positions[i + 1]);
+  fseek(fp, end, SEEK_SET);
+  return true;
+}
+
 // Clear the document dictionary for this and all subclassifiers.
 void Tesseract::ResetDocumentDictionary() {
   getDict().ResetDocumentDictionary();
@@ -146,6 +146,15 @@ class Tesseract : public Wordrec {
   void Clear();
   // Clear all memory of adaption for this and all subclassifiers.
   void ResetAdaptiveClassifier();
+  // Write the adapted templates of this and all subclassifiers to fp.
+  // Returns false on error.
+  bool WriteAdaptiveClassifier(FILE* fp);
+  // Replace the adapted templates of this and all subclassifiers with the
+  // ones written to fp by WriteAdaptiveClassifier of an instance for the
+  // same languages. Returns false, changing nothing, if fp holds templates
+  // for other languages or they are truncated or damaged. fp must be
+  // seekable.
+  bool ReadAdaptiveClassifier(FILE* fp);
   // Clear the document dictionary for this and all subclassifiers.
   void ResetDocumentDictionary();
 
@@ -668,6 +677,12 @@ class Tesseract : public Wordrec {
             "Which OCR engine(s) to run (Tesseract, Cube, both). Defaults"
             " to loading and running only Tesseract (no Cube, no combiner)."
             " (Values from OcrEngineMode enum in tesseractclass.h)");
+  INT_VAR_H(tessedit_parallel_threads, 0,
+            "Number of threads recognizing the text lines of a page,"
+            " 0 or 1 to recognize on the calling thread only");
+  INT_VAR_H(tessedit_target_xheight, 0,
+            "If > 0, scale images down before thresholding so that the"
+            " estimated x-height of their text becomes this many pixels");
   STRING_VAR_H(tessedit_char_blacklist, "",
                "Blacklist of chars not to recognize");
   STRING_VAR_H(tessedit_char_whitelist, "",
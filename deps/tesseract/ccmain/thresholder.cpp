@@ -22,15 +22,112 @@
 #include "thresholder.h"
 
 #include <string.h>
+#include <algorithm>
 
 #include "img.h"
+#include "ndminx.h"
 #include "otsuthr.h"
 
+// Single-channel rows are compared with the threshold 16 bytes at a time with
+// SSE2 when packing them to 1 bpp.
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 namespace tesseract {
 
+// Connected components smaller than this are not letters.
+const int kMinLetterHeight = 4;
+// Connected components wider than this times their height are not letters.
+const int kMaxLetterAspect = 3;
+// Fewer letters than this give no reliable x-height.
+const int kMinLettersForXHeight = 20;
+// Area mapping is only suitable for scaling down by more than this.
+const float kMaxAreaMapScale = 0.7f;
+
+#ifdef __SSE2__
+// Returns a word with bit i set where pixels[i] > threshold, for the 32
+// bytes at pixels. 0 <= threshold < 255.
+static inline uinT32 GreaterThanMask(const uinT8* pixels, int threshold) {
+  // max(v, t + 1) == v exactly when v > t, for unsigned bytes.
+  __m128i limit = _mm_set1_epi8(static_cast<char>(threshold + 1));
+  __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels));
+  __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels + 16));
+  return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(lo, limit), lo)) |
+      _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(hi, limit), hi)) << 16;
+}
+
+// Reverses the order of the bytes of a word.
+static inline uinT32 SwapBytes(uinT32 bits) {
+  bits = ((bits >> 8) & 0x00ff00ff) | ((bits & 0x00ff00ff) << 8);
+  return (bits >> 16) | (bits << 16);
+}
+#endif
+
+// Returns the bit pattern of the 32 pixels at pixels as a word of a 1 bit
+// Pix (first pixel in the most significant bit), with a bit set where the
+// pixel is > threshold. 0 <= threshold < 255.
+static inline uinT32 PackGreaterThan(const uinT8* pixels, int threshold) {
+#ifdef __SSE2__
+  // Bit i is pixel i, so reverse the order of the bits.
+  uinT32 bits = GreaterThanMask(pixels, threshold);
+  bits = ((bits >> 1) & 0x55555555) | ((bits & 0x55555555) << 1);
+  bits = ((bits >> 2) & 0x33333333) | ((bits & 0x33333333) << 2);
+  bits = ((bits >> 4) & 0x0f0f0f0f) | ((bits & 0x0f0f0f0f) << 4);
+  return SwapBytes(bits);
+#else
+  uinT32 bits = 0;
+  for (int x = 0; x < 32; ++x)
+    bits = (bits << 1) | (pixels[x] > threshold);
+  return bits;
+#endif
+}
+
+// As PackGreaterThan, for the 32 pixels of the 8 bit Pix line starting at the
+// word line.
+static inline uinT32 PackPix8GreaterThan(const l_uint32* line, int threshold) {
+#if defined(__SSE2__) && defined(L_LITTLE_ENDIAN)
+  // Byte i of the words holds pixel i ^ 3 here, so the bit of pixel x has
+  // to move from position x ^ 3 to 31 - x. Swapping the nibbles of each
+  // byte and then the bytes does exactly that.
+  uinT32 bits = GreaterThanMask(reinterpret_cast<const uinT8*>(line),
+                                threshold);
+  return SwapBytes(((bits >> 4) & 0x0f0f0f0f) | ((bits & 0x0f0f0f0f) << 4));
+#else
+  uinT32 bits = 0;
+  for (int x = 0; x < 32; ++x)
+    bits = (bits << 1) | (GET_DATA_BYTE(line, x) > threshold);
+  return bits;
+#endif
+}
+
+// Computes the histogram of the given rectangle of an 8 bit Pix. Each word
+// holds the same 4 pixels whatever the byte order, so the whole words in
+// each line are counted as plain bytes and only the pixels of the partial
+// words at the ends need GET_DATA_BYTE.
+static void HistogramPix8Rect(Pix* pix, int left, int top,
+                              int width, int height, int* histogram) {
+  const l_uint32* data = pixGetData(pix);
+  int wpl = pixGetWpl(pix);
+  int right = left + width;
+  int word_left = MIN((left + 3) & ~3, right);
+  int word_right = MAX(right & ~3, word_left);
+  HistogramRect(reinterpret_cast<const unsigned char*>(data), 1,
+                wpl * sizeof(l_uint32), word_left, top,
+                word_right - word_left, height, histogram);
+  for (int y = top; y < top + height; ++y) {
+    const l_uint32* line = data + y * wpl;
+    for (int x = left; x < word_left; ++x)
+      ++histogram[GET_DATA_BYTE(line, x)];
+    for (int x = word_right; x < right; ++x)
+      ++histogram[GET_DATA_BYTE(line, x)];
+  }
+}
+
 ImageThresholder::ImageThresholder()
   : pix_(NULL),
     image_data_(NULL),
+    scaled_pix_(NULL),
     image_width_(0), image_height_(0),
     image_bytespp_(0), image_bytespl_(0),
     scale_(1), yres_(300), estimated_res_(300) {
@@ -47,6 +144,8 @@ void ImageThresholder::Clear() {
     pixDestroy(&pix_);
     pix_ = NULL;
   }
+  if (scaled_pix_ != NULL)
+    pixDestroy(&scaled_pix_);
   image_data_ = NULL;
 }
 
@@ -73,6 +172,8 @@ void ImageThresholder::SetImage(const unsigned char* imagedata,
   if (pix_ != NULL)
     pixDestroy(&pix_);
   pix_ = NULL;
+  if (scaled_pix_ != NULL)
+    pixDestroy(&scaled_pix_);
   image_data_ = imagedata;
   image_width_ = width;
   image_height_ = height;
@@ -86,6 +187,8 @@ void ImageThresholder::SetImage(const unsigned char* imagedata,
 // Store the coordinates of the rectangle to process for later use.
 // Doesn't actually do any thresholding.
 void ImageThresholder::SetRectangle(int left, int top, int width, int height) {
+  if (scaled_pix_ != NULL)
+    pixDestroy(&scaled_pix_);
   rect_left_ = left;
   rect_top_ = top;
   rect_width_ = width;
@@ -113,6 +216,8 @@ void ImageThresholder::SetImage(const Pix* pix) {
   image_data_ = NULL;
   if (pix_ != NULL)
     pixDestroy(&pix_);
+  if (scaled_pix_ != NULL)
+    pixDestroy(&scaled_pix_);
   Pix* src = const_cast<Pix*>(pix);
   int depth;
   pixGetDimensions(src, &image_width_, &image_height_, &depth);
@@ -137,6 +242,15 @@ void ImageThresholder::SetImage(const Pix* pix) {
 // Creates a Pix and sets pix to point to the resulting pointer.
 // Caller must use pixDestroy to free the created Pix.
 void ImageThresholder::ThresholdToPix(Pix** pix) {
+  if (scale_ != 1.0f) {
+    // Threshold the scaled rectangle as a whole image of its own.
+    Pix* scaled_pix = GetScaledPixRect();
+    ImageThresholder thresholder;
+    thresholder.SetImage(scaled_pix);
+    pixDestroy(&scaled_pix);
+    thresholder.ThresholdToPix(pix);
+    return;
+  }
   if (pix_ != NULL) {
     if (image_bytespp_ == 0) {
       // We have a binary image, so it just has to be cloned.
@@ -147,6 +261,8 @@ void ImageThresholder::ThresholdToPix(Pix** pix) {
         const uinT32* data = pixGetData(pix_);
         OtsuThresholdRectToPix(reinterpret_cast<const uinT8*>(data),
                                image_bytespp_, image_bytespl_, pix);
+      } else if (image_bytespp_ == 1) {
+        OtsuThresholdPix8RectToPix(pix);
       } else {
         // Convert 8-bit to IMAGE and then pass its
         // buffer to the raw interface to complete the conversion.
@@ -204,7 +320,8 @@ Pix* ImageThresholder::GetPixRect() {
 // the layout analysis that uses it will only be available with Leptonica,
 // so there is no raw equivalent.
 Pix* ImageThresholder::GetPixRectGrey() {
-  Pix* pix = GetPixRect();  // May have to be reduced to grey.
+  // May have to be reduced to grey.
+  Pix* pix = scale_ != 1.0f ? GetScaledPixRect() : GetPixRect();
   int depth = pixGetDepth(pix);
   if (depth != 8) {
     Pix* result = depth < 8 ? pixConvertTo8(pix, false)
@@ -215,6 +332,60 @@ Pix* ImageThresholder::GetPixRectGrey() {
   return pix;
 }
 
+// Scale the image rectangle by the given factor before thresholding.
+void ImageThresholder::SetScaleFactor(float scale) {
+  if (scale != scale_ && scaled_pix_ != NULL)
+    pixDestroy(&scaled_pix_);
+  scale_ = scale;
+}
+
+// Estimate the x-height of the text in a binary image as the median height
+// of its letter sized connected components.
+int ImageThresholder::EstimateXHeight(Pix* pix_binary) {
+  Boxa* boxa = pixConnCompBB(pix_binary, 8);
+  if (boxa == NULL)
+    return 0;
+  int max_height = pixGetHeight(pix_binary);
+  int count = boxaGetCount(boxa);
+  int* heights = new int[count];
+  int num_heights = 0;
+  for (int i = 0; i < count; ++i) {
+    l_int32 x, y, width, height;
+    boxaGetBoxGeometry(boxa, i, &x, &y, &width, &height);
+    // Skip specks, rules and anything as large as a tenth of the image.
+    if (height >= kMinLetterHeight && width <= kMaxLetterAspect * height &&
+        height * 10 <= max_height)
+      heights[num_heights++] = height;
+  }
+  boxaDestroy(&boxa);
+  int x_height = 0;
+  if (num_heights >= kMinLettersForXHeight) {
+    std::nth_element(heights, heights + num_heights / 2,
+                     heights + num_heights);
+    x_height = heights[num_heights / 2];
+  }
+  delete [] heights;
+  return x_height;
+}
+
+// Get a clone of the image rectangle scaled by scale_.
+Pix* ImageThresholder::GetScaledPixRect() {
+  if (scaled_pix_ == NULL) {
+    Pix* pix = GetPixRect();
+    // Scaling binary images down to grey keeps their partial pixels. Area
+    // mapping antialiases grey and color images at half the cost of the
+    // sharpening that pixScale adds, which thresholding does not need.
+    if (pixGetDepth(pix) == 1 && scale_ < 1.0f)
+      scaled_pix_ = pixScaleToGray(pix, scale_);
+    else if (scale_ < kMaxAreaMapScale)
+      scaled_pix_ = pixScaleAreaMap(pix, scale_, scale_);
+    else
+      scaled_pix_ = pixScale(pix, scale_, scale_);
+    pixDestroy(&pix);
+  }
+  return pixClone(scaled_pix_);
+}
+
 // Otsu threshold the rectangle, taking everything except the image buffer
 // pointer from the class, to the output Pix.
 void ImageThresholder::OtsuThresholdRectToPix(const unsigned char* imagedata,
@@ -234,6 +405,64 @@ void ImageThresholder::OtsuThresholdRectToPix(const unsigned char* imagedata,
   delete [] hi_values;
 }
 
+// Otsu threshold the rectangle of the 8 bit pix_ to the output Pix,
+// reading pix_ directly rather than a copy of it in an IMAGE.
+void ImageThresholder::OtsuThresholdPix8RectToPix(Pix** pix) const {
+  int histogram[kHistogramSize];
+  HistogramPix8Rect(pix_, rect_left_, rect_top_, rect_width_, rect_height_,
+                    histogram);
+  int threshold;
+  int hi_value;
+  OtsuThresholdHistograms(histogram, 1, &threshold, &hi_value);
+
+  *pix = pixCreate(rect_width_, rect_height_, 1);
+  if (hi_value < 0 || threshold < 0 || threshold >= 255) {
+    // Everything is white, or all pixels are on the same side.
+    if (hi_value >= 0 && (threshold < 0) == (hi_value == 0)) {
+      pixSetAll(*pix);
+      pixSetPadBits(*pix, 0);
+    }
+    return;
+  }
+  // Pack the pixels 32 at a time, starting at the word holding rect_left_
+  // in pix_, then shift the words into place for the output.
+  uinT32 flip = hi_value == 0 ? 0 : 0xffffffff;
+  int shift = rect_left_ & 31;
+  int first_word = rect_left_ >> 5;
+  int num_words = ((rect_left_ + rect_width_ + 31) >> 5) - first_word;
+  int full_words = MIN(num_words, (image_width_ >> 5) - first_word);
+  uinT32* words = new uinT32[num_words + 1];
+  words[num_words] = 0;
+  const l_uint32* data = pixGetData(pix_);
+  int src_wpl = pixGetWpl(pix_);
+  uinT32* pixdata = pixGetData(*pix);
+  int wpl = pixGetWpl(*pix);
+  uinT32 last_mask = (rect_width_ & 31) == 0 ? 0xffffffff
+                     : ~(0xffffffff >> (rect_width_ & 31));
+  for (int y = 0; y < rect_height_; ++y) {
+    const l_uint32* line = data + (rect_top_ + y) * src_wpl;
+    for (int w = 0; w < full_words; ++w)
+      words[w] = PackPix8GreaterThan(line + (first_word + w) * 8, threshold);
+    for (int w = full_words; w < num_words; ++w) {
+      // The partial word at the right edge of pix_.
+      words[w] = 0;
+      int x = (first_word + w) << 5;
+      for (int bit = 31; x < image_width_; ++x, --bit)
+        words[w] |= static_cast<uinT32>(GET_DATA_BYTE(line, x) > threshold)
+                    << bit;
+    }
+    uinT32* pixline = pixdata + y * wpl;
+    for (int w = 0; w < wpl; ++w) {
+      uinT32 word = words[w];
+      if (shift != 0)
+        word = (word << shift) | (words[w + 1] >> (32 - shift));
+      pixline[w] = word ^ flip;
+    }
+    pixline[wpl - 1] &= last_mask;
+  }
+  delete [] words;
+}
+
 // Threshold the rectangle, taking everything except the image buffer pointer
 // from the class, using thresholds/hi_values to the output IMAGE.
 void ImageThresholder::ThresholdRectToPix(const unsigned char* imagedata,
@@ -247,10 +476,22 @@ void ImageThresholder::ThresholdRectToPix(const unsigned char* imagedata,
   int wpl = pixGetWpl(*pix);
   const unsigned char* srcdata = imagedata + rect_top_* bytes_per_line +
                                  rect_left_ * bytes_per_pixel;
+  // A single channel can be packed 32 pixels at a time.
+  bool packed = bytes_per_pixel == 1 && hi_values[0] >= 0 &&
+                thresholds[0] >= 0 && thresholds[0] < 255;
+  uinT32 flip = packed && hi_values[0] == 1 ? 0xffffffff : 0;
   for (int y = 0; y < rect_height_; ++y) {
     const uinT8* linedata = srcdata;
     uinT32* pixline = pixdata + y * wpl;
-    for (int x = 0; x < rect_width_; ++x, linedata += bytes_per_pixel) {
+    int x = 0;
+    if (packed) {
+      for (; x + 32 <= rect_width_; x += 32, linedata += 32)
+        pixline[x >> 5] = PackGreaterThan(linedata, thresholds[0]) ^ flip;
+    }
+    // Collect the bits of the remaining pixels in a word, and store it
+    // whenever it is full.
+    uinT32 word = 0;
+    for (; x < rect_width_; ++x, linedata += bytes_per_pixel) {
       bool white_result = true;
       for (int ch = 0; ch < bytes_per_pixel; ++ch) {
         if (hi_values[ch] >= 0 &&
@@ -259,11 +500,14 @@ void ImageThresholder::ThresholdRectToPix(const unsigned char* imagedata,
           break;
         }
       }
-      if (white_result)
-        CLEAR_DATA_BIT(pixline, x);
-      else
-        SET_DATA_BIT(pixline, x);
+      word = (word << 1) | !white_result;
+      if ((x & 31) == 31) {
+        pixline[x >> 5] = word;
+        word = 0;
+      }
     }
+    if ((rect_width_ & 31) != 0)
+      pixline[rect_width_ >> 5] = word << (32 - (rect_width_ & 31));
     srcdata += bytes_per_line;
   }
 }
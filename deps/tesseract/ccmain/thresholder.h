@@ -76,10 +76,21 @@ class ImageThresholder {
     return image_bytespp_ == 0;
   }
 
-  int GetScaleFactor() const {
+  float GetScaleFactor() const {
     return scale_;
   }
 
+  /// Scale the image rectangle by the given factor before thresholding,
+  /// e.g. to bring text that is larger than recognition needs down in size.
+  /// Coordinates in the thresholded image must be divided by the scale
+  /// factor to get back to the rectangle.
+  void SetScaleFactor(float scale);
+
+  /// Estimate the x-height of the text in a binary image as the median height
+  /// of its letter sized connected components, which are mostly lower case
+  /// letters in running text. Returns 0 if there are too few of them.
+  static int EstimateXHeight(Pix* pix_binary);
+
   // Set the resolution of the source image in pixels per inch.
   // This should be called right after SetImage(), and will let us return
   // appropriate font sizes for the text.
@@ -91,7 +102,7 @@ class ImageThresholder {
     return yres_;
   }
   int GetScaledYResolution() const {
-    return scale_ * yres_;
+    return static_cast<int>(scale_ * yres_ + 0.5f);
   }
   // Set the resolution of the source image in pixels per inch, as estimated
   // by the thresholder from the text size found during thresholding.
@@ -104,7 +115,7 @@ class ImageThresholder {
   // Returns the estimated resolution, including any active scaling.
   // This value will be used to set internal size thresholds during recognition.
   int GetScaledEstimatedResolution() const {
-    return scale_ * estimated_res_;
+    return static_cast<int>(scale_ * estimated_res_ + 0.5f);
   }
 
   /// Pix vs raw, which to use?
@@ -155,6 +166,10 @@ class ImageThresholder {
                               int bytes_per_pixel, int bytes_per_line,
                               Pix** pix) const;
 
+  /// Otsu threshold the rectangle of the 8 bit pix_ to the output Pix,
+  /// reading pix_ directly rather than a copy of it in an IMAGE.
+  void OtsuThresholdPix8RectToPix(Pix** pix) const;
+
   /// Threshold the rectangle, taking everything except the image buffer pointer
   /// from the class, using thresholds/hi_values to the output IMAGE.
   void ThresholdRectToPix(const unsigned char* imagedata,
@@ -165,19 +180,25 @@ class ImageThresholder {
   /// Copy the raw image rectangle, taking all data from the class, to the Pix.
   void RawRectToPix(Pix** pix) const;
 
+  /// Get a clone of the image rectangle scaled by scale_, which is made once
+  /// and kept in scaled_pix_. Binary images are scaled to greyscale.
+  Pix* GetScaledPixRect();
+
  protected:
   /// Clone or other copy of the source Pix.
   /// The pix will always be PixDestroy()ed on destruction of the class.
   Pix*                 pix_;
   /// Exactly one of pix_ and image_data_ is not NULL.
   const unsigned char* image_data_;     //< Raw source image.
+  /// The image rectangle scaled by scale_ if it is not 1, or NULL.
+  Pix*                 scaled_pix_;
 
   int                  image_width_;    //< Width of source image/pix.
   int                  image_height_;   //< Height of source image/pix.
   int                  image_bytespp_;  //< Bytes per pixel of source image/pix.
   int                  image_bytespl_;  //< Bytes per line of source image/pix.
   // Limits of image rectangle to be processed.
-  int                  scale_;          //< Scale factor from original image.
+  float                scale_;          //< Scale factor from original image.
   int                  yres_;           //< y pixels/inch in source image.
   int                  estimated_res_;  //< Resolution estimate from text size.
   int                  rect_left_;
@@ -20,6 +20,11 @@
 #include <string.h>
 #include "otsuthr.h"
 
+// SumSubHistograms adds up four counters per SSE2 instruction.
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 namespace tesseract {
 
 // Compute the Otsu threshold(s) for the given image rectangle, making one
@@ -33,25 +38,38 @@ void OtsuThreshold(const unsigned char* imagedata,
                    int bytes_per_pixel, int bytes_per_line,
                    int left, int top, int width, int height,
                    int** thresholds, int** hi_values) {
+  *thresholds = new int[bytes_per_pixel];
+  *hi_values = new int[bytes_per_pixel];
+  int* histograms = new int[bytes_per_pixel * kHistogramSize];
+  for (int ch = 0; ch < bytes_per_pixel; ++ch) {
+    // Compute the histogram of the image rectangle.
+    HistogramRect(imagedata + ch, bytes_per_pixel, bytes_per_line,
+                  left, top, width, height, histograms + ch * kHistogramSize);
+  }
+  OtsuThresholdHistograms(histograms, bytes_per_pixel,
+                          *thresholds, *hi_values);
+  delete [] histograms;
+}
+
+// Compute the Otsu threshold(s) from the histograms of num_channels channels,
+// stored one after the other in histograms. Fills the num_channels elements
+// of thresholds and hi_values as described for OtsuThreshold.
+void OtsuThresholdHistograms(const int* histograms, int num_channels,
+                             int* thresholds, int* hi_values) {
   // Of all channels with no good hi_value, keep the best so we can always
   // produce at least one answer.
   int best_hi_value = 1;
   int best_hi_index = 0;
   bool any_good_hivalue = false;
   double best_hi_dist = 0.0;
-  *thresholds = new int[bytes_per_pixel];
-  *hi_values = new int[bytes_per_pixel];
 
-  for (int ch = 0; ch < bytes_per_pixel; ++ch) {
-    (*thresholds)[ch] = -1;
-    (*hi_values)[ch] = -1;
-    // Compute the histogram of the image rectangle.
-    int histogram[kHistogramSize];
-    HistogramRect(imagedata + ch, bytes_per_pixel, bytes_per_line,
-                  left, top, width, height, histogram);
+  for (int ch = 0; ch < num_channels; ++ch) {
+    thresholds[ch] = -1;
+    hi_values[ch] = -1;
     int H;
     int best_omega_0;
-    int best_t = OtsuStats(histogram, &H, &best_omega_0);
+    int best_t = OtsuStats(histograms + ch * kHistogramSize,
+                           &H, &best_omega_0);
     if (best_omega_0 == 0 || best_omega_0 == H) {
        // This channel is empty.
        continue;
@@ -60,13 +78,13 @@ void OtsuThreshold(const unsigned char* imagedata,
     // or to be a convincing background we must have a large fraction of H.
     // In between we assume this channel contains no thresholding information.
     int hi_value = best_omega_0 < H * 0.5;
-    (*thresholds)[ch] = best_t;
+    thresholds[ch] = best_t;
     if (best_omega_0 > H * 0.75) {
       any_good_hivalue = true;
-      (*hi_values)[ch] = 0;
+      hi_values[ch] = 0;
     } else if (best_omega_0 < H * 0.25) {
       any_good_hivalue = true;
-      (*hi_values)[ch] = 1;
+      hi_values[ch] = 1;
     } else {
       // In case all channels are like this, keep the best of the bad lot.
       double hi_dist = hi_value ? (H - best_omega_0) : best_omega_0;
@@ -79,7 +97,7 @@ void OtsuThreshold(const unsigned char* imagedata,
   }
   if (!any_good_hivalue) {
     // Use the best of the ones that were not good enough.
-    (*hi_values)[best_hi_index] = best_hi_value;
+    hi_values[best_hi_index] = best_hi_value;
   }
 }
 
@@ -94,17 +112,52 @@ void HistogramRect(const unsigned char* imagedata,
                    int bytes_per_pixel, int bytes_per_line,
                    int left, int top, int width, int height,
                    int* histogram) {
+  // Neighbouring pixels mostly have the same value, so with one histogram
+  // each increment would wait for the previous one to be stored. Counting
+  // consecutive pixels into separate histograms lets them overlap.
+  int sub_histograms[kNumSubHistograms][kHistogramSize];
+  memset(sub_histograms, 0, sizeof(sub_histograms));
   int bottom = top + height;
-  memset(histogram, 0, sizeof(*histogram) * kHistogramSize);
   const unsigned char* pixels = imagedata +
                                 top * bytes_per_line +
                                 left * bytes_per_pixel;
   for (int y = top; y < bottom; ++y) {
-    for (int x = 0; x < width; ++x) {
-      ++histogram[pixels[x * bytes_per_pixel]];
+    const unsigned char* pixel = pixels;
+    int x = 0;
+    for (; x + kNumSubHistograms <= width; x += kNumSubHistograms) {
+      ++sub_histograms[0][pixel[0]];
+      ++sub_histograms[1][pixel[bytes_per_pixel]];
+      ++sub_histograms[2][pixel[2 * bytes_per_pixel]];
+      ++sub_histograms[3][pixel[3 * bytes_per_pixel]];
+      pixel += kNumSubHistograms * bytes_per_pixel;
     }
+    for (; x < width; ++x, pixel += bytes_per_pixel)
+      ++sub_histograms[0][*pixel];
     pixels += bytes_per_line;
   }
+  SumSubHistograms(sub_histograms, histogram);
+}
+
+// Adds up the given sub-histograms into histogram.
+void SumSubHistograms(const int sub_histograms[][kHistogramSize],
+                      int* histogram) {
+  int i = 0;
+#ifdef __SSE2__
+  for (; i + 4 <= kHistogramSize; i += 4) {
+    __m128i sum = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(sub_histograms[0] + i));
+    for (int s = 1; s < kNumSubHistograms; ++s) {
+      sum = _mm_add_epi32(sum, _mm_loadu_si128(
+          reinterpret_cast<const __m128i*>(sub_histograms[s] + i)));
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(histogram + i), sum);
+  }
+#endif
+  for (; i < kHistogramSize; ++i) {
+    histogram[i] = sub_histograms[0][i];
+    for (int s = 1; s < kNumSubHistograms; ++s)
+      histogram[i] += sub_histograms[s][i];
+  }
 }
 
 // Compute the Otsu threshold(s) for the given histogram.
@@ -23,6 +23,8 @@
 namespace tesseract {
 
 const int kHistogramSize = 256;  // The size of a histogram of pixel values.
+// The number of histograms consecutive pixels are counted into.
+const int kNumSubHistograms = 4;
 
 // Compute the Otsu threshold(s) for the given image rectangle, making one
 // for each channel. Each channel is always one byte per pixel.
@@ -36,6 +38,12 @@ void OtsuThreshold(const unsigned char* imagedata,
                    int left, int top, int width, int height,
                    int** thresholds, int** hi_values);
 
+// Compute the Otsu threshold(s) from the histograms of num_channels channels,
+// stored one after the other in histograms. Fills the num_channels elements
+// of thresholds and hi_values as described for OtsuThreshold.
+void OtsuThresholdHistograms(const int* histograms, int num_channels,
+                             int* thresholds, int* hi_values);
+
 // Compute the histogram for the given image rectangle, and the given
 // channel. (Channel pointed to by imagedata.) Each channel is always
 // one byte per pixel.
@@ -48,6 +56,10 @@ void HistogramRect(const unsigned char* imagedata,
                    int left, int top, int width, int height,
                    int* histogram);
 
+// Adds up the given kNumSubHistograms sub-histograms into histogram.
+void SumSubHistograms(const int sub_histograms[][kHistogramSize],
+                      int* histogram);
+
 // Compute the Otsu threshold(s) for the given histogram.
 // Also returns H = total count in histogram, and
 // omega0 = count of histogram below threshold.
@@ -48,5 +48,31 @@ void CCUtilMutex::Unlock() {
 #endif
 }
 
+CCUtilThread::CCUtilThread() : started_(false) {
+}
+
+void CCUtilThread::Start(void *(*func)(void*), void* arg) {
+#ifdef _WIN32
+  thread_ = CreateThread(0, 0, (LPTHREAD_START_ROUTINE) func, arg, 0, 0);
+  started_ = thread_ != 0;
+#else
+  started_ = pthread_create(&thread_, NULL, func, arg) == 0;
+#endif
+  if (!started_)
+    func(arg);
+}
+
+void CCUtilThread::Join() {
+  if (!started_)
+    return;
+#ifdef _WIN32
+  WaitForSingleObject(thread_, INFINITE);
+  CloseHandle(thread_);
+#else
+  pthread_join(thread_, NULL);
+#endif
+  started_ = false;
+}
+
 CCUtilMutex tprintfMutex;  // should remain global
 } // namespace tesseract
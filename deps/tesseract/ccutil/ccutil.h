@@ -50,6 +50,27 @@ class CCUtilMutex {
 #endif
 };
 
+// A thread that can be waited for, to split work over several threads and
+// collect the results.
+class CCUtilThread {
+ public:
+  CCUtilThread();
+
+  // Runs func(arg) on a new thread. If no thread can be created, func is run
+  // on the calling thread instead.
+  void Start(void *(*func)(void*), void* arg);
+
+  // Waits for the function given to Start to return.
+  void Join();
+ private:
+  bool started_;
+#ifdef _WIN32
+  HANDLE thread_;
+#else
+  pthread_t thread_;
+#endif
+};
+
 
 class CCUtil {
  public:
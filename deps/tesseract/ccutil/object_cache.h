@@ -0,0 +1,113 @@
+///////////////////////////////////////////////////////////////////////
+// File:        object_cache.h
+// Description: A thread-safe, reference counted cache of objects that are
+//              loaded once and shared read-only between engines.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef TESSERACT_CCUTIL_OBJECT_CACHE_H_
+#define TESSERACT_CCUTIL_OBJECT_CACHE_H_
+
+#include "ccutil.h"
+#include "genericvector.h"
+#include "strngs.h"
+
+namespace tesseract {
+
+// Keeps one instance of each object, identified by a string id such as the
+// data file it was read from. Engines that load the same data get the same
+// instance, which must therefore never be modified after it is added.
+// Objects are deleted when the last reference is freed, so the cache holds
+// nothing that is unused. It must outlive the engines using it, which is
+// why caches are allocated once and never destroyed.
+template<typename T>
+class ObjectCache {
+ public:
+  ObjectCache() {}
+
+  // Returns the object with the given id and counts a new reference to it,
+  // or NULL if there is none yet.
+  T *Get(const STRING &id) {
+    T *object = NULL;
+    mutex_.Lock();
+    for (int i = 0; i < items_.size(); ++i) {
+      if (items_[i].id == id) {
+        ++items_[i].count;
+        object = items_[i].object;
+        break;
+      }
+    }
+    mutex_.Unlock();
+    return object;
+  }
+
+  // Adds a newly loaded object with one reference and returns it. If another
+  // thread added an object with the same id in the meantime, object is
+  // deleted and a new reference to the other one is returned instead.
+  T *Add(const STRING &id, T *object) {
+    mutex_.Lock();
+    for (int i = 0; i < items_.size(); ++i) {
+      if (items_[i].id == id) {
+        ++items_[i].count;
+        T *cached = items_[i].object;
+        mutex_.Unlock();
+        delete object;
+        return cached;
+      }
+    }
+    Item item;
+    item.id = id;
+    item.object = object;
+    item.count = 1;
+    items_.push_back(item);
+    mutex_.Unlock();
+    return object;
+  }
+
+  // Drops a reference to object and deletes it if it was the last one.
+  // Returns false if object is not in the cache.
+  bool Free(T *object) {
+    if (object == NULL)
+      return false;
+    T *unused = NULL;
+    bool found = false;
+    mutex_.Lock();
+    for (int i = 0; i < items_.size(); ++i) {
+      if (items_[i].object == object) {
+        found = true;
+        if (--items_[i].count == 0) {
+          unused = object;
+          items_.remove(i);
+        }
+        break;
+      }
+    }
+    mutex_.Unlock();
+    delete unused;
+    return found;
+  }
+
+ private:
+  struct Item {
+    STRING id;
+    T *object;
+    int count;
+  };
+
+  CCUtilMutex mutex_;
+  GenericVector<Item> items_;
+};
+
+}  // namespace tesseract
+
+#endif  // TESSERACT_CCUTIL_OBJECT_CACHE_H_
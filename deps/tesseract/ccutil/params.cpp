@@ -207,4 +207,56 @@ void ParamUtils::PrintParams(FILE *fp, const ParamsVectors *member_params) {
   }
 }
 
+// Copies the non-init params of one type. The vectors normally belong to two
+// instances of the same class, so the name at the same index is tried first.
+template<class T>
+static void CopyParamVector(const GenericVector<T *> &src,
+                            GenericVector<T *> *dst) {
+  for (int i = 0; i < src.size(); ++i) {
+    if (src[i]->is_init()) continue;
+    const char *name = src[i]->name_str();
+    T *param = NULL;
+    if (i < dst->size() && strcmp((*dst)[i]->name_str(), name) == 0) {
+      param = (*dst)[i];
+    } else {
+      for (int j = 0; j < dst->size() && param == NULL; ++j) {
+        if (strcmp((*dst)[j]->name_str(), name) == 0) param = (*dst)[j];
+      }
+    }
+    if (param != NULL) param->set_value(*src[i]);
+  }
+}
+
+void ParamUtils::CopyParams(const ParamsVectors &src, ParamsVectors *dst) {
+  CopyParamVector(src.int_params, &dst->int_params);
+  CopyParamVector(src.bool_params, &dst->bool_params);
+  CopyParamVector(src.string_params, &dst->string_params);
+  CopyParamVector(src.double_params, &dst->double_params);
+}
+
+// Appends the names and values of the init params of one type.
+template<class T>
+static void GetInitParamVector(const GenericVector<T *> &vec,
+                               const ParamsVectors &params,
+                               GenericVector<STRING> *names,
+                               GenericVector<STRING> *values) {
+  for (int i = 0; i < vec.size(); ++i) {
+    if (!vec[i]->is_init()) continue;
+    STRING value;
+    if (ParamUtils::GetParamAsString(vec[i]->name_str(), &params, &value)) {
+      names->push_back(STRING(vec[i]->name_str()));
+      values->push_back(value);
+    }
+  }
+}
+
+void ParamUtils::GetInitParams(const ParamsVectors &params,
+                               GenericVector<STRING> *names,
+                               GenericVector<STRING> *values) {
+  GetInitParamVector(params.int_params, params, names, values);
+  GetInitParamVector(params.bool_params, params, names, values);
+  GetInitParamVector(params.string_params, params, names, values);
+  GetInitParamVector(params.double_params, params, names, values);
+}
+
 }  // namespace tesseract
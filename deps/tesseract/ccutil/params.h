@@ -104,6 +104,18 @@ class ParamUtils {
 
   // Print parameters to the given file.
   static void PrintParams(FILE *fp, const ParamsVectors *member_params);
+
+  // Copies the values of the parameters in src to the parameters with the
+  // same names in dst. Init parameters are skipped, as they only take effect
+  // while the data files are loaded.
+  static void CopyParams(const ParamsVectors &src, ParamsVectors *dst);
+
+  // Appends the names and values of the init parameters in params to names
+  // and values, as taken by Tesseract::init_tesseract, so that another
+  // instance can be loaded with the same settings.
+  static void GetInitParams(const ParamsVectors &params,
+                            GenericVector<STRING> *names,
+                            GenericVector<STRING> *values);
 };
 
 // Definition of various parameter types.
@@ -67,6 +67,11 @@
 
 #define ADAPT_TEMPLATE_SUFFIX ".a"
 
+// Marks the start of the data written by WriteAdaptiveClassifier.
+#define ADAPT_SNAPSHOT_MAGIC 0x74616461  // "adat"
+// Initial value of the FNV-1a hash of the snapshot templates.
+#define ADAPT_SNAPSHOT_HASH_SEED 2166136261u
+
 #define MAX_MATCHES         10
 #define UNLIKELY_NUM_FEAT 200
 #define NO_DEBUG      0
@@ -643,6 +648,97 @@ void Classify::ResetAdaptiveClassifierInternal() {
   NumAdaptationsFailed = 0;
 }
 
+// Reads size bytes from File, updating the FNV-1a hash with them, and
+// writes them to Copy unless it is NULL. Returns false on error.
+static bool HashSnapshotData(FILE *File, long size, uinT32 *hash,
+                             FILE *Copy) {
+  char buffer[4096];
+  while (size > 0) {
+    size_t count = size < static_cast<long>(sizeof(buffer))
+                   ? static_cast<size_t>(size) : sizeof(buffer);
+    if (fread(buffer, 1, count, File) != count)
+      return false;
+    for (size_t i = 0; i < count; ++i)
+      *hash = (*hash ^ static_cast<uinT8>(buffer[i])) * 16777619u;
+    if (Copy != NULL && fwrite(buffer, 1, count, Copy) != count)
+      return false;
+    size -= count;
+  }
+  return true;
+}
+
+// Writes the adapted templates to File, headed by the language and
+// unicharset size they belong to, and the size and hash of the templates.
+// Returns false on error.
+bool Classify::WriteAdaptiveClassifier(FILE *File) {
+  if (AdaptedTemplates == NULL)
+    AdaptedTemplates = NewAdaptedTemplates(true);
+  // The templates go to a temporary file first, to get their size and hash.
+  FILE *data = tmpfile();
+  if (data == NULL)
+    return false;
+  WriteAdaptedTemplates(data, AdaptedTemplates);
+  long size = ftell(data);
+  uinT32 hash = ADAPT_SNAPSHOT_HASH_SEED;
+  rewind(data);
+  bool ok = ferror(data) == 0 && size >= 0 &&
+      HashSnapshotData(data, size, &hash, NULL);
+  inT32 header[5] = {
+    ADAPT_SNAPSHOT_MAGIC, unicharset.size(), lang.length(),
+    static_cast<inT32>(size), static_cast<inT32>(hash)
+  };
+  rewind(data);
+  ok = ok && fwrite(header, sizeof(header), 1, File) == 1 &&
+      fwrite(lang.string(), 1, lang.length(), File) ==
+          static_cast<size_t>(lang.length()) &&
+      HashSnapshotData(data, size, &hash, File);
+  fclose(data);
+  return ok && ferror(File) == 0;
+}
+
+// Reads the templates written by WriteAdaptiveClassifier at the current
+// position of File without using them, and leaves File after them.
+// Returns the position of the templates, or -1 if File holds templates for
+// another language, or they are truncated or damaged.
+long Classify::CheckAdaptiveClassifier(FILE *File) const {
+  inT32 header[5];
+  if (fread(header, sizeof(header), 1, File) != 1 ||
+      header[0] != ADAPT_SNAPSHOT_MAGIC || header[1] != unicharset.size() ||
+      header[2] != lang.length() || header[3] < 0)
+    return -1;
+  STRING file_lang;
+  for (int i = 0; i < header[2]; ++i) {
+    int ch = fgetc(File);
+    if (ch == EOF) return -1;
+    file_lang += static_cast<char>(ch);
+  }
+  if (file_lang != lang)
+    return -1;
+  long position = ftell(File);
+  uinT32 hash = ADAPT_SNAPSHOT_HASH_SEED;
+  if (!HashSnapshotData(File, header[3], &hash, NULL) ||
+      hash != static_cast<uinT32>(header[4]))
+    return -1;
+  return position;
+}
+
+// Replaces the adapted templates with the ones at position in File, as
+// returned by CheckAdaptiveClassifier.
+void Classify::LoadAdaptiveClassifier(FILE *File, long position) {
+  fseek(File, position, SEEK_SET);
+  ResetAdaptiveClassifierInternal();
+  // The int templates are written with a copy of the font tables, which is
+  // the same for every classifier of the language. Empty the tables so that
+  // reading them again replaces the entries rather than leaking them.
+  fontinfo_table_.clear();
+  fontset_table_.clear();
+  SetFontTableCallbacks();
+  AdaptedTemplates = ReadAdaptedTemplates(File);
+  for (int i = 0; i < AdaptedTemplates->Templates->NumClasses; i++) {
+    BaselineCutoffs[i] = CharNormCutoffs[i];
+  }
+}
+
 
 /*---------------------------------------------------------------------------*/
 /**
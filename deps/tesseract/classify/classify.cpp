@@ -128,6 +128,9 @@ Classify::Classify()
                "Class Pruner CutoffStrength:         ", this->params()),
     INT_MEMBER(classify_integer_matcher_multiplier, 14,
                "Integer Matcher Multiplier  0-255:   ", this->params()),
+    BOOL_MEMBER(classify_simd_class_pruner, TRUE,
+                "Use the SIMD class pruner kernels if the build has them",
+                this->params()),
     EnableLearning(true),
     INT_MEMBER(il1_adaption_test, 0, "Dont adapt to i/I at beginning of word",
                this->params()),
@@ -135,14 +138,7 @@ Classify::Classify()
                 "Assume the input is numbers [0-9].", this->params()),
     shape_table_(NULL),
     dict_(&image_) {
-  fontinfo_table_.set_compare_callback(
-      NewPermanentTessCallback(CompareFontInfo));
-  fontinfo_table_.set_clear_callback(
-      NewPermanentTessCallback(FontInfoDeleteCallback));
-  fontset_table_.set_compare_callback(
-      NewPermanentTessCallback(CompareFontSet));
-  fontset_table_.set_clear_callback(
-      NewPermanentTessCallback(FontSetDeleteCallback));
+  SetFontTableCallbacks();
   AdaptedTemplates = NULL;
   PreTrainedTemplates = NULL;
   AllProtosOn = NULL;
@@ -175,6 +171,17 @@ Classify::Classify()
   BaselineCutoffs = new uinT16[MAX_NUM_CLASSES];
 }
 
+void Classify::SetFontTableCallbacks() {
+  fontinfo_table_.set_compare_callback(
+      NewPermanentTessCallback(CompareFontInfo));
+  fontinfo_table_.set_clear_callback(
+      NewPermanentTessCallback(FontInfoDeleteCallback));
+  fontset_table_.set_compare_callback(
+      NewPermanentTessCallback(CompareFontSet));
+  fontset_table_.set_clear_callback(
+      NewPermanentTessCallback(FontSetDeleteCallback));
+}
+
 Classify::~Classify() {
   EndAdaptiveClassifier();
   delete learn_debug_win_;
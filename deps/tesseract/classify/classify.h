@@ -289,6 +289,18 @@ class Classify : public CCStruct {
                           CLASS_PRUNER_RESULTS cp_results);
   void ClassifyAsNoise(ADAPT_RESULTS *Results);
   void ResetAdaptiveClassifierInternal();
+  // Writes the adapted templates to File, headed by the language and
+  // unicharset size they belong to, and the size and hash of the templates.
+  // Returns false on error.
+  bool WriteAdaptiveClassifier(FILE *File);
+  // Reads the templates written by WriteAdaptiveClassifier at the current
+  // position of File without using them, and leaves File after them.
+  // Returns the position of the templates, or -1 if File holds templates
+  // for another language, or they are truncated or damaged.
+  long CheckAdaptiveClassifier(FILE *File) const;
+  // Replaces the adapted templates with the ones at position in File, as
+  // returned by CheckAdaptiveClassifier.
+  void LoadAdaptiveClassifier(FILE *File, long position);
 
   int GetBaselineFeatures(TBLOB *Blob,
                           const DENORM& denorm,
@@ -424,6 +436,8 @@ class Classify : public CCStruct {
             "Class Pruner CutoffStrength:         ");
   INT_VAR_H(classify_integer_matcher_multiplier, 14,
             "Integer Matcher Multiplier  0-255:   ");
+  BOOL_VAR_H(classify_simd_class_pruner, TRUE,
+             "Use the SIMD class pruner kernels if the build has them");
 
   // Use class variables to hold onto built-in templates and adapted templates.
   INT_TEMPLATES PreTrainedTemplates;
@@ -464,6 +478,9 @@ class Classify : public CCStruct {
   ShapeTable* shape_table_;
 
  private:
+  // Sets the callbacks that compare and free the entries of fontinfo_table_
+  // and fontset_table_.
+  void SetFontTableCallbacks();
 
   Dict dict_;
 
@@ -35,6 +35,17 @@
 #include "classify.h"
 #include "shapetable.h"
 #include <math.h>
+#include <string.h>
+
+// Proto evidence is computed 8 protos at a time with AVX2 and 4 at a time
+// with SSE4.1; SSE2 is enough for the evidence sums.
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE4_1__)
+#include <smmintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 /*----------------------------------------------------------------------------
                     Global Data Definitions and Declarations
@@ -108,7 +119,7 @@ namespace tesseract {
 // number of features present.
 class ClassPruner {
  public:
-  ClassPruner(int max_classes) {
+  ClassPruner(int max_classes, bool use_simd) {
     // The unrolled loop in ComputeScores means that the array sizes need to
     // be rounded up so that the array is big enough to accommodate the extra
     // entries accessed by the unrolling. Each pruner word is of sized
@@ -128,6 +139,7 @@ class ClassPruner {
     pruning_threshold_ = 0;
     num_features_ = 0;
     num_classes_ = 0;
+    use_simd_ = use_simd;
   }
 
   ~ClassPruner() {
@@ -142,6 +154,14 @@ class ClassPruner {
   void ComputeScores(const INT_TEMPLATES_STRUCT* int_templates,
                      int num_features, const INT_FEATURE_STRUCT* features) {
     num_features_ = num_features;
+#if defined(__SSE2__)
+    // The 16 bit accumulators of the SIMD kernel hold at most
+    // MAX_NUM_INT_FEATURES * CLASS_PRUNER_CLASS_MASK.
+    if (use_simd_ && num_features <= MAX_NUM_INT_FEATURES) {
+      ComputeScoresSIMD(int_templates, num_features, features);
+      return;
+    }
+#endif
     int num_pruners = int_templates->NumClassPruners;
     for (int f = 0; f < num_features; ++f) {
       const INT_FEATURE_STRUCT* feature = &features[f];
@@ -205,6 +225,102 @@ class ClassPruner {
     }
   }
 
+#if defined(__SSE2__)
+  // Computes the same scores as ComputeScores, but walks one class pruner
+  // at a time and keeps the counts of its CLASSES_PER_CP classes in 16 bit
+  // lanes of a few registers over all the features. The 2-bit count of each
+  // class is moved to the top of its lane by a multiply with a per-lane power
+  // of 2 and shifted down, so a whole pruner vector is unpacked with wide
+  // operations. Counts are only widened to int once per pruner.
+  void ComputeScoresSIMD(const INT_TEMPLATES_STRUCT* int_templates,
+                         int num_features,
+                         const INT_FEATURE_STRUCT* features) {
+    int num_pruners = int_templates->NumClassPruners;
+    int offsets[MAX_NUM_INT_FEATURES];
+    for (int f = 0; f < num_features; ++f) {
+      const INT_FEATURE_STRUCT* feature = &features[f];
+      // Quantize the feature to NUM_CP_BUCKETS*NUM_CP_BUCKETS*NUM_CP_BUCKETS.
+      int x = feature->X * NUM_CP_BUCKETS >> 8;
+      int y = feature->Y * NUM_CP_BUCKETS >> 8;
+      int theta = feature->Theta * NUM_CP_BUCKETS >> 8;
+      offsets[f] = ((x * NUM_CP_BUCKETS + y) * NUM_CP_BUCKETS + theta) *
+          WERDS_PER_CP_VECTOR;
+    }
+    int* class_count = class_count_;
+#if defined(__AVX2__)
+    // Lane i of each 128 bit half holds bits 2i and 2i+1 of a 16 bit chunk.
+    const __m256i multipliers = _mm256_setr_epi16(
+        1 << 14, 1 << 12, 1 << 10, 1 << 8, 1 << 6, 1 << 4, 1 << 2, 1,
+        1 << 14, 1 << 12, 1 << 10, 1 << 8, 1 << 6, 1 << 4, 1 << 2, 1);
+    // Spread chunks 0 and 1 (the first word) and chunks 2 and 3 (the second
+    // word) of the pruner vector over the lanes of the two halves.
+    const __m256i spread_lo = _mm256_setr_epi8(
+        0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1,
+        2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3, 2, 3);
+    const __m256i spread_hi = _mm256_setr_epi8(
+        4, 5, 4, 5, 4, 5, 4, 5, 4, 5, 4, 5, 4, 5, 4, 5,
+        6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7);
+    for (int pruner_set = 0; pruner_set < num_pruners; ++pruner_set) {
+      const uinT32* pruner =
+          &int_templates->ClassPruners[pruner_set]->p[0][0][0][0];
+      __m256i counts_lo = _mm256_setzero_si256();
+      __m256i counts_hi = _mm256_setzero_si256();
+      for (int f = 0; f < num_features; ++f) {
+        __m256i vector = _mm256_broadcastq_epi64(_mm_loadl_epi64(
+            reinterpret_cast<const __m128i *>(pruner + offsets[f])));
+        counts_lo = _mm256_add_epi16(counts_lo, _mm256_srli_epi16(
+            _mm256_mullo_epi16(_mm256_shuffle_epi8(vector, spread_lo),
+                               multipliers), 14));
+        counts_hi = _mm256_add_epi16(counts_hi, _mm256_srli_epi16(
+            _mm256_mullo_epi16(_mm256_shuffle_epi8(vector, spread_hi),
+                               multipliers), 14));
+      }
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(class_count),
+          _mm256_cvtepu16_epi32(_mm256_castsi256_si128(counts_lo)));
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(class_count + 8),
+          _mm256_cvtepu16_epi32(_mm256_extracti128_si256(counts_lo, 1)));
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(class_count + 16),
+          _mm256_cvtepu16_epi32(_mm256_castsi256_si128(counts_hi)));
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(class_count + 24),
+          _mm256_cvtepu16_epi32(_mm256_extracti128_si256(counts_hi, 1)));
+      class_count += CLASSES_PER_CP;
+    }
+#else
+    // Lane i holds bits 2i and 2i+1 of a 16 bit chunk.
+    const __m128i multipliers = _mm_setr_epi16(
+        1 << 14, 1 << 12, 1 << 10, 1 << 8, 1 << 6, 1 << 4, 1 << 2, 1);
+    const __m128i zero = _mm_setzero_si128();
+    for (int pruner_set = 0; pruner_set < num_pruners; ++pruner_set) {
+      const uinT32* pruner =
+          &int_templates->ClassPruners[pruner_set]->p[0][0][0][0];
+      __m128i counts[4];
+      for (int i = 0; i < 4; ++i)
+        counts[i] = zero;
+      for (int f = 0; f < num_features; ++f) {
+        const uinT32* pruner_word_ptr = pruner + offsets[f];
+        for (int word = 0; word < WERDS_PER_CP_VECTOR; ++word) {
+          uinT32 pruner_word = pruner_word_ptr[word];
+          __m128i* word_counts = counts + 2 * word;
+          word_counts[0] = _mm_add_epi16(word_counts[0], _mm_srli_epi16(
+              _mm_mullo_epi16(_mm_set1_epi16(pruner_word & 0xffff),
+                              multipliers), 14));
+          word_counts[1] = _mm_add_epi16(word_counts[1], _mm_srli_epi16(
+              _mm_mullo_epi16(_mm_set1_epi16(pruner_word >> 16),
+                              multipliers), 14));
+        }
+      }
+      for (int i = 0; i < 4; ++i) {
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(class_count),
+                         _mm_unpacklo_epi16(counts[i], zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(class_count + 4),
+                         _mm_unpackhi_epi16(counts[i], zero));
+        class_count += 8;
+      }
+    }
+#endif
+  }
+#endif
+
   // Adjusts the scores according to the number of expected features. Used
   // in lieu of a constant bias, this penalizes classes that expect more
   // features than there are present. Thus an actual c will score higher for c
@@ -247,7 +363,24 @@ class ClassPruner {
   // character class, and scaled by the norm_multiplier.
   void NormalizeForXheight(int norm_multiplier,
                            const uinT8* normalization_factors) {
-    for (int class_id = 0; class_id < max_classes_; class_id++) {
+    int class_id = 0;
+#if defined(__SSE4_1__)
+    if (use_simd_) {
+      const __m128i multiplier = _mm_set1_epi32(norm_multiplier);
+      for (; class_id + 4 <= max_classes_; class_id += 4) {
+        inT32 factors;
+        memcpy(&factors, normalization_factors + class_id, sizeof(factors));
+        __m128i penalty = _mm_srai_epi32(_mm_mullo_epi32(
+            _mm_cvtepu8_epi32(_mm_cvtsi32_si128(factors)), multiplier), 8);
+        _mm_storeu_si128(
+            reinterpret_cast<__m128i *>(norm_count_ + class_id),
+            _mm_sub_epi32(_mm_loadu_si128(
+                reinterpret_cast<const __m128i *>(class_count_ + class_id)),
+                          penalty));
+      }
+    }
+#endif
+    for (; class_id < max_classes_; class_id++) {
       norm_count_[class_id] = class_count_[class_id] -
           ((norm_multiplier * normalization_factors[class_id]) >> 8);
     }
@@ -265,25 +398,41 @@ class ClassPruner {
   // fragments in computing the maximum count.
   void PruneAndSort(int pruning_factor, bool max_of_non_fragments,
                     const UNICHARSET& unicharset) {
-    int max_count = 0;
-    for (int c = 0; c < max_classes_; ++c) {
-      if (norm_count_[c] > max_count &&
-          // This additional check is added in order to ensure that
-          // the classifier will return at least one non-fragmented
-          // character match.
-          // TODO(daria): verify that this helps accuracy and does not
-          // hurt performance.
-          (!max_of_non_fragments || !unicharset.get_fragment(c))) {
-        max_count = norm_count_[c];
-      }
-    }
+    int max_count;
+#if defined(__SSE4_1__)
+    if (use_simd_)
+      max_count = MaxCountSIMD(max_of_non_fragments, unicharset);
+    else
+#endif
+      max_count = MaxCount(max_of_non_fragments, unicharset);
     // Prune Classes.
     pruning_threshold_ = (max_count * pruning_factor) >> 8;
     // Select Classes.
     if (pruning_threshold_ < 1)
       pruning_threshold_ = 1;
     num_classes_ = 0;
-    for (int class_id = 0; class_id < max_classes_; class_id++) {
+    int class_id = 0;
+#if defined(__SSE2__)
+    if (use_simd_) {
+      // Nearly all classes fall below the threshold, so test 4 at a time and
+      // only look at the lanes of groups that have a survivor.
+      const __m128i threshold = _mm_set1_epi32(pruning_threshold_ - 1);
+      for (; class_id + 4 <= max_classes_; class_id += 4) {
+        __m128i counts = _mm_loadu_si128(
+            reinterpret_cast<const __m128i *>(norm_count_ + class_id));
+        int mask = _mm_movemask_ps(
+            _mm_castsi128_ps(_mm_cmpgt_epi32(counts, threshold)));
+        for (int lane = 0; mask != 0; ++lane, mask >>= 1) {
+          if (mask & 1) {
+            ++num_classes_;
+            sort_index_[num_classes_] = class_id + lane;
+            sort_key_[num_classes_] = norm_count_[class_id + lane];
+          }
+        }
+      }
+    }
+#endif
+    for (; class_id < max_classes_; class_id++) {
       if (norm_count_[class_id] >= pruning_threshold_) {
           ++num_classes_;
         sort_index_[num_classes_] = class_id;
@@ -296,6 +445,64 @@ class ClassPruner {
       HeapSort(num_classes_, sort_key_, sort_index_);
   }
 
+  // Returns the maximum of the normalized counts and 0. If
+  // max_of_non_fragments, then fragments are ignored.
+  int MaxCount(bool max_of_non_fragments, const UNICHARSET& unicharset) const {
+    int max_count = 0;
+    for (int c = 0; c < max_classes_; ++c) {
+      if (norm_count_[c] > max_count &&
+          // This additional check is added in order to ensure that
+          // the classifier will return at least one non-fragmented
+          // character match.
+          // TODO(daria): verify that this helps accuracy and does not
+          // hurt performance.
+          (!max_of_non_fragments || !unicharset.get_fragment(c))) {
+        max_count = norm_count_[c];
+      }
+    }
+    return max_count;
+  }
+
+#if defined(__SSE4_1__)
+  // Same as MaxCount. The maximum over all classes is found with wide max
+  // operations and is the answer as soon as one non-fragment reaches it,
+  // which is the common case. Otherwise falls back to MaxCount.
+  int MaxCountSIMD(bool max_of_non_fragments,
+                   const UNICHARSET& unicharset) const {
+    __m128i max4 = _mm_setzero_si128();
+    int c = 0;
+    for (; c + 4 <= max_classes_; c += 4) {
+      max4 = _mm_max_epi32(max4, _mm_loadu_si128(
+          reinterpret_cast<const __m128i *>(norm_count_ + c)));
+    }
+    max4 = _mm_max_epi32(max4, _mm_shuffle_epi32(max4, 0x4e));
+    max4 = _mm_max_epi32(max4, _mm_shuffle_epi32(max4, 0xb1));
+    int max_count = _mm_cvtsi128_si32(max4);
+    for (; c < max_classes_; ++c) {
+      if (norm_count_[c] > max_count)
+        max_count = norm_count_[c];
+    }
+    if (max_count == 0 || !max_of_non_fragments)
+      return max_count;
+    const __m128i max_counts = _mm_set1_epi32(max_count);
+    for (c = 0; c + 4 <= max_classes_; c += 4) {
+      __m128i counts = _mm_loadu_si128(
+          reinterpret_cast<const __m128i *>(norm_count_ + c));
+      int mask = _mm_movemask_ps(
+          _mm_castsi128_ps(_mm_cmpeq_epi32(counts, max_counts)));
+      for (int lane = 0; mask != 0; ++lane, mask >>= 1) {
+        if ((mask & 1) && !unicharset.get_fragment(c + lane))
+          return max_count;
+      }
+    }
+    for (; c < max_classes_; ++c) {
+      if (norm_count_[c] == max_count && !unicharset.get_fragment(c))
+        return max_count;
+    }
+    return MaxCount(max_of_non_fragments, unicharset);
+  }
+#endif
+
   // Prints debug info on the class pruner matches for the pruned classes only.
   void DebugMatch(const Classify& classify,
                   const INT_TEMPLATES_STRUCT* int_templates,
@@ -386,6 +593,8 @@ class ClassPruner {
   int num_features_;
   // Final number of pruned classes.
   int num_classes_;
+  // Whether to use the SIMD kernels, if they were compiled in.
+  bool use_simd_;
 };
 
 /*----------------------------------------------------------------------------
@@ -418,7 +627,7 @@ int Classify::PruneClasses(const INT_TEMPLATES_STRUCT* int_templates,
  **  Exceptions: none
  **  History: Tue Feb 19 10:24:24 MST 1991, RWM, Created.
  */
-  ClassPruner pruner(int_templates->NumClasses);
+  ClassPruner pruner(int_templates->NumClasses, classify_simd_class_pruner);
   // Compute initial match scores for all classes.
   pruner.ComputeScores(int_templates, num_features, features);
   // Adjust match scores for number of expected features.
@@ -488,7 +697,7 @@ void IntegerMatcher::Match(INT_CLASS ClassTemplate,
  **      Exceptions: none
  **      History: Tue Feb 19 16:36:23 MST 1991, RWM, Created.
  */
-  ScratchEvidence *tables = new ScratchEvidence();
+  ScratchEvidence *tables = new ScratchEvidence;
   int Feature;
   int BestMatch;
 
@@ -575,7 +784,7 @@ int IntegerMatcher::FindGoodProtos(
  **      Exceptions: none
  **      History: Tue Mar 12 17:09:26 MST 1991, RWM, Created
  */
-  ScratchEvidence *tables = new ScratchEvidence();
+  ScratchEvidence *tables = new ScratchEvidence;
   int NumGoodProtos = 0;
 
   /* DEBUG opening heading */
@@ -650,7 +859,7 @@ int IntegerMatcher::FindBadFeatures(
  **      Number of bad features in FeatureArray.
  **  History: Tue Mar 12 17:09:26 MST 1991, RWM, Created
  */
-  ScratchEvidence *tables = new ScratchEvidence();
+  ScratchEvidence *tables = new ScratchEvidence;
   int NumBadFeatures = 0;
 
   /* DEBUG opening heading */
@@ -847,9 +1056,23 @@ int IntegerMatcher::UpdateTablesForFeature(
   uinT8 Temp;
   register int *IntPointer;
   int ConfigNum;
-  register inT32 M3;
-  register inT32 A3;
-  register uinT32 A4;
+  int proto_offsets[PROTOS_PER_PROTO_SET >> 1];
+  uinT8 proto_evidences[PROTOS_PER_PROTO_SET >> 1];
+  int num_protos;
+
+#if defined(__SSE4_1__)
+  const __m128i config_spread_lo =
+    _mm_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1);
+  const __m128i config_spread_hi =
+    _mm_setr_epi8(2, 2, 2, 2, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3);
+  const __m128i config_select = _mm_setr_epi8(
+    1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+  const __m128i first_byte = _mm_cvtsi32_si128(0xff);
+  const __m128i index_lo =
+    _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+  const __m128i index_hi =
+    _mm_setr_epi8(16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31);
+#endif
 
   tables->ClearFeatureEvidence(ClassTemplate);
 
@@ -872,6 +1095,8 @@ int IntegerMatcher::UpdateTablesForFeature(
       ProtoWord &= *ProtoMask;
 
       if (ProtoWord != 0) {
+        /* Collect the surviving protos and compute their evidence at once */
+        num_protos = 0;
         proto_byte = ProtoWord & 0xff;
         ProtoWord >>= 8;
         proto_word_offset = 0;
@@ -881,32 +1106,17 @@ int IntegerMatcher::UpdateTablesForFeature(
             ProtoWord >>= 8;
             proto_word_offset += 8;
           }
-          proto_offset = offset_table[proto_byte] + proto_word_offset;
+          proto_offsets[num_protos++] = offset_table[proto_byte] + proto_word_offset;
           proto_byte = next_table[proto_byte];
+        }
+        ComputeProtoEvidence(Feature, &(ProtoSet->Protos[ProtoNum]),
+                             proto_offsets, num_protos, proto_evidences);
+
+        for (int i = 0; i < num_protos; i++) {
+          proto_offset = proto_offsets[i];
+          Evidence = proto_evidences[i];
           Proto = &(ProtoSet->Protos[ProtoNum + proto_offset]);
           ConfigWord = Proto->Configs[0];
-          A3 = (((Proto->A * (Feature->X - 128)) << 1)
-            - (Proto->B * (Feature->Y - 128)) + (Proto->C << 9));
-          M3 =
-            (((inT8) (Feature->Theta - Proto->Angle)) * kIntThetaFudge) << 1;
-
-          if (A3 < 0)
-            A3 = ~A3;
-          if (M3 < 0)
-            M3 = ~M3;
-          A3 >>= mult_trunc_shift_bits_;
-          M3 >>= mult_trunc_shift_bits_;
-          if (A3 > evidence_mult_mask_)
-            A3 = evidence_mult_mask_;
-          if (M3 > evidence_mult_mask_)
-            M3 = evidence_mult_mask_;
-
-          A4 = (A3 * A3) + (M3 * M3);
-          A4 >>= table_trunc_shift_bits_;
-          if (A4 > evidence_table_mask_)
-            Evidence = 0;
-          else
-            Evidence = similarity_evidence_table_[A4];
 
           if (PrintFeatureMatchesOn (Debug))
             IMDebugConfiguration (FeatureNum,
@@ -915,6 +1125,44 @@ int IntegerMatcher::UpdateTablesForFeature(
 
           ConfigWord &= *ConfigMask;
 
+#if defined(__SSE4_1__)
+          /* Raise the evidence of all 32 configs of the proto at once:
+             byte i of the mask is set iff bit i of ConfigWord is set */
+          __m128i evidence = _mm_set1_epi8(Evidence);
+          __m128i config_word = _mm_cvtsi32_si128(ConfigWord);
+          __m128i config_mask_lo = _mm_cmpeq_epi8(
+              _mm_and_si128(_mm_shuffle_epi8(config_word, config_spread_lo),
+                            config_select), config_select);
+          __m128i config_mask_hi = _mm_cmpeq_epi8(
+              _mm_and_si128(_mm_shuffle_epi8(config_word, config_spread_hi),
+                            config_select), config_select);
+          UINT8Pointer = tables->feature_evidence_;
+          _mm_storeu_si128(reinterpret_cast<__m128i *>(UINT8Pointer),
+              _mm_max_epu8(_mm_loadu_si128(reinterpret_cast<__m128i *>(UINT8Pointer)),
+                           _mm_and_si128(evidence, config_mask_lo)));
+          _mm_storeu_si128(reinterpret_cast<__m128i *>(UINT8Pointer + 16),
+              _mm_max_epu8(_mm_loadu_si128(reinterpret_cast<__m128i *>(UINT8Pointer + 16)),
+                           _mm_and_si128(evidence, config_mask_hi)));
+
+          /* Insert into the descending proto row, dropping its last entry:
+             row'[i] = max(row[i], min(Evidence, row[i - 1])) for i < length */
+          UINT8Pointer =
+            &(tables->proto_evidence_[ActualProtoNum + proto_offset][0]);
+          __m128i length = _mm_set1_epi8(
+            ClassTemplate->ProtoLengths[ActualProtoNum + proto_offset]);
+          __m128i row_lo = _mm_loadu_si128(reinterpret_cast<__m128i *>(UINT8Pointer));
+          __m128i row_hi = _mm_loadl_epi64(reinterpret_cast<__m128i *>(UINT8Pointer + 16));
+          __m128i prev_lo = _mm_or_si128(_mm_slli_si128(row_lo, 1), first_byte);
+          __m128i prev_hi = _mm_alignr_epi8(row_hi, row_lo, 15);
+          row_lo = _mm_blendv_epi8(row_lo,
+              _mm_max_epu8(row_lo, _mm_min_epu8(evidence, prev_lo)),
+              _mm_cmpgt_epi8(length, index_lo));
+          row_hi = _mm_blendv_epi8(row_hi,
+              _mm_max_epu8(row_hi, _mm_min_epu8(evidence, prev_hi)),
+              _mm_cmpgt_epi8(length, index_hi));
+          _mm_storeu_si128(reinterpret_cast<__m128i *>(UINT8Pointer), row_lo);
+          _mm_storel_epi64(reinterpret_cast<__m128i *>(UINT8Pointer + 16), row_hi);
+#else
           UINT8Pointer = tables->feature_evidence_ - 8;
           config_byte = 0;
           while (ConfigWord != 0 || config_byte != 0) {
@@ -942,6 +1190,7 @@ int IntegerMatcher::UpdateTablesForFeature(
             else if (Evidence == 0)
               break;
           }
+#endif
         }
       }
     }
@@ -955,7 +1204,25 @@ int IntegerMatcher::UpdateTablesForFeature(
   IntPointer = tables->sum_feature_evidence_;
   UINT8Pointer = tables->feature_evidence_;
   int SumOverConfigs = 0;
-  for (ConfigNum = ClassTemplate->NumConfigs; ConfigNum > 0; ConfigNum--) {
+  ConfigNum = ClassTemplate->NumConfigs;
+#if defined(__SSE4_1__)
+  __m128i sums = _mm_setzero_si128();
+  for (; ConfigNum >= 4; ConfigNum -= 4) {
+    inT32 bytes;
+    memcpy(&bytes, UINT8Pointer, sizeof(bytes));
+    __m128i evidence = _mm_cvtepu8_epi32(_mm_cvtsi32_si128(bytes));
+    __m128i total = _mm_loadu_si128(reinterpret_cast<__m128i *>(IntPointer));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(IntPointer),
+                     _mm_add_epi32(total, evidence));
+    sums = _mm_add_epi32(sums, evidence);
+    UINT8Pointer += 4;
+    IntPointer += 4;
+  }
+  sums = _mm_add_epi32(sums, _mm_shuffle_epi32(sums, _MM_SHUFFLE(1, 0, 3, 2)));
+  sums = _mm_add_epi32(sums, _mm_shuffle_epi32(sums, _MM_SHUFFLE(2, 3, 0, 1)));
+  SumOverConfigs = _mm_cvtsi128_si32(sums);
+#endif
+  for (; ConfigNum > 0; ConfigNum--) {
     int evidence = *UINT8Pointer++;
     SumOverConfigs += evidence;
     *IntPointer++ += evidence;
@@ -964,6 +1231,135 @@ int IntegerMatcher::UpdateTablesForFeature(
 }
 
 
+/*---------------------------------------------------------------------------*/
+void IntegerMatcher::ComputeProtoEvidence(const INT_FEATURE_STRUCT* Feature,
+                                          const INT_PROTO_STRUCT* Protos,
+                                          const int* Offsets,
+                                          int NumProtos,
+                                          uinT8* Evidence) const {
+/*
+ **  Parameters:
+ **      Feature               Pointer to a feature struct
+ **      Protos                Protos of the current proto set half
+ **      Offsets               Indices of the protos to match in Protos
+ **      NumProtos             Number of entries in Offsets
+ **      Evidence              Receives one evidence value per entry
+ **  Operation:
+ **       Computes the similarity of the feature to each proto and looks
+ **       up the resulting evidence. The SIMD paths are bit-exact with the
+ **       scalar one, which handles the remaining protos.
+ **  Return:
+ */
+  int i = 0;
+#if defined(__SSE4_1__)
+  inT32 A4s[PROTOS_PER_PROTO_SET >> 1];
+  /* A, B, C and Angle are the first four bytes of each proto */
+  inT32 words[4];
+  const __m128i x = _mm_set1_epi32(Feature->X - 128);
+  const __m128i y = _mm_set1_epi32(Feature->Y - 128);
+  const __m128i theta = _mm_set1_epi32(Feature->Theta);
+  const __m128i theta_fudge = _mm_set1_epi32(kIntThetaFudge << 1);
+  const __m128i byte_mask = _mm_set1_epi32(0xff);
+  const __m128i mult_mask = _mm_set1_epi32(evidence_mult_mask_);
+  const __m128i mult_shift = _mm_cvtsi32_si128(mult_trunc_shift_bits_);
+  const __m128i table_shift = _mm_cvtsi32_si128(table_trunc_shift_bits_);
+#if defined(__AVX2__)
+  const __m256i x8 = _mm256_set1_epi32(Feature->X - 128);
+  const __m256i y8 = _mm256_set1_epi32(Feature->Y - 128);
+  const __m256i theta8 = _mm256_set1_epi32(Feature->Theta);
+  const __m256i theta_fudge8 = _mm256_set1_epi32(kIntThetaFudge << 1);
+  const __m256i byte_mask8 = _mm256_set1_epi32(0xff);
+  const __m256i mult_mask8 = _mm256_set1_epi32(evidence_mult_mask_);
+  const __m256i proto_size8 = _mm256_set1_epi32(sizeof(INT_PROTO_STRUCT));
+  for (; i + 8 <= NumProtos; i += 8) {
+    __m256i offsets = _mm256_mullo_epi32(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(Offsets + i)),
+        proto_size8);
+    __m256i w = _mm256_i32gather_epi32(
+        reinterpret_cast<const int *>(Protos), offsets, 1);
+    __m256i a = _mm256_srai_epi32(_mm256_slli_epi32(w, 24), 24);
+    __m256i b = _mm256_and_si256(_mm256_srli_epi32(w, 8), byte_mask8);
+    __m256i c = _mm256_srai_epi32(_mm256_slli_epi32(w, 8), 24);
+    __m256i angle = _mm256_srli_epi32(w, 24);
+    __m256i a3 = _mm256_add_epi32(
+        _mm256_sub_epi32(_mm256_slli_epi32(_mm256_mullo_epi32(a, x8), 1),
+                         _mm256_mullo_epi32(b, y8)),
+        _mm256_slli_epi32(c, 9));
+    __m256i m3 = _mm256_srai_epi32(
+        _mm256_slli_epi32(_mm256_sub_epi32(theta8, angle), 24), 24);
+    m3 = _mm256_mullo_epi32(m3, theta_fudge8);
+    a3 = _mm256_xor_si256(a3, _mm256_srai_epi32(a3, 31));
+    m3 = _mm256_xor_si256(m3, _mm256_srai_epi32(m3, 31));
+    a3 = _mm256_min_epi32(_mm256_sra_epi32(a3, mult_shift), mult_mask8);
+    m3 = _mm256_min_epi32(_mm256_sra_epi32(m3, mult_shift), mult_mask8);
+    __m256i a4 = _mm256_add_epi32(_mm256_mullo_epi32(a3, a3),
+                                  _mm256_mullo_epi32(m3, m3));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(A4s + i),
+                        _mm256_srl_epi32(a4, table_shift));
+  }
+#endif
+  for (; i + 4 <= NumProtos; i += 4) {
+    for (int j = 0; j < 4; j++)
+      memcpy(&words[j], &Protos[Offsets[i + j]], sizeof(words[j]));
+    __m128i w = _mm_loadu_si128(reinterpret_cast<__m128i *>(words));
+    __m128i a = _mm_srai_epi32(_mm_slli_epi32(w, 24), 24);
+    __m128i b = _mm_and_si128(_mm_srli_epi32(w, 8), byte_mask);
+    __m128i c = _mm_srai_epi32(_mm_slli_epi32(w, 8), 24);
+    __m128i angle = _mm_srli_epi32(w, 24);
+    /* A3 = ((A * (X - 128)) << 1) - B * (Y - 128) + (C << 9) */
+    __m128i a3 = _mm_add_epi32(
+        _mm_sub_epi32(_mm_slli_epi32(_mm_mullo_epi32(a, x), 1),
+                      _mm_mullo_epi32(b, y)),
+        _mm_slli_epi32(c, 9));
+    /* M3 = ((inT8) (Theta - Angle) * kIntThetaFudge) << 1 */
+    __m128i m3 = _mm_srai_epi32(
+        _mm_slli_epi32(_mm_sub_epi32(theta, angle), 24), 24);
+    m3 = _mm_mullo_epi32(m3, theta_fudge);
+    /* Negative values are complemented, not negated */
+    a3 = _mm_xor_si128(a3, _mm_srai_epi32(a3, 31));
+    m3 = _mm_xor_si128(m3, _mm_srai_epi32(m3, 31));
+    a3 = _mm_min_epi32(_mm_sra_epi32(a3, mult_shift), mult_mask);
+    m3 = _mm_min_epi32(_mm_sra_epi32(m3, mult_shift), mult_mask);
+    __m128i a4 = _mm_add_epi32(_mm_mullo_epi32(a3, a3),
+                               _mm_mullo_epi32(m3, m3));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(A4s + i),
+                     _mm_srl_epi32(a4, table_shift));
+  }
+  for (int j = 0; j < i; j++) {
+    if (static_cast<uinT32>(A4s[j]) > evidence_table_mask_)
+      Evidence[j] = 0;
+    else
+      Evidence[j] = similarity_evidence_table_[A4s[j]];
+  }
+#endif
+  for (; i < NumProtos; i++) {
+    const INT_PROTO_STRUCT* Proto = &Protos[Offsets[i]];
+    inT32 A3 = (((Proto->A * (Feature->X - 128)) << 1)
+      - (Proto->B * (Feature->Y - 128)) + (Proto->C << 9));
+    inT32 M3 =
+      (((inT8) (Feature->Theta - Proto->Angle)) * kIntThetaFudge) << 1;
+
+    if (A3 < 0)
+      A3 = ~A3;
+    if (M3 < 0)
+      M3 = ~M3;
+    A3 >>= mult_trunc_shift_bits_;
+    M3 >>= mult_trunc_shift_bits_;
+    if (A3 > evidence_mult_mask_)
+      A3 = evidence_mult_mask_;
+    if (M3 > evidence_mult_mask_)
+      M3 = evidence_mult_mask_;
+
+    uinT32 A4 = (A3 * A3) + (M3 * M3);
+    A4 >>= table_trunc_shift_bits_;
+    if (A4 > evidence_table_mask_)
+      Evidence[i] = 0;
+    else
+      Evidence[i] = similarity_evidence_table_[A4];
+  }
+}
+
+
 /*---------------------------------------------------------------------------*/
 #ifndef GRAPHICS_DISABLED
 void IntegerMatcher::DebugFeatureProtoError(
@@ -1143,7 +1539,7 @@ void IntegerMatcher::DisplayFeatureDebugInfo(
     int AdaptFeatureThreshold,
     int Debug,
     bool SeparateDebugWindows) {
-  ScratchEvidence *tables = new ScratchEvidence();
+  ScratchEvidence *tables = new ScratchEvidence;
 
   tables->Clear(ClassTemplate);
 
@@ -1202,8 +1598,19 @@ void ScratchEvidence::UpdateSumOfProtoEvidences(
          ((ProtoNum < PROTOS_PER_PROTO_SET) && (ActualProtoNum < NumProtos));
          ProtoNum++, ActualProtoNum++) {
       int temp = 0;
+#if defined(__SSE2__)
+      // Entries past the proto length are still zero from Clear(), so the
+      // whole row can be summed.
+      const uinT8 *row = proto_evidence_[ActualProtoNum];
+      __m128i zero = _mm_setzero_si128();
+      __m128i sad = _mm_add_epi64(
+          _mm_sad_epu8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(row)), zero),
+          _mm_sad_epu8(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(row + 16)), zero));
+      temp = _mm_cvtsi128_si32(sad) + _mm_extract_epi16(sad, 4);
+#else
       for (int i = 0; i < ClassTemplate->ProtoLengths[ActualProtoNum]; i++)
         temp += proto_evidence_[ActualProtoNum] [i];
+#endif
 
       ConfigWord = ProtoSet->Protos[ProtoNum].Configs[0];
       ConfigWord &= *ConfigMask;
@@ -153,6 +153,14 @@ class IntegerMatcher {
       ScratchEvidence *evidence,
       int Debug);
 
+  // Computes the evidence of Feature for each proto Protos[Offsets[i]],
+  // 0 <= i < NumProtos <= PROTOS_PER_PROTO_SET / 2.
+  void ComputeProtoEvidence(const INT_FEATURE_STRUCT* Feature,
+                            const INT_PROTO_STRUCT* Protos,
+                            const int* Offsets,
+                            int NumProtos,
+                            uinT8* Evidence) const;
+
   int FindBestMatch(INT_CLASS ClassTemplate,
                     const ScratchEvidence &tables,
                     INT_RESULT Result);
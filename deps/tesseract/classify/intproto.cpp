@@ -707,6 +707,7 @@ INT_CLASS NewIntClass(int MaxNumProtos, int MaxNumConfigs) {
 
   Class->NumProtos = 0;
   Class->NumConfigs = 0;
+  Class->font_set_id = -1;  // Adapted classes have no font set.
 
   for (i = 0; i < Class->NumProtoSets; i++) {
     /* allocate space for a proto set, install in class, and initialize */
@@ -1196,7 +1197,9 @@ void Classify::WriteIntTemplates(FILE *File, INT_TEMPLATES Templates,
     /* first write out the high level struct for the class */
     fwrite(&Class->NumProtos, sizeof(Class->NumProtos), 1, File);
     fwrite(&Class->NumProtoSets, sizeof(Class->NumProtoSets), 1, File);
-    ASSERT_HOST(Class->NumConfigs == this->fontset_table_.get(Class->font_set_id).size);
+    ASSERT_HOST(Class->font_set_id < 0 ||
+                Class->NumConfigs ==
+                this->fontset_table_.get(Class->font_set_id).size);
     fwrite(&Class->NumConfigs, sizeof(Class->NumConfigs), 1, File);
     for (j = 0; j < Class->NumConfigs; ++j) {
       fwrite(&Class->ConfigLengths[j], sizeof(uinT16), 1, File);
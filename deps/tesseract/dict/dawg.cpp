@@ -40,6 +40,9 @@
 #include "strngs.h"
 #include "tprintf.h"
 
+BOOL_VAR(dawg_lookup_tables, true,
+         "Search squished dawgs with their lookup tables");
+
 /*----------------------------------------------------------------------
               F u n c t i o n s   f o r   D a w g
 ----------------------------------------------------------------------*/
@@ -178,38 +181,94 @@ void Dawg::init(DawgType type, const STRING &lang,
          F u n c t i o n s   f o r   S q u i s h e d    D a w g
 ----------------------------------------------------------------------*/
 
-SquishedDawg::~SquishedDawg() { memfree(edges_); }
+SquishedDawg::~SquishedDawg() {
+  memfree(edges_);
+  delete [] edge_keys_;
+  delete [] root_edges_;
+}
 
 EDGE_REF SquishedDawg::edge_char_of(NODE_REF node,
                                     UNICHAR_ID unichar_id,
                                     bool word_end) const {
+  if (!dawg_lookup_tables) return search_edges(node, unichar_id, word_end);
+  if (node == 0) {  // table lookup
+    if (unichar_id < 0 || unichar_id >= unicharset_size_) return NO_EDGE;
+    inT32 edge = root_edges_[2 * unichar_id + word_end];
+    return edge >= 0 ? edge : NO_EDGE;
+  }
+  if (node == NO_EDGE) return NO_EDGE;
+  // Linear search. Letters are compared shifted, so the flags in the low
+  // bits only need to be masked off once for the wanted key.
+  const uinT32 *key = edge_keys_ + node;
+  if (*key == kEmptyEdgeKey) return NO_EDGE;
+  uinT32 wanted = static_cast<uinT32>(unichar_id) << kKeyLetterShift;
+  uinT32 mask = ~kLastEdgeKeyFlag;
+  if (word_end) {
+    wanted |= kWordEndKeyFlag;
+  } else {
+    mask &= ~kWordEndKeyFlag;
+  }
+  do {
+    if ((*key & mask) == wanted) return key - edge_keys_;
+  } while (!(*key++ & kLastEdgeKeyFlag));
+  return NO_EDGE;  // not found
+}
+
+EDGE_REF SquishedDawg::root_edge_char_of(UNICHAR_ID unichar_id,
+                                         bool word_end) const {
+  EDGE_REF start = 0;
+  EDGE_REF end = num_forward_edges_in_node0 - 1;
+  while (start <= end) {  // binary search
+    EDGE_REF edge = (start + end) >> 1;  // (start + end) / 2
+    int compare = given_greater_than_edge_rec(NO_EDGE, word_end,
+                                              unichar_id, edges_[edge]);
+    if (compare == 0) {  // given == vec[k]
+      return edge;
+    } else if (compare == 1) {  // given > vec[k]
+      start = edge + 1;
+    } else {  // given < vec[k]
+      end = edge - 1;
+    }
+  }
+  return NO_EDGE;
+}
+
+EDGE_REF SquishedDawg::search_edges(NODE_REF node,
+                                    UNICHAR_ID unichar_id,
+                                    bool word_end) const {
+  if (node == 0) return root_edge_char_of(unichar_id, word_end);
   EDGE_REF edge = node;
-  if (node == 0) {  // binary search
-    EDGE_REF start = 0;
-    EDGE_REF end = num_forward_edges_in_node0 - 1;
-    int compare;
-    while (start <= end) {
-      edge = (start + end) >> 1;  // (start + end) / 2
-      compare = given_greater_than_edge_rec(NO_EDGE, word_end,
-                                            unichar_id, edges_[edge]);
-      if (compare == 0) {  // given == vec[k]
-        return edge;
-      } else if (compare == 1) {  // given > vec[k]
-        start = edge + 1;
-      } else {  // given < vec[k]
-        end = edge - 1;
-      }
+  if (edge != NO_EDGE && edge_occupied(edge)) {
+    do {
+      if ((unichar_id_from_edge_rec(edges_[edge]) == unichar_id) &&
+          (!word_end || end_of_word_from_edge_rec(edges_[edge])))
+        return (edge);
+    } while (!last_edge(edge++));
+  }
+  return NO_EDGE;  // not found
+}
+
+void SquishedDawg::build_lookup_tables() {
+  edge_keys_ = new uinT32[num_edges_];
+  for (int edge = 0; edge < num_edges_; ++edge) {
+    if (!edge_occupied(edge)) {
+      edge_keys_[edge] = kEmptyEdgeKey;
+      continue;
     }
-  } else {  // linear search
-    if (edge != NO_EDGE && edge_occupied(edge)) {
-      do {
-        if ((unichar_id_from_edge_rec(edges_[edge]) == unichar_id) &&
-            (!word_end || end_of_word_from_edge_rec(edges_[edge])))
-          return (edge);
-      } while (!last_edge(edge++));
+    edge_keys_[edge] = static_cast<uinT32>(edge_letter(edge)) <<
+        kKeyLetterShift;
+    if (end_of_word(edge)) edge_keys_[edge] |= kWordEndKeyFlag;
+    if (last_edge(edge)) edge_keys_[edge] |= kLastEdgeKeyFlag;
+  }
+  // The binary search is run for every id here, so the table returns the
+  // same edge as the search would when a letter has more than one edge.
+  root_edges_ = new inT32[2 * unicharset_size_];
+  for (int id = 0; id < unicharset_size_; ++id) {
+    for (int word_end = 0; word_end < 2; ++word_end) {
+      EDGE_REF edge = root_edge_char_of(id, word_end);
+      root_edges_[2 * id + word_end] = edge == NO_EDGE ? -1 : edge;
     }
   }
-  return (NO_EDGE);  // not found
 }
 
 inT32 SquishedDawg::num_forward_edges(NODE_REF node) const {
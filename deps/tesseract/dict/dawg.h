@@ -44,6 +44,9 @@
 #define NO_EDGE                (inT64) 0xffffffffffffffffll
 #endif /*__GNUC__*/
 
+extern BOOL_VAR_H(dawg_lookup_tables, true,
+                  "Search squished dawgs with their lookup tables");
+
 /*----------------------------------------------------------------------
               T y p e s
 ----------------------------------------------------------------------*/
@@ -348,6 +351,9 @@ class DawgInfoVector : public GenericVector<DawgInfo> {
 /// The underlying representation of the nodes and edges in SquishedDawg
 /// is stored as a contiguous EDGE_ARRAY (read from file or given as an
 /// argument to the constructor).
+/// For the searches in edge_char_of() a compact copy of the letters and
+/// flags of the edges and a table with the edges out of the root node
+/// indexed by unichar id are built once the edges are known.
 //
 class SquishedDawg : public Dawg {
  public:
@@ -355,6 +361,7 @@ class SquishedDawg : public Dawg {
                PermuterType perm, int debug_level) {
     read_squished_dawg(file, type, lang, perm, debug_level);
     num_forward_edges_in_node0 = num_forward_edges(0);
+    build_lookup_tables();
   }
   SquishedDawg(const char* filename, DawgType type,
                const STRING &lang, PermuterType perm, int debug_level) {
@@ -365,6 +372,7 @@ class SquishedDawg : public Dawg {
     }
     read_squished_dawg(file, type, lang, perm, debug_level);
     num_forward_edges_in_node0 = num_forward_edges(0);
+    build_lookup_tables();
     fclose(file);
   }
   SquishedDawg(EDGE_ARRAY edges, int num_edges, DawgType type,
@@ -373,6 +381,7 @@ class SquishedDawg : public Dawg {
     edges_(edges), num_edges_(num_edges) {
     init(type, lang, perm, unicharset_size, debug_level);
     num_forward_edges_in_node0 = num_forward_edges(0);
+    build_lookup_tables();
     if (debug_level > 3) print_all("SquishedDawg:");
   }
   ~SquishedDawg();
@@ -485,11 +494,33 @@ class SquishedDawg : public Dawg {
   /// Constructs a mapping from the memory node indices to disk node indices.
   NODE_MAP build_node_map(inT32 *num_nodes) const;
 
+  /// Fills edge_keys_ and root_edges_ from edges_.
+  void build_lookup_tables();
+  /// Searches node 0 like edge_char_of() did before root_edges_ existed.
+  EDGE_REF root_edge_char_of(UNICHAR_ID unichar_id, bool word_end) const;
+  /// Searches edges_ like edge_char_of() did before the lookup tables
+  /// existed. Used when dawg_lookup_tables is false.
+  EDGE_REF search_edges(NODE_REF node, UNICHAR_ID unichar_id,
+                        bool word_end) const;
+
+  /// Values of edge_keys_ entries.
+  static const uinT32 kLastEdgeKeyFlag = 1;
+  static const uinT32 kWordEndKeyFlag = 2;
+  static const int kKeyLetterShift = 2;
+  static const uinT32 kEmptyEdgeKey = 0xffffffff;
 
   // Member variables.
   EDGE_ARRAY edges_;
   int num_edges_;
   int num_forward_edges_in_node0;
+  /// For each edge: its unichar id shifted by kKeyLetterShift, or'ed with
+  /// kWordEndKeyFlag and kLastEdgeKeyFlag, or kEmptyEdgeKey if the edge is
+  /// not occupied. Scanning these is half the memory traffic of scanning
+  /// edges_ and needs no masking.
+  uinT32 *edge_keys_;
+  /// For each unichar id, the edge out of node 0 found for it when word_end
+  /// is false (at 2 * id) and true (at 2 * id + 1), or -1 if there is none.
+  inT32 *root_edges_;
 };
 
 }  // namespace tesseract
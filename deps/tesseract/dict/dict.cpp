@@ -19,6 +19,7 @@
 #include <stdio.h>
 
 #include "dict.h"
+#include "object_cache.h"
 #include "unicodes.h"
 
 #ifdef _MSC_VER
@@ -30,6 +31,27 @@ namespace tesseract {
 
 class Image;
 
+// Squished dawgs are never modified once read, so engines that load them
+// from the same traineddata file share a single copy.
+static ObjectCache<Dawg> *dawg_cache = new ObjectCache<Dawg>;
+
+// Returns the squished dawg stored in the given component of the traineddata
+// file open in tessdata_manager, or NULL if the file has no such component.
+static Dawg *LoadSharedDawg(TessdataManager *tessdata_manager,
+                            const STRING &data_file_prefix,
+                            TessdataType tessdata_type, DawgType type,
+                            const STRING &lang, PermuterType perm,
+                            int debug_level) {
+  STRING id = data_file_prefix;
+  id += kTessdataFileSuffixes[tessdata_type];
+  Dawg *dawg = dawg_cache->Get(id);
+  if (dawg != NULL || !tessdata_manager->SeekToStart(tessdata_type))
+    return dawg;
+  return dawg_cache->Add(id,
+                         new SquishedDawg(tessdata_manager->GetDataFilePtr(),
+                                          type, lang, perm, debug_level));
+}
+
 Dict::Dict(Image* image_ptr)
     : letter_is_okay_(&tesseract::Dict::def_letter_is_okay),
       probability_in_context_(&tesseract::Dict::def_probability_in_context),
@@ -229,42 +251,47 @@ void Dict::Load() {
 
   TessdataManager &tessdata_manager =
     getImage()->getCCUtil()->tessdata_manager;
+  const STRING &prefix = getImage()->getCCUtil()->language_data_path_prefix;
+  Dawg *dawg;
 
   // Load dawgs_.
-  if (load_punc_dawg && tessdata_manager.SeekToStart(TESSDATA_PUNC_DAWG)) {
-    punc_dawg_ = new SquishedDawg(tessdata_manager.GetDataFilePtr(),
-                                  DAWG_TYPE_PUNCTUATION, lang, PUNC_PERM,
-                                  dawg_debug_level);
+  if (load_punc_dawg &&
+      (punc_dawg_ = LoadSharedDawg(&tessdata_manager, prefix,
+                                   TESSDATA_PUNC_DAWG, DAWG_TYPE_PUNCTUATION,
+                                   lang, PUNC_PERM, dawg_debug_level))) {
     dawgs_ += punc_dawg_;
   }
-  if (load_system_dawg && tessdata_manager.SeekToStart(TESSDATA_SYSTEM_DAWG)) {
-    dawgs_ += new SquishedDawg(tessdata_manager.GetDataFilePtr(),
-                               DAWG_TYPE_WORD, lang, SYSTEM_DAWG_PERM,
-                               dawg_debug_level);
-  }
-  if (load_number_dawg && tessdata_manager.SeekToStart(TESSDATA_NUMBER_DAWG)) {
-    dawgs_ +=
-      new SquishedDawg(tessdata_manager.GetDataFilePtr(),
-                       DAWG_TYPE_NUMBER, lang, NUMBER_PERM, dawg_debug_level);
-  }
-  if (load_bigram_dawg && tessdata_manager.SeekToStart(TESSDATA_BIGRAM_DAWG)) {
-    bigram_dawg_ = new SquishedDawg(tessdata_manager.GetDataFilePtr(),
-                                    DAWG_TYPE_WORD, // doesn't actually matter.
-                                    lang,
-                                    COMPOUND_PERM,  // doesn't actually matter.
-                                    dawg_debug_level);
-  }
-  if (load_freq_dawg && tessdata_manager.SeekToStart(TESSDATA_FREQ_DAWG)) {
-    freq_dawg_ = new SquishedDawg(tessdata_manager.GetDataFilePtr(),
-                                  DAWG_TYPE_WORD, lang, FREQ_DAWG_PERM,
+  if (load_system_dawg &&
+      (dawg = LoadSharedDawg(&tessdata_manager, prefix, TESSDATA_SYSTEM_DAWG,
+                             DAWG_TYPE_WORD, lang, SYSTEM_DAWG_PERM,
+                             dawg_debug_level))) {
+    dawgs_ += dawg;
+  }
+  if (load_number_dawg &&
+      (dawg = LoadSharedDawg(&tessdata_manager, prefix, TESSDATA_NUMBER_DAWG,
+                             DAWG_TYPE_NUMBER, lang, NUMBER_PERM,
+                             dawg_debug_level))) {
+    dawgs_ += dawg;
+  }
+  if (load_bigram_dawg) {
+    bigram_dawg_ = LoadSharedDawg(&tessdata_manager, prefix,
+                                  TESSDATA_BIGRAM_DAWG,
+                                  DAWG_TYPE_WORD, // doesn't actually matter.
+                                  lang,
+                                  COMPOUND_PERM,  // doesn't actually matter.
                                   dawg_debug_level);
+  }
+  if (load_freq_dawg &&
+      (freq_dawg_ = LoadSharedDawg(&tessdata_manager, prefix,
+                                   TESSDATA_FREQ_DAWG, DAWG_TYPE_WORD, lang,
+                                   FREQ_DAWG_PERM, dawg_debug_level))) {
     dawgs_ += freq_dawg_;
   }
   if (load_unambig_dawg &&
-      tessdata_manager.SeekToStart(TESSDATA_UNAMBIG_DAWG)) {
-    unambig_dawg_ = new SquishedDawg(tessdata_manager.GetDataFilePtr(),
-                                     DAWG_TYPE_WORD, lang, SYSTEM_DAWG_PERM,
-                                     dawg_debug_level);
+      (unambig_dawg_ = LoadSharedDawg(&tessdata_manager, prefix,
+                                      TESSDATA_UNAMBIG_DAWG, DAWG_TYPE_WORD,
+                                      lang, SYSTEM_DAWG_PERM,
+                                      dawg_debug_level))) {
     dawgs_ += unambig_dawg_;
   }
 
@@ -335,10 +362,15 @@ void Dict::Load() {
 void Dict::End() {
   if (dawgs_.length() == 0)
     return;  // Not safe to call twice.
-  dawgs_.delete_data_pointers();
+  // Shared dawgs are only released here, the cache deletes them once the
+  // last engine using them is done.
+  for (int i = 0; i < dawgs_.length(); ++i) {
+    if (!dawg_cache->Free(dawgs_[i])) delete dawgs_[i];
+  }
   successors_.delete_data_pointers();
   dawgs_.clear();
-  delete bigram_dawg_;
+  if (!dawg_cache->Free(bigram_dawg_)) delete bigram_dawg_;
+  bigram_dawg_ = NULL;
   successors_.clear();
   document_words_ = NULL;
   max_fixed_length_dawgs_wdlen_ = -1;
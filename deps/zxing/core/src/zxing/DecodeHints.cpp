@@ -124,6 +124,30 @@ bool DecodeHints::getTryHarder() const {
   return (hints & TRYHARDER_HINT) != 0;
 }
 
+void DecodeHints::setParallelRows(bool toset) {
+  if (toset) {
+    hints |= PARALLEL_ROWS_HINT;
+  } else {
+    hints &= ~PARALLEL_ROWS_HINT;
+  }
+}
+
+bool DecodeHints::getParallelRows() const {
+  return (hints & PARALLEL_ROWS_HINT) != 0;
+}
+
+void DecodeHints::setAdaptiveOrder(bool toset) {
+  if (toset) {
+    hints |= ADAPTIVE_ORDER_HINT;
+  } else {
+    hints &= ~ADAPTIVE_ORDER_HINT;
+  }
+}
+
+bool DecodeHints::getAdaptiveOrder() const {
+  return (hints & ADAPTIVE_ORDER_HINT) != 0;
+}
+
 void DecodeHints::setResultPointCallback(Ref<ResultPointCallback> const& _callback) {
   callback = _callback;
 }
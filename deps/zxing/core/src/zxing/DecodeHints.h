@@ -59,6 +59,8 @@ class DecodeHints {
   // static const DecodeHintType ASSUME_CODE_39_CHECK_DIGIT = 1 << 28;
   static const DecodeHintType  ASSUME_GS1 = 1 << 27;
   // static const DecodeHintType NEED_RESULT_POINT_CALLBACK = 1 << 26;
+  static const DecodeHintType PARALLEL_ROWS_HINT = 1 << 25;
+  static const DecodeHintType ADAPTIVE_ORDER_HINT = 1 << 24;
   
   static const DecodeHints PRODUCT_HINT;
   static const DecodeHints ONED_HINT;
@@ -73,6 +75,10 @@ class DecodeHints {
   void clear() {hints=0;}
   void setTryHarder(bool toset);
   bool getTryHarder() const;
+  void setParallelRows(bool toset);
+  bool getParallelRows() const;
+  void setAdaptiveOrder(bool toset);
+  bool getAdaptiveOrder() const;
 
   void setResultPointCallback(Ref<ResultPointCallback> const&);
   Ref<ResultPointCallback> getResultPointCallback() const;
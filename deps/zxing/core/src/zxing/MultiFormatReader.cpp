@@ -24,6 +24,7 @@
 #include <zxing/oned/MultiFormatUPCEANReader.h>
 #include <zxing/oned/MultiFormatOneDReader.h>
 #include <zxing/ReaderException.h>
+#include <algorithm>
 
 using zxing::Ref;
 using zxing::Result;
@@ -32,8 +33,39 @@ using zxing::MultiFormatReader;
 // VC++
 using zxing::DecodeHints;
 using zxing::BinaryBitmap;
+using zxing::DecodeHintType;
 
-MultiFormatReader::MultiFormatReader() {}
+namespace {
+
+const DecodeHintType ONED_FORMATS =
+  DecodeHints::CODE_39_HINT |
+  DecodeHints::CODE_93_HINT |
+  DecodeHints::CODE_128_HINT |
+  DecodeHints::ITF_HINT |
+  DecodeHints::CODABAR_HINT |
+  DecodeHints::UPC_A_HINT |
+  DecodeHints::UPC_E_HINT |
+  DecodeHints::EAN_13_HINT |
+  DecodeHints::EAN_8_HINT |
+  DecodeHints::RSS_14_HINT |
+  DecodeHints::RSS_EXPANDED_HINT;
+
+// Orders reader indices by descending score.
+class ScoreGreater {
+public:
+  ScoreGreater(std::vector<unsigned int> const& scores) : scores_(scores) {}
+  bool operator()(size_t a, size_t b) const {
+    return scores_[a] > scores_[b];
+  }
+private:
+  std::vector<unsigned int> const& scores_;
+};
+
+}
+
+MultiFormatReader::MultiFormatReader() {
+  resetHits();
+}
   
 Ref<Result> MultiFormatReader::decode(Ref<BinaryBitmap> image) {
   setHints(DecodeHints::DEFAULT_HINT);
@@ -56,6 +88,7 @@ Ref<Result> MultiFormatReader::decodeWithState(Ref<BinaryBitmap> image) {
 void MultiFormatReader::setHints(DecodeHints hints) {
   hints_ = hints;
   readers_.clear();
+  readerFormats_.clear();
   bool tryHarder = hints.getTryHarder();
 
   bool addOneDReader = hints.containsFormat(BarcodeFormat::UPC_E) ||
@@ -71,19 +104,19 @@ void MultiFormatReader::setHints(DecodeHints hints) {
     hints.containsFormat(BarcodeFormat::RSS_14) ||
     hints.containsFormat(BarcodeFormat::RSS_EXPANDED);
   if (addOneDReader && !tryHarder) {
-    readers_.push_back(Ref<Reader>(new zxing::oned::MultiFormatOneDReader(hints)));
+    addReader(Ref<Reader>(new zxing::oned::MultiFormatOneDReader(hints)), ONED_FORMATS);
   }
   if (hints.containsFormat(BarcodeFormat::QR_CODE)) {
-    readers_.push_back(Ref<Reader>(new zxing::qrcode::QRCodeReader()));
+    addReader(Ref<Reader>(new zxing::qrcode::QRCodeReader()), DecodeHints::QR_CODE_HINT);
   }
   if (hints.containsFormat(BarcodeFormat::DATA_MATRIX)) {
-    readers_.push_back(Ref<Reader>(new zxing::datamatrix::DataMatrixReader()));
+    addReader(Ref<Reader>(new zxing::datamatrix::DataMatrixReader()), DecodeHints::DATA_MATRIX_HINT);
   }
   if (hints.containsFormat(BarcodeFormat::AZTEC)) {
-    readers_.push_back(Ref<Reader>(new zxing::aztec::AztecReader()));
+    addReader(Ref<Reader>(new zxing::aztec::AztecReader()), DecodeHints::AZTEC_HINT);
   }
   if (hints.containsFormat(BarcodeFormat::PDF_417)) {
-    readers_.push_back(Ref<Reader>(new zxing::pdf417::PDF417Reader()));
+    addReader(Ref<Reader>(new zxing::pdf417::PDF417Reader()), DecodeHints::PDF_417_HINT);
   }
   /*
   if (hints.contains(BarcodeFormat.MAXICODE)) {
@@ -91,28 +124,60 @@ void MultiFormatReader::setHints(DecodeHints hints) {
   }
   */
   if (addOneDReader && tryHarder) {
-    readers_.push_back(Ref<Reader>(new zxing::oned::MultiFormatOneDReader(hints)));
+    addReader(Ref<Reader>(new zxing::oned::MultiFormatOneDReader(hints)), ONED_FORMATS);
   }
   if (readers_.size() == 0) {
     if (!tryHarder) {
-      readers_.push_back(Ref<Reader>(new zxing::oned::MultiFormatOneDReader(hints)));
+      addReader(Ref<Reader>(new zxing::oned::MultiFormatOneDReader(hints)), ONED_FORMATS);
     }
-    readers_.push_back(Ref<Reader>(new zxing::qrcode::QRCodeReader()));
-    readers_.push_back(Ref<Reader>(new zxing::datamatrix::DataMatrixReader()));
-    readers_.push_back(Ref<Reader>(new zxing::aztec::AztecReader()));
-    readers_.push_back(Ref<Reader>(new zxing::pdf417::PDF417Reader()));
+    addReader(Ref<Reader>(new zxing::qrcode::QRCodeReader()), DecodeHints::QR_CODE_HINT);
+    addReader(Ref<Reader>(new zxing::datamatrix::DataMatrixReader()), DecodeHints::DATA_MATRIX_HINT);
+    addReader(Ref<Reader>(new zxing::aztec::AztecReader()), DecodeHints::AZTEC_HINT);
+    addReader(Ref<Reader>(new zxing::pdf417::PDF417Reader()), DecodeHints::PDF_417_HINT);
     // readers.add(new MaxiCodeReader());
 
     if (tryHarder) {
-      readers_.push_back(Ref<Reader>(new zxing::oned::MultiFormatOneDReader(hints)));
+      addReader(Ref<Reader>(new zxing::oned::MultiFormatOneDReader(hints)), ONED_FORMATS);
     }
   }
 }
 
+void MultiFormatReader::addReader(Ref<Reader> reader, DecodeHintType formats) {
+  readers_.push_back(reader);
+  readerFormats_.push_back(formats);
+}
+
+unsigned int MultiFormatReader::getHits(BarcodeFormat format) const {
+  return hits_[format];
+}
+
+void MultiFormatReader::resetHits() {
+  std::fill(hits_, hits_ + BarcodeFormat::UPC_EAN_EXTENSION + 1, 0u);
+}
+
 Ref<Result> MultiFormatReader::decodeInternal(Ref<BinaryBitmap> image) {
-  for (unsigned int i = 0; i < readers_.size(); i++) {
+  std::vector<size_t> order(readers_.size());
+  for (size_t i = 0; i < order.size(); i++) {
+    order[i] = i;
+  }
+  if (hints_.getAdaptiveOrder()) {
+    // Try the readers whose formats were found most often first. Ties keep
+    // the default order, so a fresh reader behaves like a non-adaptive one.
+    std::vector<unsigned int> scores(readers_.size(), 0);
+    for (size_t i = 0; i < readers_.size(); i++) {
+      for (int format = 0; format <= BarcodeFormat::UPC_EAN_EXTENSION; format++) {
+        if (readerFormats_[i] & (1u << format)) {
+          scores[i] += hits_[format];
+        }
+      }
+    }
+    std::stable_sort(order.begin(), order.end(), ScoreGreater(scores));
+  }
+  for (unsigned int i = 0; i < order.size(); i++) {
     try {
-      return readers_[i]->decode(image, hints_);
+      Ref<Result> result = readers_[order[i]]->decode(image, hints_);
+      hits_[result->getBarcodeFormat()]++;
+      return result;
     } catch (ReaderException const& re) {
       (void)re;
       // continue
@@ -30,9 +30,14 @@ namespace zxing {
   class MultiFormatReader : public Reader {
   private:
     Ref<Result> decodeInternal(Ref<BinaryBitmap> image);
+    void addReader(Ref<Reader> reader, DecodeHintType formats);
   
     std::vector<Ref<Reader> > readers_;
+    // Formats each entry of readers_ can decode.
+    std::vector<DecodeHintType> readerFormats_;
     DecodeHints hints_;
+    // Number of decoded codes per format. Survives setHints().
+    unsigned int hits_[BarcodeFormat::UPC_EAN_EXTENSION + 1];
 
   public:
     MultiFormatReader();
@@ -41,6 +46,8 @@ namespace zxing {
     Ref<Result> decode(Ref<BinaryBitmap> image, DecodeHints hints);
     Ref<Result> decodeWithState(Ref<BinaryBitmap> image);
     void setHints(DecodeHints hints);
+    unsigned int getHits(BarcodeFormat format) const;
+    void resetHits();
     ~MultiFormatReader();
   };
 }
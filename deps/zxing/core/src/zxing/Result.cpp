@@ -37,6 +37,17 @@ Result::Result(Ref<String> text,
   text_(text), rawBytes_(rawBytes), resultPoints_(resultPoints), format_(format) {
 }
 
+Result::Result(Ref<String> text,
+               ArrayRef<char> rawBytes,
+               ArrayRef< Ref<ResultPoint> > resultPoints,
+               BarcodeFormat format,
+               ArrayRef< ArrayRef<char> > byteSegments,
+               std::string const& ecLevel,
+               std::string const& charset) :
+  text_(text), rawBytes_(rawBytes), resultPoints_(resultPoints), format_(format),
+  byteSegments_(byteSegments), ecLevel_(ecLevel), charset_(charset) {
+}
+
 Result::~Result() {
 }
 
@@ -48,6 +59,26 @@ ArrayRef<char> Result::getRawBytes() {
   return rawBytes_;
 }
 
+ArrayRef< ArrayRef<char> > Result::getByteSegments() {
+  return byteSegments_;
+}
+
+std::string const& Result::getECLevel() const {
+  return ecLevel_;
+}
+
+std::string const& Result::getCharset() const {
+  return charset_;
+}
+
+std::string const& Result::getPayload() const {
+  return payload_;
+}
+
+void Result::setPayload(std::string const& payload) {
+  payload_ = payload;
+}
+
 ArrayRef< Ref<ResultPoint> > const& Result::getResultPoints() const {
   return resultPoints_;
 }
@@ -35,15 +35,34 @@ private:
   ArrayRef<char> rawBytes_;
   ArrayRef< Ref<ResultPoint> > resultPoints_;
   BarcodeFormat format_;
+  ArrayRef< ArrayRef<char> > byteSegments_;
+  std::string ecLevel_;
+  std::string charset_;
+  std::string payload_;
 
 public:
   Result(Ref<String> text,
          ArrayRef<char> rawBytes,
          ArrayRef< Ref<ResultPoint> > resultPoints,
          BarcodeFormat format);
+  Result(Ref<String> text,
+         ArrayRef<char> rawBytes,
+         ArrayRef< Ref<ResultPoint> > resultPoints,
+         BarcodeFormat format,
+         ArrayRef< ArrayRef<char> > byteSegments,
+         std::string const& ecLevel,
+         std::string const& charset);
   ~Result();
   Ref<String> getText();
   ArrayRef<char> getRawBytes();
+  // Undecoded payload bytes of byte mode segments, empty if the format has none.
+  ArrayRef< ArrayRef<char> > getByteSegments();
+  std::string const& getECLevel() const;
+  std::string const& getCharset() const;
+  // Undecoded bytes of all segments in order, empty if the text holds them
+  // unconverted.
+  std::string const& getPayload() const;
+  void setPayload(std::string const& payload);
   ArrayRef< Ref<ResultPoint> > const& getResultPoints() const;
   ArrayRef< Ref<ResultPoint> >& getResultPoints();
   BarcodeFormat getBarcodeFormat() const;
@@ -27,11 +27,13 @@ using namespace zxing;
 DecoderResult::DecoderResult(ArrayRef<char> rawBytes,
                              Ref<String> text,
                              ArrayRef< ArrayRef<char> >& byteSegments,
-                             string const& ecLevel) :
+                             string const& ecLevel,
+                             string const& charset) :
   rawBytes_(rawBytes),
   text_(text),
   byteSegments_(byteSegments),
-  ecLevel_(ecLevel) {}
+  ecLevel_(ecLevel),
+  charset_(charset) {}
 
 DecoderResult::DecoderResult(ArrayRef<char> rawBytes,
                              Ref<String> text)
@@ -44,3 +46,23 @@ ArrayRef<char> DecoderResult::getRawBytes() {
 Ref<String> DecoderResult::getText() {
   return text_;
 }
+
+ArrayRef< ArrayRef<char> > DecoderResult::getByteSegments() {
+  return byteSegments_;
+}
+
+string const& DecoderResult::getECLevel() const {
+  return ecLevel_;
+}
+
+string const& DecoderResult::getCharset() const {
+  return charset_;
+}
+
+string const& DecoderResult::getPayload() const {
+  return payload_;
+}
+
+void DecoderResult::setPayload(string const& payload) {
+  payload_ = payload;
+}
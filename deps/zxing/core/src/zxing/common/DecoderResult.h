@@ -33,17 +33,27 @@ private:
   Ref<String> text_;
   ArrayRef< ArrayRef<char> > byteSegments_;
   std::string ecLevel_;
+  std::string charset_;
+  std::string payload_;
 
 public:
   DecoderResult(ArrayRef<char> rawBytes,
                 Ref<String> text,
                 ArrayRef< ArrayRef<char> >& byteSegments,
-                std::string const& ecLevel);
+                std::string const& ecLevel,
+                std::string const& charset = "");
 
   DecoderResult(ArrayRef<char> rawBytes, Ref<String> text);
 
   ArrayRef<char> getRawBytes();
   Ref<String> getText();
+  ArrayRef< ArrayRef<char> > getByteSegments();
+  std::string const& getECLevel() const;
+  std::string const& getCharset() const;
+  // Undecoded bytes of all segments in order, for formats whose text is
+  // converted from another encoding; empty otherwise.
+  std::string const& getPayload() const;
+  void setPayload(std::string const& payload);
 };
 
 }
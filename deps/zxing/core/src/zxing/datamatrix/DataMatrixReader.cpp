@@ -42,7 +42,8 @@ Ref<Result> DataMatrixReader::decode(Ref<BinaryBitmap> image, DecodeHints hints)
   Ref<DecoderResult> decoderResult(decoder_.decode(detectorResult->getBits()));
 
   Ref<Result> result(
-    new Result(decoderResult->getText(), decoderResult->getRawBytes(), points, BarcodeFormat::DATA_MATRIX));
+    new Result(decoderResult->getText(), decoderResult->getRawBytes(), points, BarcodeFormat::DATA_MATRIX,
+               decoderResult->getByteSegments(), decoderResult->getECLevel(), decoderResult->getCharset()));
 
   return result;
 }
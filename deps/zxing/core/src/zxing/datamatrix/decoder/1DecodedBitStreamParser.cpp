@@ -55,7 +55,7 @@ Ref<DecoderResult> DecodedBitStreamParser::decode(ArrayRef<char> bytes) {
   Ref<BitSource> bits(new BitSource(bytes));
   ostringstream result;
   ostringstream resultTrailer;
-  vector<char> byteSegments;
+  ArrayRef< ArrayRef<char> > byteSegments (0);
   int mode = ASCII_ENCODE;
   do {
     if (mode == ASCII_ENCODE) {
@@ -89,7 +89,7 @@ Ref<DecoderResult> DecodedBitStreamParser::decode(ArrayRef<char> bytes) {
   }
   ArrayRef<char> rawBytes(bytes);
   Ref<String> text(new String(result.str()));
-  return Ref<DecoderResult>(new DecoderResult(rawBytes, text));
+  return Ref<DecoderResult>(new DecoderResult(rawBytes, text, byteSegments, ""));
 }
 
 int DecodedBitStreamParser::decodeAsciiSegment(Ref<BitSource> bits, ostringstream & result,
@@ -381,7 +381,8 @@ void DecodedBitStreamParser::decodeEdifactSegment(Ref<BitSource> bits, ostringst
   } while (bits->available() > 0);
 }
   
-void DecodedBitStreamParser::decodeBase256Segment(Ref<BitSource> bits, ostringstream& result, vector<char> byteSegments) {
+void DecodedBitStreamParser::decodeBase256Segment(Ref<BitSource> bits, ostringstream& result,
+                                                  ArrayRef< ArrayRef<char> >& byteSegments) {
   // Figure out how long the Base 256 Segment is.
   int codewordPosition = 1 + bits->getByteOffset(); // position is 1-indexed
   int d1 = unrandomize255State(bits->readBits(8), codewordPosition++);
@@ -399,7 +400,7 @@ void DecodedBitStreamParser::decodeBase256Segment(Ref<BitSource> bits, ostringst
     throw FormatException("NegativeArraySizeException");
   }
 
-  char* bytes = new char[count];
+  ArrayRef<char> bytes (count);
   for (int i = 0; i < count; i++) {
     // Have seen this particular error in the wild, such as at
     // http://www.bcgen.com/demo/IDAutomationStreamingDataMatrix.aspx?MODE=3&D=Fred&PFMT=3&PT=F&X=0.3&O=0&LM=0.2
@@ -407,9 +408,9 @@ void DecodedBitStreamParser::decodeBase256Segment(Ref<BitSource> bits, ostringst
       throw FormatException("byteSegments");
     }
     bytes[i] = unrandomize255State(bits->readBits(8), codewordPosition++);
-    byteSegments.push_back(bytes[i]);
     result << (char)bytes[i];
   }
+  byteSegments->values().push_back(bytes);
 }
 }
 }
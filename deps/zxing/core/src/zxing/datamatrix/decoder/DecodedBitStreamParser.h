@@ -79,7 +79,7 @@ private:
   /**
    * See ISO 16022:2006, 5.2.9 and Annex B, B.2
    */
-  void decodeBase256Segment(Ref<BitSource> bits, std::ostringstream &result, std::vector<char> byteSegments);
+  void decodeBase256Segment(Ref<BitSource> bits, std::ostringstream &result, ArrayRef< ArrayRef<char> >& byteSegments);
 
   void parseTwoBytes(int firstByte, int secondByte, int* result);
   /**
@@ -133,5 +133,9 @@ Ref<Result> GenericMultipleBarcodeReader::translateResultPoints(Ref<Result> resu
     Ref<ResultPoint> oldPoint = oldResultPoints[i];
     newResultPoints->values().push_back(Ref<ResultPoint>(new ResultPoint(oldPoint->getX() + xOffset, oldPoint->getY() + yOffset)));
   }
-  return Ref<Result>(new Result(result->getText(), result->getRawBytes(), newResultPoints, result->getBarcodeFormat()));
+  Ref<Result> translated(new Result(result->getText(), result->getRawBytes(), newResultPoints,
+                                    result->getBarcodeFormat(), result->getByteSegments(),
+                                    result->getECLevel(), result->getCharset()));
+  translated->setPayload(result->getPayload());
+  return translated;
 }
@@ -39,9 +39,11 @@ std::vector<Ref<Result> > QRCodeMultiReader::decodeMultiple(Ref<BinaryBitmap> im
       ArrayRef< Ref<ResultPoint> > points = detectorResult[i]->getPoints();
       Ref<Result> result = Ref<Result>(new Result(decoderResult->getText(),
       decoderResult->getRawBytes(), 
-      points, BarcodeFormat::QR_CODE));
-      // result->putMetadata(ResultMetadataType.BYTE_SEGMENTS, decoderResult->getByteSegments());
-      // result->putMetadata(ResultMetadataType.ERROR_CORRECTION_LEVEL, decoderResult->getECLevel().toString());
+      points, BarcodeFormat::QR_CODE,
+      decoderResult->getByteSegments(),
+      decoderResult->getECLevel(),
+      decoderResult->getCharset()));
+      result->setPayload(decoderResult->getPayload());
       results.push_back(result);
     } catch (ReaderException const& re) {
       (void)re;
@@ -91,11 +91,10 @@ Ref<Result> ITFReader::decodeRow(int rowNumber, Ref<BitArray> row) {
   decodeMiddle(row, startRange[1], endRange[0], result);
   Ref<String> resultString(new String(result));
 
-  ArrayRef<int> allowedLengths;
   // Java hints stuff missing
-  if (!allowedLengths) {
-    allowedLengths = DEFAULT_ALLOWED_LENGTHS;
-  }
+  // Bind by reference: the shared default must not be retained/released, as
+  // rows may be decoded on several threads at once.
+  ArrayRef<int> const& allowedLengths = DEFAULT_ALLOWED_LENGTHS;
 
   // To avoid false positives with 2D barcodes (and other patterns), make
   // an assumption that the decoded string must be 6, 10 or 14 digits.
@@ -80,6 +80,10 @@ MultiFormatOneDReader::MultiFormatOneDReader(DecodeHints hints) : readers() {
 
 #include <typeinfo>
 
+zxing::oned::OneDReader* MultiFormatOneDReader::createWorker(DecodeHints hints) {
+  return new MultiFormatOneDReader(hints);
+}
+
 Ref<Result> MultiFormatOneDReader::decodeRow(int rowNumber, Ref<BitArray> row) {
   int size = readers.size();
   for (int i = 0; i < size; i++) {
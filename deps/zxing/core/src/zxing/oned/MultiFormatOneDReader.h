@@ -27,6 +27,8 @@ namespace zxing {
 
     private:
       std::vector<Ref<OneDReader> > readers;
+    protected:
+      OneDReader* createWorker(DecodeHints hints);
     public:
       MultiFormatOneDReader(DecodeHints hints);
 
@@ -24,6 +24,14 @@
 #include <limits.h>
 #include <typeinfo>
 #include <algorithm>
+#include <exception>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
 
 using std::vector;
 using zxing::Ref;
@@ -36,6 +44,103 @@ using zxing::BinaryBitmap;
 using zxing::BitArray;
 using zxing::DecodeHints;
 
+namespace {
+
+// Upper bound for the parallel row sampler; more threads than this mostly
+// wait on the binarizer.
+const int MAX_SAMPLER_THREADS = 8;
+// Rows binarized per worker before the batch is scanned.
+const int SAMPLER_ROWS_PER_THREAD = 4;
+
+int onlineProcessors() {
+#ifdef _WIN32
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  return info.dwNumberOfProcessors;
+#else
+  long count = sysconf(_SC_NPROCESSORS_ONLN);
+  return count > 0 ? static_cast<int>(count) : 1;
+#endif
+}
+
+class Mutex {
+public:
+  Mutex() {
+#ifdef _WIN32
+    mutex_ = CreateMutex(0, FALSE, 0);
+#else
+    pthread_mutex_init(&mutex_, 0);
+#endif
+  }
+  ~Mutex() {
+#ifdef _WIN32
+    CloseHandle(mutex_);
+#else
+    pthread_mutex_destroy(&mutex_);
+#endif
+  }
+  void lock() {
+#ifdef _WIN32
+    WaitForSingleObject(mutex_, INFINITE);
+#else
+    pthread_mutex_lock(&mutex_);
+#endif
+  }
+  void unlock() {
+#ifdef _WIN32
+    ReleaseMutex(mutex_);
+#else
+    pthread_mutex_unlock(&mutex_);
+#endif
+  }
+private:
+  Mutex(Mutex const&);
+  Mutex& operator=(Mutex const&);
+#ifdef _WIN32
+  HANDLE mutex_;
+#else
+  pthread_mutex_t mutex_;
+#endif
+};
+
+class Thread {
+public:
+  Thread() : started_(false) {}
+  void start(void* (*func)(void*), void* arg) {
+#ifdef _WIN32
+    thread_ = CreateThread(0, 0, (LPTHREAD_START_ROUTINE) func, arg, 0, 0);
+    started_ = thread_ != 0;
+#else
+    started_ = pthread_create(&thread_, 0, func, arg) == 0;
+#endif
+    if (!started_) {
+      // Out of threads: do the work on the calling thread instead.
+      func(arg);
+    }
+  }
+  void join() {
+    if (!started_) {
+      return;
+    }
+#ifdef _WIN32
+    WaitForSingleObject(thread_, INFINITE);
+    CloseHandle(thread_);
+#else
+    pthread_join(thread_, 0);
+#endif
+    started_ = false;
+  }
+private:
+  bool started_;
+#ifdef _WIN32
+  HANDLE thread_;
+#else
+  pthread_t thread_;
+#endif
+};
+
+}
+
 OneDReader::OneDReader() {}
 
 Ref<Result> OneDReader::decode(Ref<BinaryBitmap> image, DecodeHints hints) {
@@ -67,9 +172,7 @@ Ref<Result> OneDReader::decode(Ref<BinaryBitmap> image, DecodeHints hints) {
 }
 
 Ref<Result> OneDReader::doDecode(Ref<BinaryBitmap> image, DecodeHints hints) {
-  int width = image->getWidth();
   int height = image->getHeight();
-  Ref<BitArray> row(new BitArray(width));
 
   int middle = height >> 1;
   bool tryHarder = hints.getTryHarder();
@@ -83,6 +186,7 @@ Ref<Result> OneDReader::doDecode(Ref<BinaryBitmap> image, DecodeHints hints) {
     maxLines = 15; // 15 rows spaced 1/32 apart is roughly the middle half of the image
   }
 
+  vector<int> rowNumbers;
   for (int x = 0; x < maxLines; x++) {
 
     // Scanning from the middle out. Determine which row we're looking at next:
@@ -103,47 +207,180 @@ Ref<Result> OneDReader::doDecode(Ref<BinaryBitmap> image, DecodeHints hints) {
       // Oops, if we run off the top or bottom, stop
       break;
     }
+    rowNumbers.push_back(rowNumber);
+  }
 
+  if (hints.getParallelRows()) {
+    int threads = std::min(onlineProcessors(), MAX_SAMPLER_THREADS);
+    if (threads > 1 && static_cast<int>(rowNumbers.size()) > threads) {
+      vector<Ref<OneDReader> > readers(1, Ref<OneDReader>(this));
+      for (int t = 1; t < threads; t++) {
+        OneDReader* worker = createWorker(hints);
+        if (!worker) {
+          break;
+        }
+        readers.push_back(Ref<OneDReader>(worker));
+      }
+      if (readers.size() > 1) {
+        return doDecodeParallel(image, readers, rowNumbers);
+      }
+    }
+  }
+
+  Ref<BitArray> row(new BitArray(image->getWidth()));
+  for (size_t i = 0; i < rowNumbers.size(); i++) {
     // Estimate black point for this row and load it:
     try {
-      row = image->getBlackRow(rowNumber, row);
+      row = image->getBlackRow(rowNumbers[i], row);
     } catch (NotFoundException const& ignored) {
       (void)ignored;
       continue;
     }
+    Ref<Result> result = decodeRowBothWays(rowNumbers[i], row);
+    if (result) {
+      return result;
+    }
+  }
+  throw NotFoundException();
+}
+
+Ref<Result> OneDReader::decodeRowBothWays(int rowNumber, Ref<BitArray> row) {
+  int width = row->getSize();
+
+  // While we have the image data in a BitArray, it's fairly cheap to reverse it in place to
+  // handle decoding upside down barcodes.
+  for (int attempt = 0; attempt < 2; attempt++) {
+    if (attempt == 1) {
+      row->reverse(); // reverse the row and continue
+    }
+
+    // Java hints stuff missing
 
-    // While we have the image data in a BitArray, it's fairly cheap to reverse it in place to
-    // handle decoding upside down barcodes.
-    for (int attempt = 0; attempt < 2; attempt++) {
+    try {
+      // Look for a barcode
+      // std::cerr << "rn " << rowNumber << " " << typeid(*this).name() << std::endl;
+      Ref<Result> result = decodeRow(rowNumber, row);
+      // We found our barcode
       if (attempt == 1) {
-        row->reverse(); // reverse the row and continue
+        // But it was upside down, so note that
+        // result.putMetadata(ResultMetadataType.ORIENTATION, new Integer(180));
+        // And remember to flip the result points horizontally.
+        ArrayRef< Ref<ResultPoint> > points(result->getResultPoints());
+        if (points) {
+          points[0] = Ref<ResultPoint>(new OneDResultPoint(width - points[0]->getX() - 1,
+                                                           points[0]->getY()));
+          points[1] = Ref<ResultPoint>(new OneDResultPoint(width - points[1]->getX() - 1,
+                                                           points[1]->getY()));
+          
+        }
       }
+      return result;
+    } catch (ReaderException const& re) {
+      (void)re;
+      continue;
+    }
+  }
+  return Ref<Result>();
+}
+
+namespace {
+
+// Rows are binarized by the calling thread (binarizers are not thread-safe)
+// and then handed out to the workers in scan order.
+struct RowBatch {
+  Mutex mutex;
+  vector<int> rowNumbers;
+  vector<Ref<BitArray> > rows;
+  vector<Ref<Result> > results;
+  int next;
+  int found;
+};
 
-      // Java hints stuff missing
+// Readers keep scratch state between calls, so every worker owns one.
+struct RowWorker {
+  Ref<OneDReader> reader;
+  RowBatch* batch;
+};
 
+}
+
+void* OneDReader::sampleRows(void* arg) {
+  RowWorker& worker = *static_cast<RowWorker*>(arg);
+  RowBatch& batch = *worker.batch;
+  for (;;) {
+    batch.mutex.lock();
+    int i = batch.next++;
+    // A row later in scan order than a hit can't change the outcome.
+    bool done = i >= static_cast<int>(batch.rows.size()) || i > batch.found;
+    batch.mutex.unlock();
+    if (done) {
+      break;
+    }
+    if (!batch.rows[i]) {
+      continue;
+    }
+    Ref<Result> result;
+    try {
+      result = worker.reader->decodeRowBothWays(batch.rowNumbers[i], batch.rows[i]);
+    } catch (std::exception const& e) {
+      (void)e;
+    }
+    if (result) {
+      batch.mutex.lock();
+      batch.results[i] = result;
+      if (i < batch.found) {
+        batch.found = i;
+      }
+      batch.mutex.unlock();
+    }
+  }
+  return 0;
+}
+
+Ref<Result> OneDReader::doDecodeParallel(Ref<BinaryBitmap> image,
+                                         vector<Ref<OneDReader> > const& readers,
+                                         vector<int> const& rowNumbers) {
+  int width = image->getWidth();
+  int threads = readers.size();
+  RowBatch batch;
+  vector<RowWorker> workers(threads);
+  for (int t = 0; t < threads; t++) {
+    workers[t].reader = readers[t];
+    workers[t].batch = &batch;
+  }
+
+  // Binarize a batch of rows, then scan the batch on all threads. The result
+  // is identical to the serial scan: the first hit in scan order wins.
+  size_t batchSize = threads * SAMPLER_ROWS_PER_THREAD;
+  for (size_t first = 0; first < rowNumbers.size(); first += batchSize) {
+    size_t last = std::min(rowNumbers.size(), first + batchSize);
+    batch.rowNumbers.assign(rowNumbers.begin() + first, rowNumbers.begin() + last);
+    batch.rows.clear();
+    batch.results.clear();
+    batch.results.resize(last - first);
+    batch.next = 0;
+    batch.found = INT_MAX;
+    for (size_t i = first; i < last; i++) {
+      Ref<BitArray> row;
       try {
-        // Look for a barcode
-        // std::cerr << "rn " << rowNumber << " " << typeid(*this).name() << std::endl;
-        Ref<Result> result = decodeRow(rowNumber, row);
-        // We found our barcode
-        if (attempt == 1) {
-          // But it was upside down, so note that
-          // result.putMetadata(ResultMetadataType.ORIENTATION, new Integer(180));
-          // And remember to flip the result points horizontally.
-          ArrayRef< Ref<ResultPoint> > points(result->getResultPoints());
-          if (points) {
-            points[0] = Ref<ResultPoint>(new OneDResultPoint(width - points[0]->getX() - 1,
-                                                             points[0]->getY()));
-            points[1] = Ref<ResultPoint>(new OneDResultPoint(width - points[1]->getX() - 1,
-                                                             points[1]->getY()));
-            
-          }
-        }
-        return result;
-      } catch (ReaderException const& re) {
-        (void)re;
-        continue;
+        row = image->getBlackRow(rowNumbers[i], Ref<BitArray>(new BitArray(width)));
+      } catch (NotFoundException const& ignored) {
+        (void)ignored;
       }
+      batch.rows.push_back(row);
+    }
+
+    vector<Thread> pool(threads);
+    for (int t = 1; t < threads; t++) {
+      pool[t].start(sampleRows, &workers[t]);
+    }
+    sampleRows(&workers[0]);
+    for (int t = 1; t < threads; t++) {
+      pool[t].join();
+    }
+
+    if (batch.found != INT_MAX) {
+      return batch.results[batch.found];
     }
   }
   throw NotFoundException();
@@ -224,4 +461,9 @@ void OneDReader::recordPattern(Ref<BitArray> row,
   }
 }
 
+zxing::oned::OneDReader* OneDReader::createWorker(DecodeHints hints) {
+  (void)hints;
+  return 0;
+}
+
 OneDReader::~OneDReader() {}
@@ -22,6 +22,7 @@
  */
 
 #include <zxing/Reader.h>
+#include <vector>
 
 namespace zxing {
 namespace oned {
@@ -29,6 +30,12 @@ namespace oned {
 class OneDReader : public Reader {
 private:
   Ref<Result> doDecode(Ref<BinaryBitmap> image, DecodeHints hints);
+  Ref<Result> doDecodeParallel(Ref<BinaryBitmap> image,
+                               std::vector<Ref<OneDReader> > const& readers,
+                               std::vector<int> const& rowNumbers);
+  Ref<Result> decodeRowBothWays(int rowNumber, Ref<BitArray> row);
+
+  static void* sampleRows(void* sampler);
 
 protected:
   static const int INTEGER_MATH_SHIFT = 8;
@@ -50,6 +57,11 @@ protected:
     }
   };
 
+  // Returns a new reader with the same configuration as this one, or 0 if the
+  // reader can't be duplicated. Readers keep scratch state between calls, so
+  // parallel row sampling needs one instance per worker thread.
+  virtual OneDReader* createWorker(DecodeHints hints);
+
   static int patternMatchVariance(std::vector<int>& counters,
                                   std::vector<int> const& pattern,
                                   int maxIndividualVariance);
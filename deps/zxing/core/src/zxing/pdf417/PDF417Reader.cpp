@@ -58,7 +58,8 @@ Ref<Result> PDF417Reader::decode(Ref<BinaryBitmap> image, DecodeHints hints) {
     }
   */
   Ref<Result> r(new Result(decoderResult->getText(), decoderResult->getRawBytes(), points,
-                           BarcodeFormat::PDF_417));
+                           BarcodeFormat::PDF_417, decoderResult->getByteSegments(),
+                           decoderResult->getECLevel(), decoderResult->getCharset()));
   return r;
 }
 
@@ -20,6 +20,7 @@
 #include <zxing/FormatException.h>
 #include <zxing/pdf417/decoder/DecodedBitStreamParser.h>
 #include <zxing/common/DecoderResult.h>
+#include <zxing/common/CharacterSetECI.h>
 
 using std::string;
 using zxing::pdf417::DecodedBitStreamParser;
@@ -27,6 +28,7 @@ using zxing::ArrayRef;
 using zxing::Ref;
 using zxing::DecoderResult;
 using zxing::String;
+using zxing::common::CharacterSetECI;
 
 const int DecodedBitStreamParser::TEXT_COMPACTION_MODE_LATCH = 900;
 const int DecodedBitStreamParser::BYTE_COMPACTION_MODE_LATCH = 901;
@@ -36,6 +38,7 @@ const int DecodedBitStreamParser::BEGIN_MACRO_PDF417_CONTROL_BLOCK = 928;
 const int DecodedBitStreamParser::BEGIN_MACRO_PDF417_OPTIONAL_FIELD = 923;
 const int DecodedBitStreamParser::MACRO_PDF417_TERMINATOR = 922;
 const int DecodedBitStreamParser::MODE_SHIFT_TO_BYTE_COMPACTION_MODE = 913;
+const int DecodedBitStreamParser::ECI_CHARSET = 927;
 const int DecodedBitStreamParser::MAX_NUMERIC_CODEWORDS = 15;
 
 const int DecodedBitStreamParser::PL = 25;
@@ -79,6 +82,7 @@ DecodedBitStreamParser::DecodedBitStreamParser(){}
 Ref<DecoderResult> DecodedBitStreamParser::decode(ArrayRef<int> codewords)
 {
   Ref<String> result (new String(100));
+  std::string charset;
   // Get compaction mode
   int codeIndex = 1;
   int code = codewords[codeIndex++];
@@ -99,6 +103,15 @@ Ref<DecoderResult> DecodedBitStreamParser::decode(ArrayRef<int> codewords)
       case BYTE_COMPACTION_MODE_LATCH_6:
         codeIndex = byteCompaction(code, codewords, codeIndex, result);
         break;
+      case ECI_CHARSET: {
+        // The text keeps the bytes as they are; only the charset is reported.
+        CharacterSetECI* eci = CharacterSetECI::getCharacterSetECIByValue(codewords[codeIndex++]);
+        if (eci == 0) {
+          throw FormatException();
+        }
+        charset = eci->name();
+        break;
+      }
       default:
         // Default to text compaction. During testing numerous barcodes
         // appeared to be missing the starting mode. In these cases defaulting
@@ -113,7 +126,8 @@ Ref<DecoderResult> DecodedBitStreamParser::decode(ArrayRef<int> codewords)
       throw FormatException();
     }
   }
-  return Ref<DecoderResult>(new DecoderResult(ArrayRef<char>(), result));
+  ArrayRef< ArrayRef<char> > byteSegments (0);
+  return Ref<DecoderResult>(new DecoderResult(ArrayRef<char>(), result, byteSegments, "", charset));
 }
 
 /**
@@ -168,6 +182,7 @@ int DecodedBitStreamParser::textCompaction(ArrayRef<int> codewords,
           index++;
           break;
         case BYTE_COMPACTION_MODE_LATCH_6:
+        case ECI_CHARSET:
           codeIndex--;
           end = true;
           break;
@@ -377,6 +392,7 @@ int DecodedBitStreamParser::byteCompaction(int mode,
           nextCode == BYTE_COMPACTION_MODE_LATCH ||
           nextCode == NUMERIC_COMPACTION_MODE_LATCH ||
           nextCode == BYTE_COMPACTION_MODE_LATCH_6 ||
+          nextCode == ECI_CHARSET ||
           nextCode == BEGIN_MACRO_PDF417_CONTROL_BLOCK ||
           nextCode == BEGIN_MACRO_PDF417_OPTIONAL_FIELD ||
           nextCode == MACRO_PDF417_TERMINATOR)
@@ -429,6 +445,7 @@ int DecodedBitStreamParser::byteCompaction(int mode,
             code == BYTE_COMPACTION_MODE_LATCH ||
             code == NUMERIC_COMPACTION_MODE_LATCH ||
             code == BYTE_COMPACTION_MODE_LATCH_6 ||
+            code == ECI_CHARSET ||
             code == BEGIN_MACRO_PDF417_CONTROL_BLOCK ||
             code == BEGIN_MACRO_PDF417_OPTIONAL_FIELD ||
             code == MACRO_PDF417_TERMINATOR) {
@@ -481,6 +498,7 @@ int DecodedBitStreamParser::numericCompaction(ArrayRef<int> codewords,
       if (code == TEXT_COMPACTION_MODE_LATCH ||
           code == BYTE_COMPACTION_MODE_LATCH ||
           code == BYTE_COMPACTION_MODE_LATCH_6 ||
+          code == ECI_CHARSET ||
           code == BEGIN_MACRO_PDF417_CONTROL_BLOCK ||
           code == BEGIN_MACRO_PDF417_OPTIONAL_FIELD ||
           code == MACRO_PDF417_TERMINATOR) {
@@ -25,6 +25,7 @@
 #include <zxing/pdf417/decoder/DecodedBitStreamParser.h>
 #include <zxing/ReaderException.h>
 #include <zxing/common/reedsolomon/ReedSolomonException.h>
+#include <sstream>
 
 using zxing::pdf417::decoder::Decoder;
 using zxing::pdf417::decoder::ec::ErrorCorrection;
@@ -57,7 +58,13 @@ Ref<DecoderResult> Decoder::decode(Ref<BitMatrix> bits, DecodeHints const& hints
   verifyCodewordCount(codewords, numECCodewords);
 
   // Decode the codewords
-  return DecodedBitStreamParser::decode(codewords);
+  Ref<DecoderResult> result(DecodedBitStreamParser::decode(codewords));
+  std::ostringstream ecLevelStr;
+  ecLevelStr << ecLevel;
+  ArrayRef< ArrayRef<char> > byteSegments(result->getByteSegments());
+  return Ref<DecoderResult>(new DecoderResult(result->getRawBytes(), result->getText(),
+                                              byteSegments, ecLevelStr.str(),
+                                              result->getCharset()));
 }
 
 /**
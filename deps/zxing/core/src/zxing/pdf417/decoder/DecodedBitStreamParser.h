@@ -47,6 +47,7 @@ class DecodedBitStreamParser {
   static const int BEGIN_MACRO_PDF417_OPTIONAL_FIELD;
   static const int MACRO_PDF417_TERMINATOR;
   static const int MODE_SHIFT_TO_BYTE_COMPACTION_MODE;
+  static const int ECI_CHARSET;
   static const int MAX_NUMERIC_CODEWORDS;
 
   static const int PL;
@@ -38,7 +38,10 @@ namespace zxing {
 			ArrayRef< Ref<ResultPoint> > points (detectorResult->getPoints());
 			Ref<DecoderResult> decoderResult(decoder_.decode(detectorResult->getBits()));
 			Ref<Result> result(
-							   new Result(decoderResult->getText(), decoderResult->getRawBytes(), points, BarcodeFormat::QR_CODE));
+							   new Result(decoderResult->getText(), decoderResult->getRawBytes(), points, BarcodeFormat::QR_CODE,
+							              decoderResult->getByteSegments(), decoderResult->getECLevel(),
+							              decoderResult->getCharset()));
+			result->setPayload(decoderResult->getPayload());
 			return result;
 		}
 		
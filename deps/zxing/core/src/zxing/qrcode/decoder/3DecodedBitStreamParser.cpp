@@ -53,15 +53,18 @@ const char DecodedBitStreamParser::ALPHANUMERIC_CHARS[] =
 namespace {int GB2312_SUBSET = 1;}
 
 void DecodedBitStreamParser::append(std::string &result,
+                                    std::string &payload,
                                     string const& in,
                                     const char *src) {
-  append(result, (char const*)in.c_str(), in.length(), src);
+  append(result, payload, (char const*)in.c_str(), in.length(), src);
 }
 
 void DecodedBitStreamParser::append(std::string &result,
+                                    std::string &payload,
                                     const char *bufIn,
                                     size_t nIn,
                                     const char *src) {
+  payload.append(bufIn, nIn);
 #ifndef NO_ICONV
   if (nIn == 0) {
     return;
@@ -102,6 +105,7 @@ void DecodedBitStreamParser::append(std::string &result,
 
 void DecodedBitStreamParser::decodeHanziSegment(Ref<BitSource> bits_,
                                                 string& result,
+                                                string& payload,
                                                 int count) {
   BitSource& bits (*bits_);
   // Don't crash trying to read more bits than we have available.
@@ -132,7 +136,7 @@ void DecodedBitStreamParser::decodeHanziSegment(Ref<BitSource> bits_,
   }
 
   try {
-    append(result, buffer, nBytes, StringUtils::GB2312);
+    append(result, payload, buffer, nBytes, StringUtils::GB2312);
   } catch (ReaderException const& ignored) {
     (void)ignored;
     delete [] buffer;
@@ -142,7 +146,8 @@ void DecodedBitStreamParser::decodeHanziSegment(Ref<BitSource> bits_,
   delete [] buffer;
 }
 
-void DecodedBitStreamParser::decodeKanjiSegment(Ref<BitSource> bits, std::string &result, int count) {
+void DecodedBitStreamParser::decodeKanjiSegment(Ref<BitSource> bits, std::string &result,
+                                                std::string &payload, int count) {
   // Each character will require 2 bytes. Read the characters as 2-byte pairs
   // and decode as Shift_JIS afterwards
   size_t nBytes = 2 * count;
@@ -166,7 +171,7 @@ void DecodedBitStreamParser::decodeKanjiSegment(Ref<BitSource> bits, std::string
     count--;
   }
   try {
-    append(result, buffer, nBytes, StringUtils::SHIFT_JIS);
+    append(result, payload, buffer, nBytes, StringUtils::SHIFT_JIS);
   } catch (ReaderException const& ignored) {
     (void)ignored;
     delete [] buffer;
@@ -177,6 +182,7 @@ void DecodedBitStreamParser::decodeKanjiSegment(Ref<BitSource> bits, std::string
 
 void DecodedBitStreamParser::decodeByteSegment(Ref<BitSource> bits_,
                                                string& result,
+                                               string& payload,
                                                int count,
                                                CharacterSetECI* currentCharacterSetECI,
                                                ArrayRef< ArrayRef<char> >& byteSegments,
@@ -205,7 +211,7 @@ void DecodedBitStreamParser::decodeByteSegment(Ref<BitSource> bits_,
     encoding = currentCharacterSetECI->name();
   }
   try {
-    append(result, readBytes, nBytes, encoding.c_str());
+    append(result, payload, readBytes, nBytes, encoding.c_str());
   } catch (ReaderException const& ignored) {
     (void)ignored;
     throw FormatException();
@@ -213,7 +219,8 @@ void DecodedBitStreamParser::decodeByteSegment(Ref<BitSource> bits_,
   byteSegments->values().push_back(bytes_);
 }
 
-void DecodedBitStreamParser::decodeNumericSegment(Ref<BitSource> bits, std::string &result, int count) {
+void DecodedBitStreamParser::decodeNumericSegment(Ref<BitSource> bits, std::string &result,
+                                                  std::string &payload, int count) {
   int nBytes = count;
   char* bytes = new char[nBytes];
   int i = 0;
@@ -263,7 +270,7 @@ void DecodedBitStreamParser::decodeNumericSegment(Ref<BitSource> bits, std::stri
     }
     bytes[i++] = ALPHANUMERIC_CHARS[digitBits];
   }
-  append(result, bytes, nBytes, StringUtils::ASCII);
+  append(result, payload, bytes, nBytes, StringUtils::ASCII);
   delete[] bytes;
 }
 
@@ -276,6 +283,7 @@ char DecodedBitStreamParser::toAlphaNumericChar(size_t value) {
 
 void DecodedBitStreamParser::decodeAlphanumericSegment(Ref<BitSource> bits_,
                                                        string& result,
+                                                       string& payload,
                                                        int count,
                                                        bool fc1InEffect) {
   BitSource& bits (*bits_);
@@ -317,7 +325,7 @@ void DecodedBitStreamParser::decodeAlphanumericSegment(Ref<BitSource> bits_,
     }
     s = r.str();
   }
-  append(result, s, StringUtils::ASCII);
+  append(result, payload, s, StringUtils::ASCII);
 }
 
 namespace {
@@ -350,9 +358,10 @@ DecodedBitStreamParser::decode(ArrayRef<char> bytes,
   BitSource& bits (*bits_);
   string result;
   result.reserve(50);
+  string payload;
   ArrayRef< ArrayRef<char> > byteSegments (0);
+  CharacterSetECI* currentCharacterSetECI = 0;
   try {
-    CharacterSetECI* currentCharacterSetECI = 0;
     bool fc1InEffect = false;
     Mode* mode = 0;
     do {
@@ -393,20 +402,20 @@ DecodedBitStreamParser::decode(ArrayRef<char> bytes,
             int subset = bits.readBits(4);
             int countHanzi = bits.readBits(mode->getCharacterCountBits(version));
             if (subset == GB2312_SUBSET) {
-              decodeHanziSegment(bits_, result, countHanzi);
+              decodeHanziSegment(bits_, result, payload, countHanzi);
             }
           } else {
             // "Normal" QR code modes:
             // How many characters will follow, encoded in this mode?
             int count = bits.readBits(mode->getCharacterCountBits(version));
             if (mode == &Mode::NUMERIC) {
-              decodeNumericSegment(bits_, result, count);
+              decodeNumericSegment(bits_, result, payload, count);
             } else if (mode == &Mode::ALPHANUMERIC) {
-              decodeAlphanumericSegment(bits_, result, count, fc1InEffect);
+              decodeAlphanumericSegment(bits_, result, payload, count, fc1InEffect);
             } else if (mode == &Mode::BYTE) {
-              decodeByteSegment(bits_, result, count, currentCharacterSetECI, byteSegments, hints);
+              decodeByteSegment(bits_, result, payload, count, currentCharacterSetECI, byteSegments, hints);
             } else if (mode == &Mode::KANJI) {
-              decodeKanjiSegment(bits_, result, count);
+              decodeKanjiSegment(bits_, result, payload, count);
             } else {
               throw FormatException();
             }
@@ -420,6 +429,10 @@ DecodedBitStreamParser::decode(ArrayRef<char> bytes,
     throw FormatException();
   }
   
-  return Ref<DecoderResult>(new DecoderResult(bytes, Ref<String>(new String(result)), byteSegments, (string)ecLevel));
+  string charset = currentCharacterSetECI ? currentCharacterSetECI->name() : "";
+  Ref<DecoderResult> decoderResult(new DecoderResult(bytes, Ref<String>(new String(result)), byteSegments,
+                                                     (string)ecLevel, charset));
+  decoderResult->setPayload(payload);
+  return decoderResult;
 }
 
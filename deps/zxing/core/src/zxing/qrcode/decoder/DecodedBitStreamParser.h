@@ -44,20 +44,23 @@ private:
   static char const ALPHANUMERIC_CHARS[];
   static char toAlphaNumericChar(size_t value);
 
-  static void decodeHanziSegment(Ref<BitSource> bits, std::string &result, int count);
-  static void decodeKanjiSegment(Ref<BitSource> bits, std::string &result, int count);
-  static void decodeByteSegment(Ref<BitSource> bits, std::string &result, int count);
+  // The segment decoders append the text to result and the undecoded
+  // bytes of the segment to payload.
+  static void decodeHanziSegment(Ref<BitSource> bits, std::string &result, std::string &payload, int count);
+  static void decodeKanjiSegment(Ref<BitSource> bits, std::string &result, std::string &payload, int count);
   static void decodeByteSegment(Ref<BitSource> bits_,
                                 std::string& result,
+                                std::string& payload,
                                 int count,
                                 zxing::common::CharacterSetECI* currentCharacterSetECI,
                                 ArrayRef< ArrayRef<char> >& byteSegments,
                                 Hashtable const& hints);
-  static void decodeAlphanumericSegment(Ref<BitSource> bits, std::string &result, int count, bool fc1InEffect);
-  static void decodeNumericSegment(Ref<BitSource> bits, std::string &result, int count);
+  static void decodeAlphanumericSegment(Ref<BitSource> bits, std::string &result, std::string &payload,
+                                        int count, bool fc1InEffect);
+  static void decodeNumericSegment(Ref<BitSource> bits, std::string &result, std::string &payload, int count);
 
-  static void append(std::string &ost, const char *bufIn, size_t nIn, const char *src);
-  static void append(std::string &ost, std::string const& in, const char *src);
+  static void append(std::string &ost, std::string &payload, const char *bufIn, size_t nIn, const char *src);
+  static void append(std::string &ost, std::string &payload, std::string const& in, const char *src);
 
 public:
   static Ref<DecoderResult> decode(ArrayRef<char> bytes,
@@ -45,5 +45,10 @@ Tesseract.prototype = {
 
 // Export others.
 exports.Image = binding.Image;
+exports.CompressedImage = binding.CompressedImage;
+exports.ImageReader = binding.ImageReader;
+exports.RunLengthImage = binding.RunLengthImage;
 exports.ZXing = binding.ZXing;
+exports.BarcodeTracker = binding.BarcodeTracker;
 exports.Matrix = binding.Matrix;
+exports.pixPool = binding.pixPool;
@@ -0,0 +1,278 @@
+/*
+ * Copyright (c) 2012 Christoph Schulz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "barcodetracker.h"
+#include "image.h"
+#include "zxing.h"
+#include "util.h"
+#include <algorithm>
+#include <zxing/ReaderException.h>
+#include <zxing/common/IllegalArgumentException.h>
+
+using namespace v8;
+using namespace node;
+
+namespace binding {
+
+// Longest side of the thumbnails used to measure frame differences.
+const int THUMBNAIL_SIZE = 160;
+// Minimum margin (in pixels) around the last code when cropping.
+const int MIN_MARGIN = 16;
+
+Pix *createThumbnail(Pix *pix)
+{
+    int factor = std::max(1, static_cast<int>(std::max(pix->w, pix->h)) / THUMBNAIL_SIZE);
+    Pix *sampled = pixScaleByIntSubsampling(pix, factor);
+    if (!sampled) {
+        return NULL;
+    }
+    Pix *thumbnail = pixConvertTo8(sampled, 0);
+    pixDestroy(&sampled);
+    return thumbnail;
+}
+
+Box *createSearchBox(zxing::Ref<zxing::Result> result, int offsetX, int offsetY, Pix *pix)
+{
+    zxing::ArrayRef< zxing::Ref<zxing::ResultPoint> > points = result->getResultPoints();
+    if (!points || points->size() == 0) {
+        return NULL;
+    }
+    float minX = points[0]->getX(), maxX = minX;
+    float minY = points[0]->getY(), maxY = minY;
+    for (int i = 1; i < points->size(); ++i) {
+        minX = std::min(minX, points[i]->getX());
+        maxX = std::max(maxX, points[i]->getX());
+        minY = std::min(minY, points[i]->getY());
+        maxY = std::max(maxY, points[i]->getY());
+    }
+    // 1D codes only report points on the scan line, so pad relative to the
+    // larger extent in both directions.
+    int width = static_cast<int>(maxX - minX);
+    int height = static_cast<int>(maxY - minY);
+    int margin = std::max(width, height) / 2 + MIN_MARGIN;
+    Box *box = boxCreate(static_cast<int>(minX) + offsetX - margin,
+                         static_cast<int>(minY) + offsetY - margin,
+                         width + 2 * margin, height + 2 * margin);
+    Box *clipped = boxClipToRectangle(box, pix->w, pix->h);
+    boxDestroy(&box);
+    return clipped;
+}
+
+void BarcodeTracker::Init(Handle<Object> target)
+{
+    Local<FunctionTemplate> constructor_template = FunctionTemplate::New(New);
+    constructor_template->SetClassName(String::NewSymbol("BarcodeTracker"));
+    constructor_template->InstanceTemplate()->SetInternalFieldCount(1);
+    Local<ObjectTemplate> proto = constructor_template->PrototypeTemplate();
+    proto->SetAccessor(String::NewSymbol("zxing"), GetZXing);
+    proto->SetAccessor(String::NewSymbol("fullSearchInterval"), GetFullSearchInterval, SetFullSearchInterval);
+    proto->SetAccessor(String::NewSymbol("changeThreshold"), GetChangeThreshold, SetChangeThreshold);
+    proto->SetAccessor(String::NewSymbol("fullSearches"), GetFullSearches);
+    proto->Set(String::NewSymbol("track"),
+               FunctionTemplate::New(Track)->GetFunction());
+    proto->Set(String::NewSymbol("reset"),
+               FunctionTemplate::New(Reset)->GetFunction());
+    target->Set(String::NewSymbol("BarcodeTracker"),
+                Persistent<Function>::New(constructor_template->GetFunction()));
+}
+
+Handle<Value> BarcodeTracker::New(const Arguments &args)
+{
+    HandleScope scope;
+    if (args.Length() != 1 || !ZXing::HasInstance(args[0])) {
+        return THROW(TypeError, "cannot convert argument list to "
+                     "(zxing: ZXing)");
+    }
+    BarcodeTracker* obj = new BarcodeTracker();
+    obj->zxing_ = Persistent<Object>::New(args[0]->ToObject());
+    obj->Wrap(args.This());
+    return args.This();
+}
+
+Handle<Value> BarcodeTracker::GetZXing(Local<String> prop, const AccessorInfo &info)
+{
+    HandleScope scope;
+    BarcodeTracker* obj = ObjectWrap::Unwrap<BarcodeTracker>(info.This());
+    return scope.Close(obj->zxing_);
+}
+
+Handle<Value> BarcodeTracker::GetFullSearchInterval(Local<String> prop, const AccessorInfo &info)
+{
+    HandleScope scope;
+    BarcodeTracker* obj = ObjectWrap::Unwrap<BarcodeTracker>(info.This());
+    return scope.Close(Int32::New(obj->fullSearchInterval_));
+}
+
+void BarcodeTracker::SetFullSearchInterval(Local<String> prop, Local<Value> value, const AccessorInfo &info)
+{
+    HandleScope scope;
+    BarcodeTracker* obj = ObjectWrap::Unwrap<BarcodeTracker>(info.This());
+    if (value->IsInt32() && value->Int32Value() >= 1) {
+        obj->fullSearchInterval_ = value->Int32Value();
+    } else {
+        THROW(TypeError, "value must be a positive Int32");
+    }
+}
+
+Handle<Value> BarcodeTracker::GetChangeThreshold(Local<String> prop, const AccessorInfo &info)
+{
+    HandleScope scope;
+    BarcodeTracker* obj = ObjectWrap::Unwrap<BarcodeTracker>(info.This());
+    return scope.Close(Number::New(obj->changeThreshold_));
+}
+
+void BarcodeTracker::SetChangeThreshold(Local<String> prop, Local<Value> value, const AccessorInfo &info)
+{
+    HandleScope scope;
+    BarcodeTracker* obj = ObjectWrap::Unwrap<BarcodeTracker>(info.This());
+    if (value->IsNumber()) {
+        obj->changeThreshold_ = static_cast<float>(value->NumberValue());
+    } else {
+        THROW(TypeError, "value must be of type Number");
+    }
+}
+
+Handle<Value> BarcodeTracker::GetFullSearches(Local<String> prop, const AccessorInfo &info)
+{
+    HandleScope scope;
+    BarcodeTracker* obj = ObjectWrap::Unwrap<BarcodeTracker>(info.This());
+    return scope.Close(Int32::New(obj->fullSearches_));
+}
+
+Handle<Value> BarcodeTracker::Track(const Arguments &args)
+{
+    HandleScope scope;
+    BarcodeTracker* obj = ObjectWrap::Unwrap<BarcodeTracker>(args.This());
+    if (!Image::HasInstance(args[0])) {
+        return THROW(TypeError, "expected (image: Image)");
+    }
+    Pix *pix = Image::Pixels(args[0]->ToObject());
+    ZXing *zxing = ObjectWrap::Unwrap<ZXing>(obj->zxing_);
+    obj->framesSinceFullSearch_++;
+    bool fullSearchDue = obj->framesSinceFullSearch_ >= obj->fullSearchInterval_;
+
+    // Frames that barely changed keep the previous answer until the next
+    // full search is due.
+    Pix *thumbnail = createThumbnail(pix);
+    if (thumbnail && !fullSearchDue && obj->FrameUnchanged(thumbnail)) {
+        pixDestroy(&thumbnail);
+        return scope.Close(obj->lastResult_);
+    }
+    pixDestroy(&obj->lastThumbnail_);
+    obj->lastThumbnail_ = thumbnail;
+
+    try {
+        zxing::Ref<zxing::Result> result;
+        int offsetX = 0;
+        int offsetY = 0;
+        if (fullSearchDue) {
+            result = zxing->Decode(pix);
+            obj->framesSinceFullSearch_ = 0;
+            obj->fullSearches_++;
+        }
+        if (!result && obj->lastBox_) {
+            // Try the neighbourhood of the last code.
+            Pix *cropped = pixClipRectangle(pix, obj->lastBox_, NULL);
+            if (cropped) {
+                result = zxing->Decode(cropped);
+                offsetX = obj->lastBox_->x;
+                offsetY = obj->lastBox_->y;
+                pixDestroy(&cropped);
+            }
+        }
+        obj->lastResult_.Dispose();
+        if (result) {
+            Local<Object> object = ZXing::ResultToObject(result, offsetX, offsetY);
+            boxDestroy(&obj->lastBox_);
+            obj->lastBox_ = createSearchBox(result, offsetX, offsetY, pix);
+            obj->lastResult_ = Persistent<Value>::New(object);
+            return scope.Close(object);
+        } else {
+            if (obj->framesSinceFullSearch_ == 0) {
+                // The full search saw nothing, so stop cropping.
+                boxDestroy(&obj->lastBox_);
+            }
+            obj->lastResult_ = Persistent<Value>::New(Null());
+            return scope.Close(Null());
+        }
+    } catch (const zxing::ReaderException& e) {
+        return THROW(Error, e.what());
+    } catch (const zxing::IllegalArgumentException& e) {
+        return THROW(Error, e.what());
+    } catch (const zxing::Exception& e) {
+        return THROW(Error, e.what());
+    } catch (const std::exception& e) {
+        return THROW(Error, e.what());
+    } catch (...) {
+        return THROW(Error, "Uncaught exception");
+    }
+}
+
+Handle<Value> BarcodeTracker::Reset(const Arguments &args)
+{
+    HandleScope scope;
+    BarcodeTracker* obj = ObjectWrap::Unwrap<BarcodeTracker>(args.This());
+    obj->ClearState();
+    return args.This();
+}
+
+BarcodeTracker::BarcodeTracker()
+    : lastThumbnail_(NULL), lastBox_(NULL), fullSearchInterval_(5), changeThreshold_(2.0f),
+      fullSearches_(0)
+{
+    ClearState();
+}
+
+BarcodeTracker::~BarcodeTracker()
+{
+    pixDestroy(&lastThumbnail_);
+    boxDestroy(&lastBox_);
+    lastResult_.Dispose();
+    zxing_.Dispose();
+}
+
+void BarcodeTracker::ClearState()
+{
+    pixDestroy(&lastThumbnail_);
+    boxDestroy(&lastBox_);
+    if (!lastResult_.IsEmpty()) {
+        lastResult_.Dispose();
+    }
+    lastResult_ = Persistent<Value>::New(Null());
+    // Make the next frame do a full search.
+    framesSinceFullSearch_ = fullSearchInterval_;
+}
+
+bool BarcodeTracker::FrameUnchanged(Pix *thumbnail)
+{
+    if (!lastThumbnail_ || lastThumbnail_->w != thumbnail->w
+            || lastThumbnail_->h != thumbnail->h) {
+        return false;
+    }
+    float diff;
+    if (pixCompareGray(thumbnail, lastThumbnail_, L_COMPARE_ABS_DIFF, 0,
+                       NULL, &diff, NULL, NULL) != 0) {
+        return false;
+    }
+    return diff <= changeThreshold_;
+}
+
+}
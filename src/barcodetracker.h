@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2012 Christoph Schulz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef BARCODETRACKER_H
+#define BARCODETRACKER_H
+
+#include <v8.h>
+#include <node.h>
+#include <allheaders.h>
+
+namespace binding {
+
+class BarcodeTracker : public node::ObjectWrap
+{
+public:
+    static void Init(v8::Handle<v8::Object> target);
+
+private:
+    static v8::Handle<v8::Value> New(const v8::Arguments& args);
+
+    // Accessors.
+    static v8::Handle<v8::Value> GetZXing(v8::Local<v8::String> prop, const v8::AccessorInfo &info);
+    static v8::Handle<v8::Value> GetFullSearchInterval(v8::Local<v8::String> prop, const v8::AccessorInfo &info);
+    static void SetFullSearchInterval(v8::Local<v8::String> prop, v8::Local<v8::Value> value, const v8::AccessorInfo &info);
+    static v8::Handle<v8::Value> GetChangeThreshold(v8::Local<v8::String> prop, const v8::AccessorInfo &info);
+    static void SetChangeThreshold(v8::Local<v8::String> prop, v8::Local<v8::Value> value, const v8::AccessorInfo &info);
+    static v8::Handle<v8::Value> GetFullSearches(v8::Local<v8::String> prop, const v8::AccessorInfo &info);
+
+    // Methods.
+    static v8::Handle<v8::Value> Track(const v8::Arguments& args);
+    static v8::Handle<v8::Value> Reset(const v8::Arguments& args);
+
+    BarcodeTracker();
+    ~BarcodeTracker();
+
+    void ClearState();
+    bool FrameUnchanged(Pix *thumbnail);
+
+    v8::Persistent<v8::Object> zxing_;
+    v8::Persistent<v8::Value> lastResult_;
+    Pix *lastThumbnail_;
+    Box *lastBox_;
+    int framesSinceFullSearch_;
+    int fullSearchInterval_;
+    float changeThreshold_;
+    int fullSearches_;              // Frames decoded as a whole so far.
+};
+
+}
+
+#endif
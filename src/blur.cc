@@ -0,0 +1,337 @@
+/*
+ * Copyright (c) 2012 Christoph Schulz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "blur.h"
+#include "util.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace binding {
+
+namespace {
+
+// Above this sigma a kernel has more taps than three box blurs cost.
+const float kMaxKernelSigma = 3.0f;
+// Number of sigmas the kernel extends to on each side.
+const float kKernelSigmas = 3.0f;
+// Number of box blurs that approximate a Gaussian.
+const int kNumBoxes = 3;
+// Images with fewer rows than this per band are not split further.
+const int kMinRowsPerBand = 64;
+const int kMaxBands = 8;
+
+// A separable filter: either a symmetric kernel, or box blurs of the given
+// radii applied in turn.
+struct Filter {
+    std::vector<float> kernel;
+    std::vector<int> radii;
+};
+
+// The rows [y0, y1) of one pass from pixs to pixd.
+struct Band {
+    const Filter *filter;
+    Pix *pixs;
+    Pix *pixd;
+    int y0;
+    int y1;
+};
+
+inline l_uint8 toByte(float value)
+{
+    return static_cast<l_uint8>(std::min(value + 0.5f, 255.0f));
+}
+
+inline l_uint8 *rowBytes(Pix *pix, int y)
+{
+    return reinterpret_cast<l_uint8 *>(pixGetData(pix) + y * pixGetWpl(pix));
+}
+
+// Copies the n samples of line to the middle of padded, repeating the first
+// and last pixel (of stride samples) pad times on each side.
+void padLine(const float *line, float *padded, int n, int stride, int pad)
+{
+    float *center = padded + pad * stride;
+    memcpy(center, line, n * sizeof(float));
+    for (int k = 1; k <= pad; ++k) {
+        for (int c = 0; c < stride; ++c) {
+            center[c - k * stride] = line[c];
+            center[n - stride + c + k * stride] = line[n - stride + c];
+        }
+    }
+}
+
+int padding(const Filter &filter)
+{
+    if (!filter.kernel.empty()) {
+        return filter.kernel.size() / 2;
+    }
+    return *std::max_element(filter.radii.begin(), filter.radii.end()) + 1;
+}
+
+// Filters the n samples of line, of which every stride-th belongs to the
+// same channel. padded must hold n + 2 * padding(filter) * stride samples.
+void filterLine(const Filter &filter, float *line, float *padded, int n, int stride)
+{
+    if (!filter.kernel.empty()) {
+        int radius = filter.kernel.size() / 2;
+        padLine(line, padded, n, stride, radius);
+        const float *center = padded + radius * stride;
+        float weight = filter.kernel[radius];
+        for (int i = 0; i < n; ++i) {
+            line[i] = weight * center[i];
+        }
+        for (int k = 1; k <= radius; ++k) {
+            const float *left = center - k * stride;
+            const float *right = center + k * stride;
+            weight = filter.kernel[radius + k];
+            for (int i = 0; i < n; ++i) {
+                line[i] += weight * (left[i] + right[i]);
+            }
+        }
+        return;
+    }
+    for (size_t b = 0; b < filter.radii.size(); ++b) {
+        int radius = filter.radii[b];
+        if (radius == 0) {
+            continue;
+        }
+        padLine(line, padded, n, stride, radius + 1);
+        const float *center = padded + (radius + 1) * stride;
+        float scale = 1.0f / (2 * radius + 1);
+        for (int c = 0; c < stride; ++c) {
+            // Slide a running sum along the channel.
+            float sum = 0;
+            for (int k = -radius; k <= radius; ++k) {
+                sum += center[c + k * stride];
+            }
+            for (int i = c; i < n; i += stride) {
+                line[i] = sum * scale;
+                sum += center[i + (radius + 1) * stride] - center[i - radius * stride];
+            }
+        }
+    }
+}
+
+void *horizontalPass(void *arg)
+{
+    const Band &band = *static_cast<Band *>(arg);
+    int width = pixGetWidth(band.pixs);
+    bool gray = pixGetDepth(band.pixs) == 8;
+    int stride = gray ? 1 : 4;
+    int n = width * stride;
+    std::vector<float> line(n);
+    std::vector<float> padded(n + 2 * padding(*band.filter) * stride);
+    for (int y = band.y0; y < band.y1; ++y) {
+        l_uint32 *lines = pixGetData(band.pixs) + y * pixGetWpl(band.pixs);
+        l_uint32 *lined = pixGetData(band.pixd) + y * pixGetWpl(band.pixd);
+        if (gray) {
+            for (int x = 0; x < width; ++x) {
+                line[x] = GET_DATA_BYTE(lines, x);
+            }
+        } else {
+            // The bytes of all channels are filtered alike, in memory order.
+            const l_uint8 *bytes = reinterpret_cast<l_uint8 *>(lines);
+            for (int i = 0; i < n; ++i) {
+                line[i] = bytes[i];
+            }
+        }
+        filterLine(*band.filter, &line[0], &padded[0], n, stride);
+        if (gray) {
+            for (int x = 0; x < width; ++x) {
+                SET_DATA_BYTE(lined, x, toByte(line[x]));
+            }
+        } else {
+            l_uint8 *bytes = reinterpret_cast<l_uint8 *>(lined);
+            for (int i = 0; i < n; ++i) {
+                bytes[i] = toByte(line[i]);
+            }
+        }
+    }
+    return 0;
+}
+
+// Vertical passes work on whole rows of bytes; the order of the bytes
+// within the words does not matter there. A box filter has one radius.
+void *verticalPass(void *arg)
+{
+    const Band &band = *static_cast<Band *>(arg);
+    const Filter &filter = *band.filter;
+    int height = pixGetHeight(band.pixs);
+    int n = 4 * std::min(pixGetWpl(band.pixs), pixGetWpl(band.pixd));
+    std::vector<float> sum(n);
+    if (!filter.kernel.empty()) {
+        int radius = filter.kernel.size() / 2;
+        for (int y = band.y0; y < band.y1; ++y) {
+            const l_uint8 *row = rowBytes(band.pixs, y);
+            float weight = filter.kernel[radius];
+            for (int i = 0; i < n; ++i) {
+                sum[i] = weight * row[i];
+            }
+            for (int k = 1; k <= radius; ++k) {
+                const l_uint8 *above = rowBytes(band.pixs, std::max(y - k, 0));
+                const l_uint8 *below = rowBytes(band.pixs, std::min(y + k, height - 1));
+                weight = filter.kernel[radius + k];
+                for (int i = 0; i < n; ++i) {
+                    sum[i] += weight * (above[i] + below[i]);
+                }
+            }
+            l_uint8 *rowd = rowBytes(band.pixd, y);
+            for (int i = 0; i < n; ++i) {
+                rowd[i] = toByte(sum[i]);
+            }
+        }
+        return 0;
+    }
+    int radius = filter.radii[0];
+    float scale = 1.0f / (2 * radius + 1);
+    for (int k = -radius; k <= radius; ++k) {
+        const l_uint8 *row = rowBytes(band.pixs, std::min(std::max(band.y0 + k, 0), height - 1));
+        for (int i = 0; i < n; ++i) {
+            sum[i] += row[i];
+        }
+    }
+    for (int y = band.y0; y < band.y1; ++y) {
+        l_uint8 *rowd = rowBytes(band.pixd, y);
+        for (int i = 0; i < n; ++i) {
+            rowd[i] = toByte(sum[i] * scale);
+        }
+        const l_uint8 *next = rowBytes(band.pixs, std::min(y + radius + 1, height - 1));
+        const l_uint8 *last = rowBytes(band.pixs, std::max(y - radius, 0));
+        for (int i = 0; i < n; ++i) {
+            sum[i] += next[i] - last[i];
+        }
+    }
+    return 0;
+}
+
+// Runs pass over the rows of pixs in bands, each on its own thread.
+void runPass(void *(*pass)(void *), const Filter &filter, Pix *pixs, Pix *pixd)
+{
+    int height = pixGetHeight(pixs);
+    int count = std::max(1, std::min(std::min(numProcessors(), kMaxBands),
+                                     height / kMinRowsPerBand));
+    std::vector<Band> bands(count);
+    std::vector<void *> args(count);
+    for (int i = 0; i < count; ++i) {
+        bands[i].filter = &filter;
+        bands[i].pixs = pixs;
+        bands[i].pixd = pixd;
+        bands[i].y0 = height * i / count;
+        bands[i].y1 = height * (i + 1) / count;
+        args[i] = &bands[i];
+    }
+    runThreads(pass, &args[0], count);
+}
+
+// Runs the horizontal filter and then the vertical ones in turn.
+Pix *blur(Pix *pixd, Pix *pixs, const Filter &horizontal,
+          const std::vector<Filter> &vertical)
+{
+    if (pixs == NULL || pixGetColormap(pixs) != NULL ||
+            (pixGetDepth(pixs) != 8 && pixGetDepth(pixs) != 32)) {
+        return NULL;
+    }
+    if (pixd != NULL && (pixGetWidth(pixd) != pixGetWidth(pixs) ||
+                         pixGetHeight(pixd) != pixGetHeight(pixs) ||
+                         pixGetDepth(pixd) != pixGetDepth(pixs))) {
+        return NULL;
+    }
+    Pix *pixt = pixCreateTemplateNoInit(pixs);
+    if (pixt == NULL) {
+        return NULL;
+    }
+    bool created = pixd == NULL;
+    if (created && (pixd = pixCreateTemplateNoInit(pixs)) == NULL) {
+        pixDestroy(&pixt);
+        return NULL;
+    }
+    runPass(horizontalPass, horizontal, pixs, pixt);
+    Pix *src = pixt;
+    Pix *dst = pixd;
+    for (size_t i = 0; i < vertical.size(); ++i) {
+        runPass(verticalPass, vertical[i], src, dst);
+        std::swap(src, dst);
+    }
+    if (src != pixd) {
+        pixCopy(pixd, src);
+    }
+    pixDestroy(&pixt);
+    return pixd;
+}
+
+}
+
+Pix *gaussianBlur(Pix *pixd, Pix *pixs, float sigma)
+{
+    if (!(sigma > 0)) {
+        return NULL;
+    }
+    Filter horizontal;
+    std::vector<Filter> vertical;
+    if (sigma <= kMaxKernelSigma) {
+        int radius = static_cast<int>(ceil(kKernelSigmas * sigma));
+        float total = 0;
+        for (int k = -radius; k <= radius; ++k) {
+            float weight = exp(-0.5f * k * k / (sigma * sigma));
+            horizontal.kernel.push_back(weight);
+            total += weight;
+        }
+        for (int k = 0; k <= 2 * radius; ++k) {
+            horizontal.kernel[k] /= total;
+        }
+        vertical.push_back(horizontal);
+    } else {
+        // Odd box sizes whose variances add up to sigma^2, where a box of
+        // size s has a variance of (s^2 - 1) / 12.
+        float variance12 = 12 * sigma * sigma;
+        int lower = static_cast<int>(sqrt(variance12 / kNumBoxes + 1));
+        if (lower % 2 == 0) {
+            --lower;
+        }
+        int numLower = static_cast<int>(floor(
+            (variance12 - kNumBoxes * lower * lower - 4 * kNumBoxes * lower - 3 * kNumBoxes) /
+            (-4.0f * lower - 4) + 0.5f));
+        for (int i = 0; i < kNumBoxes; ++i) {
+            int size = i < numLower ? lower : lower + 2;
+            Filter box;
+            box.radii.push_back(size / 2);
+            horizontal.radii.push_back(size / 2);
+            vertical.push_back(box);
+        }
+    }
+    return blur(pixd, pixs, horizontal, vertical);
+}
+
+Pix *boxBlur(Pix *pixd, Pix *pixs, int halfWidth, int halfHeight)
+{
+    if (halfWidth < 0 || halfHeight < 0) {
+        return NULL;
+    }
+    Filter horizontal;
+    horizontal.radii.push_back(halfWidth);
+    Filter box;
+    box.radii.push_back(halfHeight);
+    return blur(pixd, pixs, horizontal, std::vector<Filter>(1, box));
+}
+
+}
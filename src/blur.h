@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) 2012 Christoph Schulz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef BLUR_H
+#define BLUR_H
+
+#include <allheaders.h>
+
+namespace binding {
+
+// Blurs pixs (8 or 32 bpp) with a Gaussian of the given standard deviation.
+// Small sigmas use a separable kernel, larger ones three box blurs in a row.
+// The result is written to pixd if given, which must have the size and depth
+// of pixs and may be pixs itself. Returns the result, or NULL on error.
+Pix *gaussianBlur(Pix *pixd, Pix *pixs, float sigma);
+
+// Blurs pixs (8 or 32 bpp) with a box of (2 * halfWidth + 1) x
+// (2 * halfHeight + 1) pixels, replicating the pixels at the edges.
+// pixd is used as in gaussianBlur().
+Pix *boxBlur(Pix *pixd, Pix *pixs, int halfWidth, int halfHeight);
+
+}
+
+#endif
@@ -0,0 +1,434 @@
+/*
+ * Copyright (c) 2012 Christoph Schulz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "compressedimage.h"
+#include "image.h"
+#include "util.h"
+#include <algorithm>
+#include <cstring>
+
+using namespace v8;
+using namespace node;
+
+namespace binding {
+
+namespace {
+
+// The pixels are compressed in chunks of this many bytes, independently of
+// each other so that they can be handled on separate threads.
+const int kChunkSize = 1 << 18;
+
+// The chunks are compressed with a byte oriented LZ77 scheme in the manner
+// of LZ4: each sequence is a token byte with the number of literals in the
+// high and the match length minus kMinMatch in the low four bits (extended
+// by bytes of 255 while they are saturated), the literals, and a 16 bit
+// match offset with the rest of the match length. The last sequence has no
+// match. This trades some compression for speed, but pages are mostly
+// runs of the same bytes, which it handles well.
+const int kMinMatch = 4;
+const int kMaxOffset = 0xffff;
+const int kHashBits = 14;
+
+inline l_uint32 read32(const l_uint8 *p)
+{
+    l_uint32 value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+inline l_uint32 hash(l_uint32 value)
+{
+    return (value * 2654435761u) >> (32 - kHashBits);
+}
+
+void writeLength(std::vector<l_uint8> &out, int length)
+{
+    for (; length >= 255; length -= 255) {
+        out.push_back(255);
+    }
+    out.push_back(static_cast<l_uint8>(length));
+}
+
+void writeSequence(std::vector<l_uint8> &out, const l_uint8 *literals, int numLiterals,
+                   int offset, int matchLength)
+{
+    int extraMatch = matchLength - kMinMatch;
+    out.push_back(static_cast<l_uint8>((std::min(numLiterals, 15) << 4) |
+                                       (offset ? std::min(extraMatch, 15) : 0)));
+    if (numLiterals >= 15) {
+        writeLength(out, numLiterals - 15);
+    }
+    out.insert(out.end(), literals, literals + numLiterals);
+    if (offset) {
+        out.push_back(static_cast<l_uint8>(offset));
+        out.push_back(static_cast<l_uint8>(offset >> 8));
+        if (extraMatch >= 15) {
+            writeLength(out, extraMatch - 15);
+        }
+    }
+}
+
+void compressChunk(const l_uint8 *src, int length, std::vector<l_uint8> &out)
+{
+    std::vector<int> table(1 << kHashBits, -1);
+    int anchor = 0;
+    int i = 0;
+    while (i + kMinMatch <= length) {
+        l_uint32 value = read32(src + i);
+        l_uint32 h = hash(value);
+        int candidate = table[h];
+        table[h] = i;
+        if (candidate < 0 || i - candidate > kMaxOffset || read32(src + candidate) != value) {
+            // Skip faster through data that does not compress.
+            i += 1 + ((i - anchor) >> 6);
+            continue;
+        }
+        int matchLength = kMinMatch;
+        while (i + matchLength < length && src[candidate + matchLength] == src[i + matchLength]) {
+            ++matchLength;
+        }
+        writeSequence(out, src + anchor, i - anchor, i - candidate, matchLength);
+        i += matchLength;
+        anchor = i;
+    }
+    writeSequence(out, src + anchor, length - anchor, 0, 0);
+}
+
+bool readLength(const l_uint8 *&in, const l_uint8 *end, int &length)
+{
+    l_uint8 byte;
+    do {
+        if (in == end) {
+            return false;
+        }
+        byte = *in++;
+        length += byte;
+    } while (byte == 255);
+    return true;
+}
+
+bool decompressChunk(const l_uint8 *in, const l_uint8 *end, l_uint8 *dst, int length)
+{
+    int pos = 0;
+    while (in < end) {
+        int token = *in++;
+        int numLiterals = token >> 4;
+        if (numLiterals == 15 && !readLength(in, end, numLiterals)) {
+            return false;
+        }
+        if (numLiterals > end - in || numLiterals > length - pos) {
+            return false;
+        }
+        memcpy(dst + pos, in, numLiterals);
+        in += numLiterals;
+        pos += numLiterals;
+        if (in == end) {
+            break;
+        }
+        if (end - in < 2) {
+            return false;
+        }
+        int offset = in[0] | (in[1] << 8);
+        in += 2;
+        int matchLength = token & 15;
+        if (matchLength == 15 && !readLength(in, end, matchLength)) {
+            return false;
+        }
+        matchLength += kMinMatch;
+        if (offset == 0 || offset > pos || matchLength > length - pos) {
+            return false;
+        }
+        // A match may overlap itself, repeating its first offset bytes. The
+        // part copied so far repeats too, so the copies can grow each time.
+        const l_uint8 *match = dst + pos - offset;
+        l_uint8 *out = dst + pos;
+        for (int remaining = matchLength; remaining > 0; ) {
+            int n = std::min(remaining, static_cast<int>(out - match));
+            memcpy(out, match, n);
+            out += n;
+            remaining -= n;
+        }
+        pos += matchLength;
+    }
+    return pos == length;
+}
+
+// The chunks [first, ...) with a stride of step, handled on one thread.
+struct ChunkJob {
+    l_uint8 *pixels;
+    size_t size;
+    std::vector< std::vector<l_uint8> > *compressed;
+    const l_uint8 *data;
+    const size_t *offsets;
+    int wpl;
+    l_uint32 padMask;   // Clears the padding bits at the end of the rows.
+    int first;
+    int step;
+    bool ok;
+};
+
+int chunkLength(const ChunkJob &job, int chunk)
+{
+    return static_cast<int>(std::min<size_t>(kChunkSize, job.size - chunk * size_t(kChunkSize)));
+}
+
+// Clears the padding bits of the rows that end within the words
+// [firstWord, firstWord + count), which are at words.
+void clearPadBits(l_uint8 *words, size_t firstWord, int count, const ChunkJob &job)
+{
+    size_t end = firstWord + count;
+    for (size_t i = firstWord / job.wpl * job.wpl + job.wpl - 1; i < end; i += job.wpl) {
+        l_uint8 *p = words + 4 * (i - firstWord);
+        l_uint32 word = read32(p) & job.padMask;
+        memcpy(p, &word, sizeof(word));
+    }
+}
+
+void *compressChunks(void *arg)
+{
+    ChunkJob &job = *static_cast<ChunkJob *>(arg);
+    std::vector<l_uint8> copy;
+    for (int i = job.first; i < static_cast<int>(job.compressed->size()); i += job.step) {
+        const l_uint8 *chunk = job.pixels + i * size_t(kChunkSize);
+        int length = chunkLength(job, i);
+        // The padding bits are cleared in a copy, rather than in the image,
+        // so that they compress well and decompress the same each time.
+        if (job.padMask != ~0u) {
+            copy.assign(chunk, chunk + length);
+            clearPadBits(&copy[0], i * size_t(kChunkSize / 4), length / 4, job);
+            chunk = &copy[0];
+        }
+        compressChunk(chunk, length, (*job.compressed)[i]);
+    }
+    return 0;
+}
+
+void *decompressChunks(void *arg)
+{
+    ChunkJob &job = *static_cast<ChunkJob *>(arg);
+    int count = static_cast<int>((job.size + kChunkSize - 1) / kChunkSize);
+    for (int i = job.first; i < count && job.ok; i += job.step) {
+        job.ok = decompressChunk(job.data + job.offsets[i], job.data + job.offsets[i + 1],
+                                 job.pixels + i * size_t(kChunkSize), chunkLength(job, i));
+    }
+    return 0;
+}
+
+// Runs func over the chunks of job on as many threads as make sense, and
+// returns whether all of them succeeded.
+bool runChunkJobs(void *(*func)(void *), const ChunkJob &job)
+{
+    int numChunks = static_cast<int>((job.size + kChunkSize - 1) / kChunkSize);
+    int count = std::max(1, std::min(numProcessors(), numChunks));
+    std::vector<ChunkJob> jobs(count, job);
+    std::vector<void *> args(count);
+    for (int i = 0; i < count; ++i) {
+        jobs[i].first = i;
+        jobs[i].step = count;
+        args[i] = &jobs[i];
+    }
+    runThreads(func, &args[0], count);
+    for (int i = 0; i < count; ++i) {
+        if (!jobs[i].ok) {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t dataSize(Pix *pix)
+{
+    return size_t(pixGetHeight(pix)) * pixGetWpl(pix) * sizeof(l_uint32);
+}
+
+}
+
+Persistent<FunctionTemplate> CompressedImage::constructor_template;
+
+bool CompressedImage::HasInstance(Handle<Value> val)
+{
+    if (!val->IsObject()) {
+        return false;
+    }
+    return constructor_template->HasInstance(val->ToObject());
+}
+
+void CompressedImage::Init(Handle<Object> target)
+{
+    constructor_template = Persistent<FunctionTemplate>::New(FunctionTemplate::New(New));
+    constructor_template->SetClassName(String::NewSymbol("CompressedImage"));
+    constructor_template->InstanceTemplate()->SetInternalFieldCount(1);
+    Local<ObjectTemplate> proto = constructor_template->PrototypeTemplate();
+    proto->SetAccessor(String::NewSymbol("width"), GetWidth);
+    proto->SetAccessor(String::NewSymbol("height"), GetHeight);
+    proto->SetAccessor(String::NewSymbol("depth"), GetDepth);
+    proto->SetAccessor(String::NewSymbol("byteLength"), GetByteLength);
+    proto->Set(String::NewSymbol("decompress"),
+               FunctionTemplate::New(Decompress)->GetFunction());
+    target->Set(String::NewSymbol("CompressedImage"),
+                Persistent<Function>::New(constructor_template->GetFunction()));
+}
+
+Handle<Value> CompressedImage::New(Pix *pix)
+{
+    HandleScope scope;
+    Local<Object> instance = constructor_template->GetFunction()->NewInstance();
+    CompressedImage *obj = ObjectWrap::Unwrap<CompressedImage>(instance);
+    if (!obj->Compress(pix)) {
+        return THROW(Error, "error while compressing image");
+    }
+    return scope.Close(instance);
+}
+
+Handle<Value> CompressedImage::New(const Arguments &args)
+{
+    HandleScope scope;
+    CompressedImage *obj = new CompressedImage();
+    obj->Wrap(args.This());
+    if (args.Length() == 0) {
+        return args.This();
+    } else if (args.Length() == 1 && Image::HasInstance(args[0])) {
+        if (!obj->Compress(Image::Pixels(args[0]->ToObject()))) {
+            return THROW(Error, "error while compressing image");
+        }
+        return args.This();
+    } else {
+        return THROW(TypeError, "expected (image: Image) or no arguments at all");
+    }
+}
+
+Handle<Value> CompressedImage::GetWidth(Local<String> prop, const AccessorInfo &info)
+{
+    HandleScope scope;
+    CompressedImage *obj = ObjectWrap::Unwrap<CompressedImage>(info.This());
+    return scope.Close(Number::New(obj->header_ ? pixGetWidth(obj->header_) : 0));
+}
+
+Handle<Value> CompressedImage::GetHeight(Local<String> prop, const AccessorInfo &info)
+{
+    HandleScope scope;
+    CompressedImage *obj = ObjectWrap::Unwrap<CompressedImage>(info.This());
+    return scope.Close(Number::New(obj->header_ ? pixGetHeight(obj->header_) : 0));
+}
+
+Handle<Value> CompressedImage::GetDepth(Local<String> prop, const AccessorInfo &info)
+{
+    HandleScope scope;
+    CompressedImage *obj = ObjectWrap::Unwrap<CompressedImage>(info.This());
+    return scope.Close(Number::New(obj->header_ ? pixGetDepth(obj->header_) : 0));
+}
+
+Handle<Value> CompressedImage::GetByteLength(Local<String> prop, const AccessorInfo &info)
+{
+    HandleScope scope;
+    CompressedImage *obj = ObjectWrap::Unwrap<CompressedImage>(info.This());
+    return scope.Close(Number::New(obj->data_.size()));
+}
+
+Handle<Value> CompressedImage::Decompress(const Arguments &args)
+{
+    HandleScope scope;
+    CompressedImage *obj = ObjectWrap::Unwrap<CompressedImage>(args.This());
+    if (obj->header_ == NULL) {
+        return THROW(Error, "compressed image is empty");
+    }
+    Pix *pixd = obj->Decompress();
+    if (pixd == NULL) {
+        return THROW(Error, "error while decompressing image");
+    }
+    return scope.Close(Image::New(pixd));
+}
+
+CompressedImage::CompressedImage()
+    : header_(NULL)
+{
+}
+
+CompressedImage::~CompressedImage()
+{
+    if (header_) {
+        V8::AdjustAmountOfExternalAllocatedMemory(-static_cast<int>(data_.size()));
+        pixDestroy(&header_);
+    }
+}
+
+bool CompressedImage::Compress(Pix *pix)
+{
+    if (pix == NULL || header_ != NULL) {
+        return false;
+    }
+    Pix *header = pixCreateHeader(pixGetWidth(pix), pixGetHeight(pix), pixGetDepth(pix));
+    if (header == NULL) {
+        return false;
+    }
+    pixCopyResolution(header, pix);
+    pixCopyColormap(header, pix);
+    pixCopyInputFormat(header, pix);
+    pixCopyText(header, pix);
+
+    ChunkJob job;
+    job.pixels = reinterpret_cast<l_uint8 *>(pixGetData(pix));
+    job.size = dataSize(pix);
+    job.wpl = pixGetWpl(pix);
+    int padding = 32 * job.wpl - pixGetWidth(pix) * pixGetDepth(pix);
+    job.padMask = padding ? ~((1u << padding) - 1) : ~0u;
+    std::vector< std::vector<l_uint8> > compressed((job.size + kChunkSize - 1) / kChunkSize);
+    job.compressed = &compressed;
+    job.data = NULL;
+    job.offsets = NULL;
+    job.ok = true;
+    runChunkJobs(compressChunks, job);
+
+    offsets_.assign(1, 0);
+    for (size_t i = 0; i < compressed.size(); ++i) {
+        offsets_.push_back(offsets_.back() + compressed[i].size());
+    }
+    data_.reserve(offsets_.back());
+    for (size_t i = 0; i < compressed.size(); ++i) {
+        data_.insert(data_.end(), compressed[i].begin(), compressed[i].end());
+    }
+    header_ = header;
+    V8::AdjustAmountOfExternalAllocatedMemory(data_.size());
+    return true;
+}
+
+Pix *CompressedImage::Decompress() const
+{
+    Pix *pixd = pixCreateTemplateNoInit(header_);
+    if (pixd == NULL) {
+        return NULL;
+    }
+    ChunkJob job;
+    job.pixels = reinterpret_cast<l_uint8 *>(pixGetData(pixd));
+    job.size = dataSize(pixd);
+    job.data = data_.empty() ? NULL : &data_[0];
+    job.offsets = &offsets_[0];
+    job.compressed = NULL;
+    job.wpl = pixGetWpl(pixd);
+    job.padMask = ~0u;
+    job.ok = true;
+    if (!runChunkJobs(decompressChunks, job)) {
+        pixDestroy(&pixd);
+    }
+    return pixd;
+}
+
+}
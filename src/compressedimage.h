@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2012 Christoph Schulz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef COMPRESSEDIMAGE_H
+#define COMPRESSEDIMAGE_H
+
+#include <v8.h>
+#include <node.h>
+#include <allheaders.h>
+#include <vector>
+
+namespace binding {
+
+// Keeps the pixels of an image losslessly compressed in memory, for holding
+// many pages at once. The pixels are only decompressed when asked for, into
+// a new image each time.
+class CompressedImage : public node::ObjectWrap
+{
+public:
+    static v8::Persistent<v8::FunctionTemplate> constructor_template;
+
+    static bool HasInstance(v8::Handle<v8::Value> val);
+
+    static void Init(v8::Handle<v8::Object> target);
+
+    // Compresses pix, which is left unchanged and stays owned by the caller.
+    static v8::Handle<v8::Value> New(Pix *pix);
+
+private:
+    static v8::Handle<v8::Value> New(const v8::Arguments& args);
+
+    // Accessors.
+    static v8::Handle<v8::Value> GetWidth(v8::Local<v8::String> prop, const v8::AccessorInfo &info);
+    static v8::Handle<v8::Value> GetHeight(v8::Local<v8::String> prop, const v8::AccessorInfo &info);
+    static v8::Handle<v8::Value> GetDepth(v8::Local<v8::String> prop, const v8::AccessorInfo &info);
+    static v8::Handle<v8::Value> GetByteLength(v8::Local<v8::String> prop, const v8::AccessorInfo &info);
+
+    // Methods.
+    static v8::Handle<v8::Value> Decompress(const v8::Arguments& args);
+
+    CompressedImage();
+    ~CompressedImage();
+
+    bool Compress(Pix *pix);
+    Pix *Decompress() const;
+
+    Pix *header_;                   // The pixs without data, for its size and colormap.
+    std::vector<l_uint8> data_;     // The compressed chunks, one after another.
+    std::vector<size_t> offsets_;   // Where each chunk starts, and where the last ends.
+};
+
+}
+
+#endif
@@ -0,0 +1,201 @@
+/*
+ * Copyright (c) 2012 Christoph Schulz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "deskew.h"
+#include "util.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace binding {
+
+namespace {
+
+// These follow the defaults of pixFindSkew and pixDeskew.
+const float kSweepRange = 7.0f;
+const float kSweepDelta = 1.0f;
+const float kMinSearchDelta = 0.01f;
+const float kMinDeskewAngle = 0.1f;
+const float kMinConfidence = 3.0f;
+const float kMinValidMaxScore = 10000.0f;
+const float kMinScoreThreshold = 0.000002f;
+const int kBinaryThreshold = 130;
+
+// Larger angles are rotated by area mapping, which looks better than three
+// shears for gray and color images.
+const float kMaxShearAngle = 3.0f;
+
+const float kDeg2Rad = 3.1415926535f / 180.0f;
+
+// Scores count angles of a sweep on one thread.
+struct Sweep {
+    Pix *pixs;
+    const float *angles;
+    float *scores;
+    int count;
+};
+
+void *scoreAngles(void *arg)
+{
+    const Sweep &sweep = *static_cast<Sweep *>(arg);
+    Pix *pixt = pixCreateTemplate(sweep.pixs);
+    for (int i = 0; i < sweep.count; ++i) {
+        sweep.scores[i] = 0;
+        if (pixt != NULL) {
+            pixVShearCorner(pixt, sweep.pixs, kDeg2Rad * sweep.angles[i], L_BRING_IN_WHITE);
+            pixFindDifferentialSquareSum(pixt, &sweep.scores[i]);
+        }
+    }
+    pixDestroy(&pixt);
+    return 0;
+}
+
+// Shears pixs by each of the angles and stores how well the rows of the
+// result line up in scores, spreading the angles over the processors.
+void score(Pix *pixs, const std::vector<float> &angles, std::vector<float> &scores)
+{
+    int n = static_cast<int>(angles.size());
+    int count = std::max(1, std::min(numProcessors(), n));
+    scores.resize(n);
+    std::vector<Sweep> sweeps(count);
+    std::vector<void *> args(count);
+    for (int i = 0; i < count; ++i) {
+        int first = n * i / count;
+        sweeps[i].pixs = pixs;
+        sweeps[i].angles = &angles[first];
+        sweeps[i].scores = &scores[first];
+        sweeps[i].count = n * (i + 1) / count - first;
+        args[i] = &sweeps[i];
+    }
+    runThreads(scoreAngles, &args[0], count);
+}
+
+// Like pixFindSkewSweepAndSearch with the default reductions of 4 for the
+// sweep and 2 for the search, but scoring the angles of each step in
+// parallel. Returns false if pixs has no foreground.
+bool findSkew(Pix *pixs, float *angle, float *confidence)
+{
+    *angle = 0;
+    *confidence = 0;
+    Pix *pixSearch = pixReduceRankBinaryCascade(pixs, 1, 0, 0, 0);
+    int empty = 1;
+    if (pixSearch == NULL || pixZero(pixSearch, &empty) != 0 || empty) {
+        pixDestroy(&pixSearch);
+        return false;
+    }
+    Pix *pixSweep = pixReduceRankBinaryCascade(pixSearch, 1, 0, 0, 0);
+    if (pixSweep == NULL) {
+        pixDestroy(&pixSearch);
+        return false;
+    }
+
+    // Sweep the whole range at low resolution.
+    int n = static_cast<int>(2 * kSweepRange / kSweepDelta + 1);
+    std::vector<float> angles(n);
+    std::vector<float> scores;
+    for (int i = 0; i < n; ++i) {
+        angles[i] = -kSweepRange + i * kSweepDelta;
+    }
+    score(pixSweep, angles, scores);
+    pixDestroy(&pixSweep);
+    int best = static_cast<int>(std::max_element(scores.begin(), scores.end()) - scores.begin());
+    if (best == 0 || best == n - 1) {
+        pixDestroy(&pixSearch);
+        return true;
+    }
+
+    // Halve the step around the best angle until it is small enough. The
+    // scores are kept as the five of center - 2 * delta to center + 2 * delta.
+    float center = angles[best];
+    float delta = kSweepDelta;
+    angles.resize(3);
+    angles[0] = center - delta;
+    angles[1] = center;
+    angles[2] = center + delta;
+    score(pixSearch, angles, scores);
+    float window[5] = { scores[0], 0, scores[1], 0, scores[2] };
+    float minScore = *std::min_element(scores.begin(), scores.end());
+    angles.resize(2);
+    for (delta *= 0.5f; delta >= kMinSearchDelta; delta *= 0.5f) {
+        angles[0] = center - delta;
+        angles[1] = center + delta;
+        score(pixSearch, angles, scores);
+        window[1] = scores[0];
+        window[3] = scores[1];
+        minScore = std::min(minScore, std::min(scores[0], scores[1]));
+        int index = static_cast<int>(std::max_element(window + 1, window + 4) - window);
+        float left = window[index - 1];
+        float right = window[index + 1];
+        window[2] = window[index];
+        window[0] = left;
+        window[4] = right;
+        center += delta * (index - 2);
+    }
+    *angle = center;
+
+    // The ratio of the best to the worst score is the confidence, unless
+    // the worst is too small to be meaningful (mostly black images) or the
+    // result is near the ends of the sweep.
+    int width = pixGetWidth(pixSearch);
+    int height = pixGetHeight(pixSearch);
+    float maxScore = window[2];
+    if (minScore > kMinScoreThreshold * width * width * height &&
+            maxScore >= kMinValidMaxScore &&
+            std::fabs(center) <= kSweepRange - kSweepDelta) {
+        *confidence = maxScore / minScore;
+    }
+    pixDestroy(&pixSearch);
+    return true;
+}
+
+}
+
+Pix *deskew(Pix *pixs, float *angle, float *confidence)
+{
+    *angle = 0;
+    *confidence = 0;
+    if (pixs == NULL) {
+        return NULL;
+    }
+    Pix *pixb;
+    if (pixGetDepth(pixs) == 1) {
+        pixb = pixClone(pixs);
+    } else {
+        pixb = pixConvertTo1(pixs, kBinaryThreshold);
+    }
+    if (pixb == NULL) {
+        return NULL;
+    }
+    findSkew(pixb, angle, confidence);
+    pixDestroy(&pixb);
+    if (*confidence < kMinConfidence || std::fabs(*angle) < kMinDeskewAngle) {
+        return pixCopy(NULL, pixs);
+    }
+    // Shearing is much faster and exact enough for the usual small angles.
+    if (std::fabs(*angle) <= kMaxShearAngle) {
+        return pixRotateShearCenter(pixs, kDeg2Rad * *angle, L_BRING_IN_WHITE);
+    } else {
+        return pixRotate(pixs, kDeg2Rad * *angle, L_ROTATE_AREA_MAP, L_BRING_IN_WHITE,
+                         pixGetWidth(pixs), pixGetHeight(pixs));
+    }
+}
+
+}
@@ -21,6 +21,12 @@
  */
 #include "image.h"
 #include "util.h"
+#include "blur.h"
+#include "compressedimage.h"
+#include "deskew.h"
+#include "projection.h"
+#include "resample.h"
+#include "runlengthimage.h"
 #include <sstream>
 #include <algorithm>
 #include <cmath>
@@ -132,44 +138,6 @@ PIX *pixCompose(PIX *pix1, PIX *pix2, PIX *pix3)
     return pixd;
 }
 
-enum ProjectionMode
-{
-    Horizontal = 1,
-    Vertical = 2
-};
-
-void pixProjection(std::vector<uint32_t> &values, PIX *pix, ProjectionMode mode)
-{
-    uint32_t *line = pix->data;
-    if (mode == Horizontal) {
-        values.assign(pix->w, 0);
-    }
-    else if (mode == Vertical) {
-        values.assign(pix->h, 0);
-    }
-    for (uint32_t y = 0; y < pix->h; ++y) {
-        for (uint32_t x = 0; x < pix->w; ++x) {
-            if (mode == Horizontal) {
-                if (pix->d == 1) {
-                    values[x] += GET_DATA_BIT(line, x);
-                }
-                else {
-                    values[x] += GET_DATA_BYTE(line, x);
-                }
-            }
-            else if (mode == Vertical) {
-                if (pix->d == 1) {
-                    values[y] += GET_DATA_BIT(line, x);
-                }
-                else {
-                    values[y] += GET_DATA_BYTE(line, x);
-                }
-            }
-        }
-        line += pix->wpl;
-    }
-}
-
 bool Image::HasInstance(Handle<Value> val)
 {
     if (!val->IsObject()) {
@@ -210,6 +178,10 @@ void Image::Init(Handle<Object> target)
                FunctionTemplate::New(Unsharp)->GetFunction());
     proto->Set(String::NewSymbol("unsharp"),
                FunctionTemplate::New(Unsharp)->GetFunction());
+    proto->Set(String::NewSymbol("gaussianBlur"),
+               FunctionTemplate::New(GaussianBlur)->GetFunction());
+    proto->Set(String::NewSymbol("boxBlur"),
+               FunctionTemplate::New(BoxBlur)->GetFunction());
     proto->Set(String::NewSymbol("rotate"),
                FunctionTemplate::New(Rotate)->GetFunction());
     proto->Set(String::NewSymbol("scale"),
@@ -250,6 +222,8 @@ void Image::Init(Handle<Object> target)
                FunctionTemplate::New(Open)->GetFunction());
     proto->Set(String::NewSymbol("close"),
                FunctionTemplate::New(Close)->GetFunction());
+    proto->Set(String::NewSymbol("morphSequence"),
+               FunctionTemplate::New(MorphSequence)->GetFunction());
     proto->Set(String::NewSymbol("thin"),
                FunctionTemplate::New(Thin)->GetFunction());
     proto->Set(String::NewSymbol("maxDynamicRange"),
@@ -258,6 +232,8 @@ void Image::Init(Handle<Object> target)
                FunctionTemplate::New(OtsuAdaptiveThreshold)->GetFunction());
     proto->Set(String::NewSymbol("findSkew"),
                FunctionTemplate::New(FindSkew)->GetFunction());
+    proto->Set(String::NewSymbol("deskew"),
+               FunctionTemplate::New(Deskew)->GetFunction());
     proto->Set(String::NewSymbol("connectedComponents"),
                FunctionTemplate::New(ConnectedComponents)->GetFunction());
     proto->Set(String::NewSymbol("distanceFunction"),
@@ -272,6 +248,10 @@ void Image::Init(Handle<Object> target)
                FunctionTemplate::New(DrawImage)->GetFunction());
     proto->Set(String::NewSymbol("toBuffer"),
                FunctionTemplate::New(ToBuffer)->GetFunction());
+    proto->Set(String::NewSymbol("compress"),
+               FunctionTemplate::New(Compress)->GetFunction());
+    proto->Set(String::NewSymbol("toRunLength"),
+               FunctionTemplate::New(ToRunLength)->GetFunction());
     target->Set(String::NewSymbol("Image"),
                 Persistent<Function>::New(constructor_template->GetFunction()));
 }
@@ -560,6 +540,54 @@ Handle<Value> Image::Unsharp(const Arguments &args)
     }
 }
 
+Handle<Value> Image::GaussianBlur(const Arguments &args)
+{
+    HandleScope scope;
+    Image *obj = ObjectWrap::Unwrap<Image>(args.This());
+    if (args[0]->IsNumber() && (args.Length() < 2 || Image::HasInstance(args[1]))) {
+        float sigma = static_cast<float>(args[0]->NumberValue());
+        if (obj->pix_->d != 8 && obj->pix_->d != 32) {
+            return THROW(Error, "expected 8bpp or 32bpp image");
+        }
+        Pix *target = args.Length() < 2 ? NULL : Image::Pixels(args[1]->ToObject());
+        Pix *pixd = gaussianBlur(target, obj->pix_, sigma);
+        if (pixd == NULL) {
+            return THROW(Error, "error while applying gaussian blur");
+        }
+        if (target) {
+            return scope.Close(args[1]);
+        }
+        return scope.Close(Image::New(pixd));
+    } else {
+        return THROW(TypeError, "expected (sigma: Number, [target: Image])");
+    }
+}
+
+Handle<Value> Image::BoxBlur(const Arguments &args)
+{
+    HandleScope scope;
+    Image *obj = ObjectWrap::Unwrap<Image>(args.This());
+    if (args[0]->IsNumber() && args[1]->IsNumber()
+            && (args.Length() < 3 || Image::HasInstance(args[2]))) {
+        int halfWidth = static_cast<int>(ceil(args[0]->NumberValue()));
+        int halfHeight = static_cast<int>(ceil(args[1]->NumberValue()));
+        if (obj->pix_->d != 8 && obj->pix_->d != 32) {
+            return THROW(Error, "expected 8bpp or 32bpp image");
+        }
+        Pix *target = args.Length() < 3 ? NULL : Image::Pixels(args[2]->ToObject());
+        Pix *pixd = boxBlur(target, obj->pix_, halfWidth, halfHeight);
+        if (pixd == NULL) {
+            return THROW(Error, "error while applying box blur");
+        }
+        if (target) {
+            return scope.Close(args[2]);
+        }
+        return scope.Close(Image::New(pixd));
+    } else {
+        return THROW(TypeError, "expected (halfWidth: Number, halfHeight: Number, [target: Image])");
+    }
+}
+
 Handle<Value> Image::Rotate(const Arguments &args)
 {
     HandleScope scope;
@@ -583,16 +611,50 @@ Handle<Value> Image::Scale(const Arguments &args)
 {
     HandleScope scope;
     Image *obj = ObjectWrap::Unwrap<Image>(args.This());
-    if (args[0]->IsNumber() && (args.Length() != 2 || args[1]->IsNumber())) {
+    int filterIndex = args[1]->IsNumber() ? 2 : 1;
+    if (args[0]->IsNumber() && (args.Length() <= filterIndex || args[filterIndex]->IsString())) {
         float scaleX = static_cast<float>(args[0]->NumberValue());
-        float scaleY = static_cast<float>(args.Length() == 2 ? args[1]->NumberValue() : scaleX);
-        Pix *pixd = pixScale(obj->pix_, scaleX, scaleY);
+        float scaleY = static_cast<float>(filterIndex == 2 ? args[1]->NumberValue() : scaleX);
+        int width = static_cast<int>(scaleX * pixGetWidth(obj->pix_) + 0.5);
+        int height = static_cast<int>(scaleY * pixGetHeight(obj->pix_) + 0.5);
+        // Shrink by averaging and enlarge by interpolation, unless told otherwise.
+        ResampleFilter filterX = scaleX < 1 ? RESAMPLE_AREA : RESAMPLE_BILINEAR;
+        ResampleFilter filterY = scaleY < 1 ? RESAMPLE_AREA : RESAMPLE_BILINEAR;
+        bool hasFilter = args.Length() > filterIndex;
+        if (hasFilter) {
+            String::AsciiValue filter(args[filterIndex]->ToString());
+            if (strcmp("area", *filter) == 0) {
+                filterX = filterY = RESAMPLE_AREA;
+            } else if (strcmp("bilinear", *filter) == 0) {
+                filterX = filterY = RESAMPLE_BILINEAR;
+            } else if (strcmp("lanczos", *filter) == 0) {
+                filterX = filterY = RESAMPLE_LANCZOS3;
+            } else {
+                return THROW(TypeError, "expected filter to be 'area', 'bilinear' or 'lanczos'");
+            }
+        }
+        Pix *pixd = NULL;
+        int depth = pixGetDepth(obj->pix_);
+        if (width < 1 || height < 1) {
+            return THROW(TypeError, "scaled image would be empty");
+        } else if ((depth == 8 || depth == 32) && pixGetColormap(obj->pix_) == NULL) {
+            pixd = resample(obj->pix_, width, height, filterX, filterY);
+        } else if (depth == 1 && hasFilter && scaleX == scaleY && scaleX < 1) {
+            // Binary images are only turned gray when a filter is asked for.
+            pixd = pixScaleToGray(obj->pix_, scaleX);
+        } else if (depth == 1 && hasFilter) {
+            Pix *pixt = pixConvert1To8(NULL, obj->pix_, 255, 0);
+            pixd = resample(pixt, width, height, filterX, filterY);
+            pixDestroy(&pixt);
+        } else {
+            pixd = pixScale(obj->pix_, scaleX, scaleY);
+        }
         if (pixd == NULL) {
             return THROW(TypeError, "error while scaling");
         }
         return scope.Close(Image::New(pixd));
     } else {
-        return THROW(TypeError, "expected (scaleX: Number, [scaleY: Number])");
+        return THROW(TypeError, "expected (scaleX: Number, [scaleY: Number], [filter: String])");
     }
 }
 
@@ -682,16 +744,42 @@ Handle<Value> Image::Projection(const Arguments &args)
         if (obj->pix_->d != 8 && obj->pix_->d != 1) {
             return THROW(Error, "expected 8bpp or 1bpp image");
         }
-        std::vector<uint32_t> values;
-        pixProjection(values, obj->pix_, modeEnum);
-        Local<Array> result = Array::New(static_cast<int>(values.size()));
-        for (int i = 0; i < values.size(); i++) {
-            result->Set(i, Number::New(values[i]));
+        int start = 1;
+        PIX *mask = 0;
+        if (Image::HasInstance(args[1])) {
+            mask = Image::Pixels(args[1]->ToObject());
+            if (mask->d != 1 || mask->w != obj->pix_->w || mask->h != obj->pix_->h) {
+                return THROW(Error, "expected mask to be a 1bpp image of the same size");
+            }
+            start = 2;
+        }
+        int x = 0;
+        int y = 0;
+        int width = obj->pix_->w;
+        int height = obj->pix_->h;
+        if (!args[start]->IsUndefined()) {
+            BOX *box = toBox(args, start);
+            if (!box) {
+                return THROW(TypeError, "expected (mode: String, [mask: Image], [box: Box])");
+            }
+            // Clip the box to the image; the parts outside count as empty.
+            int x1 = std::min(box->x + box->w, width);
+            int y1 = std::min(box->y + box->h, height);
+            x = std::max(box->x, 0);
+            y = std::max(box->y, 0);
+            width = std::max(x1 - x, 0);
+            height = std::max(y1 - y, 0);
+            boxDestroy(&box);
         }
+        void *data;
+        Local<Object> result = createTypedArray(
+                    "Uint32Array", modeEnum == Horizontal ? width : height, &data);
+        pixProjection(static_cast<l_uint32 *>(data), obj->pix_, mask, modeEnum,
+                      x, y, width, height);
         return scope.Close(result);
     }
     else {
-        return THROW(TypeError, "expected (mode: String)");
+        return THROW(TypeError, "expected (mode: String, [mask: Image], [box: Box])");
     }
 }
 
@@ -890,7 +978,7 @@ Handle<Value> Image::Erode(const Arguments &args)
         int height = static_cast<int>(ceil(args[1]->NumberValue()));
         PIX *pixd = 0;
         if (obj->pix_->d == 1) {
-            pixd = pixErodeBrick(NULL, obj->pix_, width, height);
+            pixd = pixErodeBrickChainDwa(obj->pix_, width, height);
         } else {
             pixd = pixErodeGray(obj->pix_, width, height);
         }
@@ -912,7 +1000,7 @@ Handle<Value> Image::Dilate(const Arguments &args)
         int height = static_cast<int>(ceil(args[1]->NumberValue()));
         PIX *pixd = 0;
         if (obj->pix_->d == 1) {
-            pixd = pixDilateBrick(NULL, obj->pix_, width, height);
+            pixd = pixDilateBrickChainDwa(obj->pix_, width, height);
         } else {
             pixd = pixDilateGray(obj->pix_, width, height);
         }
@@ -934,7 +1022,7 @@ Handle<Value> Image::Open(const Arguments &args)
         int height = static_cast<int>(ceil(args[1]->NumberValue()));
         PIX *pixd = 0;
         if (obj->pix_->d == 1) {
-            pixd = pixOpenBrick(NULL, obj->pix_, width, height);
+            pixd = pixOpenBrickChainDwa(obj->pix_, width, height);
         } else {
             pixd = pixOpenGray(obj->pix_, width, height);
         }
@@ -956,7 +1044,7 @@ Handle<Value> Image::Close(const Arguments &args)
         int height = static_cast<int>(ceil(args[1]->NumberValue()));
         PIX *pixd = 0;
         if (obj->pix_->d == 1) {
-            pixd = pixCloseBrick(NULL, obj->pix_, width, height);
+            pixd = pixCloseBrickChainDwa(obj->pix_, width, height);
         } else {
             pixd = pixCloseGray(obj->pix_, width, height);
         }
@@ -969,6 +1057,31 @@ Handle<Value> Image::Close(const Arguments &args)
     }
 }
 
+Handle<Value> Image::MorphSequence(const Arguments &args)
+{
+    HandleScope scope;
+    Image *obj = ObjectWrap::Unwrap<Image>(args.This());
+    if (args[0]->IsString()) {
+        String::AsciiValue sequence(args[0]->ToString());
+        PIX *pixd = 0;
+        if (obj->pix_->d == 1) {
+            pixd = pixMorphSequenceDwa(obj->pix_, *sequence, 0);
+        } else if (obj->pix_->d == 8) {
+            pixd = pixGrayMorphSequence(obj->pix_, *sequence, 0, 0);
+        } else if (obj->pix_->d == 32) {
+            pixd = pixColorMorphSequence(obj->pix_, *sequence, 0, 0);
+        } else {
+            return THROW(Error, "expected 1bpp, 8bpp or 32bpp image");
+        }
+        if (pixd == NULL) {
+            return THROW(Error, "error while applying morphology sequence");
+        }
+        return scope.Close(Image::New(pixd));
+    } else {
+        return THROW(TypeError, "expected (sequence: String)");
+    }
+}
+
 Handle<Value> Image::Thin(const Arguments &args)
 {
     HandleScope scope;
@@ -1075,6 +1188,23 @@ Handle<Value> Image::FindSkew(const Arguments &args)
     }
 }
 
+Handle<Value> Image::Deskew(const Arguments &args)
+{
+    HandleScope scope;
+    Image *obj = ObjectWrap::Unwrap<Image>(args.This());
+    float angle;
+    float conf;
+    Pix *pixd = deskew(obj->pix_, &angle, &conf);
+    if (pixd == NULL) {
+        return THROW(TypeError, "error while deskewing");
+    }
+    Local<Object> object = Object::New();
+    object->Set(String::NewSymbol("image"), Image::New(pixd));
+    object->Set(String::NewSymbol("angle"), Number::New(angle));
+    object->Set(String::NewSymbol("confidence"), Number::New(conf));
+    return scope.Close(object);
+}
+
 Handle<Value> Image::ConnectedComponents(const Arguments &args)
 {
     HandleScope scope;
@@ -1440,6 +1570,24 @@ Handle<Value> Image::ToBuffer(const Arguments &args)
     }
 }
 
+Handle<Value> Image::Compress(const Arguments &args)
+{
+    HandleScope scope;
+    Image *obj = ObjectWrap::Unwrap<Image>(args.This());
+    return scope.Close(CompressedImage::New(obj->pix_));
+}
+
+Handle<Value> Image::ToRunLength(const Arguments &args)
+{
+    HandleScope scope;
+    Image *obj = ObjectWrap::Unwrap<Image>(args.This());
+    RunLength *runs = RunLength::FromPix(obj->pix_);
+    if (runs == NULL) {
+        return THROW(TypeError, "expected binarized image");
+    }
+    return scope.Close(RunLengthImage::New(runs));
+}
+
 Image::Image(Pix *pix)
     : pix_(pix)
 {
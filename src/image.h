@@ -57,6 +57,8 @@ private:
     static v8::Handle<v8::Value> Subtract(const v8::Arguments& args);
     static v8::Handle<v8::Value> Convolve(const v8::Arguments& args);
     static v8::Handle<v8::Value> Unsharp(const v8::Arguments& args);
+    static v8::Handle<v8::Value> GaussianBlur(const v8::Arguments& args);
+    static v8::Handle<v8::Value> BoxBlur(const v8::Arguments& args);
     static v8::Handle<v8::Value> Rotate(const v8::Arguments& args);
     static v8::Handle<v8::Value> Scale(const v8::Arguments& args);
     static v8::Handle<v8::Value> Crop(const v8::Arguments& args);
@@ -77,10 +79,12 @@ private:
     static v8::Handle<v8::Value> Dilate(const v8::Arguments& args);
     static v8::Handle<v8::Value> Open(const v8::Arguments& args);
     static v8::Handle<v8::Value> Close(const v8::Arguments& args);
+    static v8::Handle<v8::Value> MorphSequence(const v8::Arguments& args);
     static v8::Handle<v8::Value> Thin(const v8::Arguments& args);
     static v8::Handle<v8::Value> MaxDynamicRange(const v8::Arguments &args);
     static v8::Handle<v8::Value> OtsuAdaptiveThreshold(const v8::Arguments& args);
     static v8::Handle<v8::Value> FindSkew(const v8::Arguments& args);
+    static v8::Handle<v8::Value> Deskew(const v8::Arguments& args);
     static v8::Handle<v8::Value> ConnectedComponents(const v8::Arguments& args);
     static v8::Handle<v8::Value> DistanceFunction(const v8::Arguments& args);
     static v8::Handle<v8::Value> ClearBox(const v8::Arguments& args);
@@ -88,6 +92,8 @@ private:
     static v8::Handle<v8::Value> DrawBox(const v8::Arguments& args);
     static v8::Handle<v8::Value> DrawImage(const v8::Arguments& args);
     static v8::Handle<v8::Value> ToBuffer(const v8::Arguments& args);
+    static v8::Handle<v8::Value> Compress(const v8::Arguments& args);
+    static v8::Handle<v8::Value> ToRunLength(const v8::Arguments& args);
 
     Image(Pix *pix);
     ~Image();
@@ -0,0 +1,189 @@
+/*
+ * Copyright (c) 2012 Christoph Schulz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "imagereader.h"
+#include "image.h"
+#include "tiffreader.h"
+#include "util.h"
+#include <node_buffer.h>
+#include <sstream>
+
+using namespace v8;
+using namespace node;
+
+namespace binding {
+
+Persistent<FunctionTemplate> ImageReader::constructor_template;
+
+void ImageReader::Init(Handle<Object> target)
+{
+    constructor_template = Persistent<FunctionTemplate>::New(FunctionTemplate::New(New));
+    constructor_template->SetClassName(String::NewSymbol("ImageReader"));
+    constructor_template->InstanceTemplate()->SetInternalFieldCount(1);
+    Local<ObjectTemplate> proto = constructor_template->PrototypeTemplate();
+    proto->SetAccessor(String::NewSymbol("pageCount"), GetPageCount);
+    proto->Set(String::NewSymbol("page"),
+               FunctionTemplate::New(Page)->GetFunction());
+    proto->Set(String::NewSymbol("next"),
+               FunctionTemplate::New(Next)->GetFunction());
+    target->Set(String::NewSymbol("ImageReader"),
+                Persistent<Function>::New(constructor_template->GetFunction()));
+}
+
+Handle<Value> ImageReader::New(const Arguments &args)
+{
+    HandleScope scope;
+    if (args.Length() == 2 && args[0]->IsString() &&
+            (args[1]->IsString() || Buffer::HasInstance(args[1]))) {
+        String::AsciiValue format(args[0]->ToString());
+        if (strcmp("tiff", *format) != 0) {
+            std::stringstream msg;
+            msg << "invalid format '" << *format << "'";
+            return THROW(Error, msg.str().c_str());
+        }
+        std::string error;
+        TiffReader *reader;
+        if (args[1]->IsString()) {
+            String::Utf8Value filename(args[1]->ToString());
+            reader = TiffReader::Open(*filename, error);
+        } else {
+            Local<Object> buffer = args[1]->ToObject();
+            reader = TiffReader::Open(reinterpret_cast<l_uint8 *>(Buffer::Data(buffer)),
+                                      Buffer::Length(buffer), error);
+        }
+        if (reader == NULL) {
+            std::stringstream msg;
+            msg << "error while opening '" << error << "'";
+            return THROW(Error, msg.str().c_str());
+        }
+        ImageReader *obj = new ImageReader(reader);
+        if (Buffer::HasInstance(args[1])) {
+            obj->buffer_ = Persistent<Object>::New(args[1]->ToObject());
+        }
+        obj->Wrap(args.This());
+        obj->Prefetch(0);
+        return args.This();
+    } else {
+        return THROW(TypeError, "expected (format: String, file: String) or "
+                     "(format: String, image: Buffer)");
+    }
+}
+
+Handle<Value> ImageReader::GetPageCount(Local<String> prop, const AccessorInfo &info)
+{
+    HandleScope scope;
+    ImageReader *obj = ObjectWrap::Unwrap<ImageReader>(info.This());
+    return scope.Close(Number::New(obj->reader_->PageCount()));
+}
+
+Handle<Value> ImageReader::Page(const Arguments &args)
+{
+    HandleScope scope;
+    ImageReader *obj = ObjectWrap::Unwrap<ImageReader>(args.This());
+    if (args[0]->IsInt32()) {
+        int index = args[0]->Int32Value();
+        if (index < 0 || index >= obj->reader_->PageCount()) {
+            return THROW(Error, "page index out of range");
+        }
+        std::string error;
+        Pix *pix = obj->TakePage(index, error);
+        if (pix == NULL) {
+            std::stringstream msg;
+            msg << "error while reading page '" << error << "'";
+            return THROW(Error, msg.str().c_str());
+        }
+        obj->next_ = index + 1;
+        return scope.Close(Image::New(pix));
+    } else {
+        return THROW(TypeError, "expected (index: Int32)");
+    }
+}
+
+Handle<Value> ImageReader::Next(const Arguments &args)
+{
+    HandleScope scope;
+    ImageReader *obj = ObjectWrap::Unwrap<ImageReader>(args.This());
+    if (obj->next_ >= obj->reader_->PageCount()) {
+        return scope.Close(Null());
+    }
+    std::string error;
+    Pix *pix = obj->TakePage(obj->next_, error);
+    if (pix == NULL) {
+        std::stringstream msg;
+        msg << "error while reading page '" << error << "'";
+        return THROW(Error, msg.str().c_str());
+    }
+    obj->next_++;
+    return scope.Close(Image::New(pix));
+}
+
+ImageReader::ImageReader(TiffReader *reader)
+    : reader_(reader), next_(0), worker_(NULL), prefetchIndex_(-1), prefetched_(NULL)
+{
+}
+
+ImageReader::~ImageReader()
+{
+    if (worker_) {
+        joinWorker(worker_);
+    }
+    pixDestroy(&prefetched_);
+    delete reader_;
+    buffer_.Dispose();
+}
+
+Pix *ImageReader::TakePage(int index, std::string &error)
+{
+    // The reader may only be used by one thread at a time.
+    if (worker_) {
+        joinWorker(worker_);
+        worker_ = NULL;
+    }
+    Pix *pix;
+    if (index == prefetchIndex_) {
+        pix = prefetched_;
+        prefetched_ = NULL;
+        error = prefetchError_;
+    } else {
+        pixDestroy(&prefetched_);
+        pix = reader_->ReadPage(index, error);
+    }
+    Prefetch(index + 1);
+    return pix;
+}
+
+void ImageReader::Prefetch(int index)
+{
+    prefetchIndex_ = -1;
+    if (index < reader_->PageCount()) {
+        prefetchIndex_ = index;
+        worker_ = startWorker(PrefetchPage, this);
+    }
+}
+
+void *ImageReader::PrefetchPage(void *arg)
+{
+    ImageReader *obj = static_cast<ImageReader *>(arg);
+    obj->prefetched_ = obj->reader_->ReadPage(obj->prefetchIndex_, obj->prefetchError_);
+    return 0;
+}
+
+}
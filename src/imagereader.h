@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2012 Christoph Schulz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef IMAGEREADER_H
+#define IMAGEREADER_H
+
+#include <v8.h>
+#include <node.h>
+#include <allheaders.h>
+#include <string>
+
+struct Worker;
+
+namespace binding {
+
+class TiffReader;
+
+// Reads the pages of a multi-page document one at a time. While a page is
+// in use, the page after it is decoded in the background.
+class ImageReader : public node::ObjectWrap
+{
+public:
+    static v8::Persistent<v8::FunctionTemplate> constructor_template;
+
+    static void Init(v8::Handle<v8::Object> target);
+
+private:
+    static v8::Handle<v8::Value> New(const v8::Arguments& args);
+
+    // Accessors.
+    static v8::Handle<v8::Value> GetPageCount(v8::Local<v8::String> prop, const v8::AccessorInfo &info);
+
+    // Methods.
+    static v8::Handle<v8::Value> Page(const v8::Arguments& args);
+    static v8::Handle<v8::Value> Next(const v8::Arguments& args);
+
+    ImageReader(TiffReader *reader);
+    ~ImageReader();
+
+    // Returns page index, from the prefetch if it has it, and starts
+    // prefetching the page after it.
+    Pix *TakePage(int index, std::string &error);
+    void Prefetch(int index);
+    static void *PrefetchPage(void *arg);
+
+    TiffReader *reader_;
+    v8::Persistent<v8::Object> buffer_;     // The buffer read from, if any.
+    int next_;                              // The page next() returns.
+    Worker *worker_;                        // Decodes prefetchIndex_, if set.
+    int prefetchIndex_;
+    Pix *prefetched_;
+    std::string prefetchError_;
+};
+
+}
+
+#endif
@@ -21,17 +21,28 @@
  */
 #include <node.h>
 #include "image.h"
+#include "compressedimage.h"
+#include "imagereader.h"
+#include "pixpool.h"
+#include "runlengthimage.h"
 #include "tesseract.h"
 #include "zxing.h"
+#include "barcodetracker.h"
 #include "Matrix.h"
 
 using namespace v8;
 
 extern "C" void init(Handle<Object> target) 
 {
+    // Comes first, as the pool must see every pix that is allocated.
+    binding::PixPool::Init(target);
     binding::Image::Init(target);
+    binding::CompressedImage::Init(target);
+    binding::ImageReader::Init(target);
+    binding::RunLengthImage::Init(target);
     binding::Tesseract::Init(target);
     binding::ZXing::Init(target);
+    binding::BarcodeTracker::Init(target);
     binding::Matrix::Init(target);
 }
 
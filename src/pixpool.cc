@@ -0,0 +1,248 @@
+/*
+ * Copyright (c) 2012 Christoph Schulz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "pixpool.h"
+#include "util.h"
+#include <cstdlib>
+#include <map>
+#include <vector>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+using namespace v8;
+
+namespace binding {
+
+namespace {
+
+// Precedes each buffer handed to leptonica. A capacity of 0 marks buffers
+// that bypass the pool. The padding keeps the data 16 byte aligned.
+union Header {
+    size_t capacity;
+    double align[2];
+};
+
+typedef std::map<size_t, std::vector<Header *> > FreeLists;
+
+FreeLists freeLists;
+PixPool::Stats stats = { 0, 0, 0, 0, 64 << 20, 64 << 10 };
+
+#ifdef _WIN32
+CRITICAL_SECTION mutex;
+
+void initMutex() { InitializeCriticalSection(&mutex); }
+void lockMutex() { EnterCriticalSection(&mutex); }
+void unlockMutex() { LeaveCriticalSection(&mutex); }
+#else
+pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+
+void initMutex() {}
+void lockMutex() { pthread_mutex_lock(&mutex); }
+void unlockMutex() { pthread_mutex_unlock(&mutex); }
+#endif
+
+class Lock
+{
+public:
+    Lock() { lockMutex(); }
+    ~Lock() { unlockMutex(); }
+};
+
+// Rounds size up to its class. There are four classes per power of two,
+// so at most a quarter of a buffer goes unused; classes are whole pages.
+size_t sizeClass(size_t size)
+{
+    size_t step = 4096;
+    while (step * 8 <= size) {
+        step *= 2;
+    }
+    return (size + step - 1) & ~(step - 1);
+}
+
+// Takes held buffers out of the pool, largest first, until at most
+// capacity bytes of buffers of at least minBufferSize are left. Must be
+// called with the lock held; the buffers are freed by the caller.
+void evict(std::vector<Header *> &evicted, size_t capacity, size_t minBufferSize)
+{
+    for (FreeLists::reverse_iterator it = freeLists.rbegin(); it != freeLists.rend(); ++it) {
+        std::vector<Header *> &list = it->second;
+        while (!list.empty() && (stats.bytesHeld > capacity || it->first < minBufferSize)) {
+            evicted.push_back(list.back());
+            list.pop_back();
+            stats.bytesHeld -= it->first;
+            stats.buffersHeld--;
+        }
+    }
+}
+
+void freeAll(const std::vector<Header *> &buffers)
+{
+    for (size_t i = 0; i < buffers.size(); ++i) {
+        free(buffers[i]);
+    }
+}
+
+double numberOption(Handle<Object> options, const char *name, double value)
+{
+    Local<Value> option = options->Get(String::NewSymbol(name));
+    return option->IsNumber() ? option->NumberValue() : value;
+}
+
+}
+
+void PixPool::Init(Handle<Object> target)
+{
+    initMutex();
+    // From here on every pix data buffer comes from Allocate() and goes back
+    // through Free(), which expect a header in front of it. So a buffer from
+    // plain malloc() must never be attached with pixSetData(), and the data
+    // of a pix must never be released with plain free(). Data taken with
+    // pixExtractData() goes back into a pix with pixSetData(), to be freed
+    // by pixDestroy().
+    setPixMemoryManager(&PixPool::Allocate, &PixPool::Free);
+
+    Local<Object> pool = Object::New();
+    pool->Set(String::NewSymbol("configure"),
+              FunctionTemplate::New(Configure)->GetFunction());
+    pool->Set(String::NewSymbol("clear"),
+              FunctionTemplate::New(Clear)->GetFunction());
+    pool->Set(String::NewSymbol("stats"),
+              FunctionTemplate::New(GetStats)->GetFunction());
+    target->Set(String::NewSymbol("pixPool"), pool);
+}
+
+void PixPool::Configure(size_t capacity, size_t minBufferSize)
+{
+    std::vector<Header *> evicted;
+    {
+        Lock lock;
+        stats.capacity = capacity;
+        stats.minBufferSize = minBufferSize;
+        evict(evicted, capacity, minBufferSize);
+    }
+    freeAll(evicted);
+}
+
+void PixPool::Clear()
+{
+    std::vector<Header *> evicted;
+    {
+        Lock lock;
+        evict(evicted, 0, 0);
+    }
+    freeAll(evicted);
+}
+
+PixPool::Stats PixPool::GetStats()
+{
+    Lock lock;
+    return stats;
+}
+
+void *PixPool::Allocate(size_t size)
+{
+    size_t capacity = 0;
+    {
+        Lock lock;
+        if (size >= stats.minBufferSize && stats.capacity > 0) {
+            capacity = sizeClass(size);
+            FreeLists::iterator it = freeLists.find(capacity);
+            if (it != freeLists.end() && !it->second.empty()) {
+                Header *header = it->second.back();
+                it->second.pop_back();
+                stats.bytesHeld -= capacity;
+                stats.buffersHeld--;
+                stats.hits++;
+                return header + 1;
+            }
+            stats.misses++;
+        }
+    }
+    Header *header = static_cast<Header *>(malloc(sizeof(Header) + (capacity ? capacity : size)));
+    if (!header) {
+        return 0;
+    }
+    header->capacity = capacity;
+    return header + 1;
+}
+
+void PixPool::Free(void *data)
+{
+    if (!data) {
+        return;
+    }
+    Header *header = static_cast<Header *>(data) - 1;
+    size_t capacity = header->capacity;
+    if (capacity > 0) {
+        Lock lock;
+        if (capacity >= stats.minBufferSize && stats.bytesHeld + capacity <= stats.capacity) {
+            freeLists[capacity].push_back(header);
+            stats.bytesHeld += capacity;
+            stats.buffersHeld++;
+            return;
+        }
+    }
+    free(header);
+}
+
+Handle<Value> PixPool::Configure(const Arguments &args)
+{
+    HandleScope scope;
+    if (args[0]->IsObject()) {
+        Local<Object> options = args[0]->ToObject();
+        Stats current = GetStats();
+        double capacity = numberOption(options, "capacity", current.capacity);
+        double minBufferSize = numberOption(options, "minBufferSize", current.minBufferSize);
+        if (capacity < 0 || minBufferSize < 0) {
+            return THROW(TypeError, "expected capacity and minBufferSize to be positive");
+        }
+        Configure(static_cast<size_t>(capacity), static_cast<size_t>(minBufferSize));
+        return scope.Close(Undefined());
+    } else {
+        return THROW(TypeError, "expected (options: Object)");
+    }
+}
+
+Handle<Value> PixPool::Clear(const Arguments &args)
+{
+    HandleScope scope;
+    Clear();
+    return scope.Close(Undefined());
+}
+
+Handle<Value> PixPool::GetStats(const Arguments &args)
+{
+    HandleScope scope;
+    Stats current = GetStats();
+    Local<Object> result = Object::New();
+    result->Set(String::NewSymbol("hits"), Number::New(current.hits));
+    result->Set(String::NewSymbol("misses"), Number::New(current.misses));
+    result->Set(String::NewSymbol("bytesHeld"), Number::New(current.bytesHeld));
+    result->Set(String::NewSymbol("buffersHeld"), Number::New(current.buffersHeld));
+    result->Set(String::NewSymbol("capacity"), Number::New(current.capacity));
+    result->Set(String::NewSymbol("minBufferSize"), Number::New(current.minBufferSize));
+    return scope.Close(result);
+}
+
+}
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2012 Christoph Schulz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef PIXPOOL_H
+#define PIXPOOL_H
+
+#include <v8.h>
+#include <node.h>
+#include <stddef.h>
+
+namespace binding {
+
+// Recycles the data buffers of pix, which leptonica allocates through
+// setPixMemoryManager. Freed buffers are kept by size class, up to a total
+// capacity, and handed out again for pix of a similar size, so that large
+// images created and destroyed over and over neither go back to malloc nor
+// have their pages faulted in again. The pool is shared by all threads.
+class PixPool
+{
+public:
+    struct Stats {
+        size_t hits;            // Allocations served from the pool.
+        size_t misses;          // Pooled sizes that had to be allocated.
+        size_t bytesHeld;       // Bytes in the pool, waiting for reuse.
+        size_t buffersHeld;
+        size_t capacity;        // Most bytes the pool holds.
+        size_t minBufferSize;   // Smaller buffers bypass the pool.
+    };
+
+    // Installs the pool as leptonica's pix allocator and exports the pixPool
+    // object. Must run before any pix is allocated.
+    static void Init(v8::Handle<v8::Object> target);
+
+    // Changes the limits, releasing held buffers that no longer fit.
+    static void Configure(size_t capacity, size_t minBufferSize);
+    // Releases all held buffers.
+    static void Clear();
+    static Stats GetStats();
+
+    static void *Allocate(size_t size);
+    static void Free(void *data);
+
+private:
+    // JS methods.
+    static v8::Handle<v8::Value> Configure(const v8::Arguments& args);
+    static v8::Handle<v8::Value> Clear(const v8::Arguments& args);
+    static v8::Handle<v8::Value> GetStats(const v8::Arguments& args);
+};
+
+}
+
+#endif
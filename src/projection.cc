@@ -0,0 +1,232 @@
+/*
+ * Copyright (c) 2012 Christoph Schulz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "projection.h"
+#include <algorithm>
+#include <vector>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace binding {
+
+namespace {
+
+// Column counts are gathered in narrow counters for blocks of rows this
+// high, which cannot overflow them, and then added to the values.
+const int kBitRowsPerBlock = 255;
+const int kByteRowsPerBlock = 257;
+
+inline int popCount(l_uint32 word)
+{
+#ifdef __GNUC__
+    return __builtin_popcount(word);
+#else
+    word = word - ((word >> 1) & 0x55555555);
+    word = (word & 0x33333333) + ((word >> 2) & 0x33333333);
+    return (((word + (word >> 4)) & 0x0f0f0f0f) * 0x01010101) >> 24;
+#endif
+}
+
+// The bits of word i of a row that lie in the columns [x0, x1).
+inline l_uint32 rangeMask(int i, int x0, int x1)
+{
+    l_uint32 mask = 0xffffffff;
+    if (32 * i < x0) {
+        mask &= 0xffffffff >> (x0 - 32 * i);
+    }
+    if (32 * i + 32 > x1) {
+        mask &= ~(0xffffffff >> (x1 - 32 * i));
+    }
+    return mask;
+}
+
+// Adds the 32 bits of word to the counters of its columns.
+inline void addBits(l_uint8 *counts, l_uint32 word)
+{
+#ifdef __SSE2__
+    // Spread each byte over eight lanes, pick one bit per lane and turn the
+    // set ones into -1, which is subtracted.
+    const __m128i bits = _mm_set_epi8(1, 2, 4, 8, 16, 32, 64, -128,
+                                      1, 2, 4, 8, 16, 32, 64, -128);
+    for (int half = 0; half < 2; ++half, word <<= 16) {
+        __m128i spread = _mm_set_epi64x(0x0101010101010101ULL * ((word >> 16) & 0xff),
+                                        0x0101010101010101ULL * (word >> 24));
+        __m128i set = _mm_cmpeq_epi8(_mm_and_si128(spread, bits), bits);
+        __m128i *p = reinterpret_cast<__m128i *>(counts + 16 * half);
+        _mm_storeu_si128(p, _mm_sub_epi8(_mm_loadu_si128(p), set));
+    }
+#else
+    for (int k = 0; word != 0; ++k, word <<= 1) {
+        counts[k] += word >> 31;
+    }
+#endif
+}
+
+void projectBitRows(l_uint32 *values, Pix *pix, Pix *mask, int x0, int y0, int width, int height)
+{
+    int x1 = x0 + width;
+    int first = x0 >> 5;
+    int last = (x1 - 1) >> 5;
+    for (int y = 0; y < height; ++y) {
+        const l_uint32 *line = pixGetData(pix) + (y0 + y) * pixGetWpl(pix);
+        const l_uint32 *maskLine = mask ? pixGetData(mask) + (y0 + y) * pixGetWpl(mask) : NULL;
+        l_uint32 sum = 0;
+        for (int i = first; i <= last; ++i) {
+            l_uint32 word = line[i] & rangeMask(i, x0, x1);
+            sum += popCount(maskLine ? word & maskLine[i] : word);
+        }
+        values[y] = sum;
+    }
+}
+
+void projectBitColumns(l_uint32 *values, Pix *pix, Pix *mask, int x0, int y0, int width, int height)
+{
+    int x1 = x0 + width;
+    int first = x0 >> 5;
+    int last = (x1 - 1) >> 5;
+    std::vector<l_uint8> counts(32 * (last - first + 1));
+    std::fill(values, values + width, 0);
+    for (int block = 0; block < height; block += kBitRowsPerBlock) {
+        int rows = std::min(kBitRowsPerBlock, height - block);
+        std::fill(counts.begin(), counts.end(), 0);
+        for (int y = block; y < block + rows; ++y) {
+            const l_uint32 *line = pixGetData(pix) + (y0 + y) * pixGetWpl(pix);
+            const l_uint32 *maskLine = mask ? pixGetData(mask) + (y0 + y) * pixGetWpl(mask) : NULL;
+            for (int i = first; i <= last; ++i) {
+                l_uint32 word = line[i] & rangeMask(i, x0, x1);
+                if (maskLine) {
+                    word &= maskLine[i];
+                }
+                // Text pages are mostly white.
+                if (word != 0) {
+                    addBits(&counts[32 * (i - first)], word);
+                }
+            }
+        }
+        for (int x = 0; x < width; ++x) {
+            values[x] += counts[x0 - 32 * first + x];
+        }
+    }
+}
+
+void projectByteRows(l_uint32 *values, Pix *pix, Pix *mask, int x0, int y0, int width, int height)
+{
+    int x1 = x0 + width;
+    for (int y = 0; y < height; ++y) {
+        const l_uint32 *line = pixGetData(pix) + (y0 + y) * pixGetWpl(pix);
+        l_uint32 sum = 0;
+        if (mask) {
+            const l_uint32 *maskLine = pixGetData(mask) + (y0 + y) * pixGetWpl(mask);
+            for (int i = x0 >> 5; i <= (x1 - 1) >> 5; ++i) {
+                l_uint32 word = maskLine[i] & rangeMask(i, x0, x1);
+                for (int k = 0; word != 0; ++k, word <<= 1) {
+                    if (word & 0x80000000) {
+                        sum += GET_DATA_BYTE(line, 32 * i + k);
+                    }
+                }
+            }
+        } else {
+            // Whole words are summed regardless of the order of their bytes.
+            int first = (x0 + 3) >> 2;
+            int last = x1 >> 2;
+            for (int x = x0; x < std::min(4 * first, x1); ++x) {
+                sum += GET_DATA_BYTE(line, x);
+            }
+            const l_uint8 *bytes = reinterpret_cast<const l_uint8 *>(line + first);
+            for (int k = 0; k < 4 * (last - first); ++k) {
+                sum += bytes[k];
+            }
+            for (int x = std::max(4 * last, 4 * first); x < x1; ++x) {
+                sum += GET_DATA_BYTE(line, x);
+            }
+        }
+        values[y] = sum;
+    }
+}
+
+void projectByteColumns(l_uint32 *values, Pix *pix, Pix *mask, int x0, int y0, int width, int height)
+{
+    std::fill(values, values + width, 0);
+    if (mask) {
+        int x1 = x0 + width;
+        for (int y = 0; y < height; ++y) {
+            const l_uint32 *line = pixGetData(pix) + (y0 + y) * pixGetWpl(pix);
+            const l_uint32 *maskLine = pixGetData(mask) + (y0 + y) * pixGetWpl(mask);
+            for (int x = x0; x < x1; ++x) {
+                if (GET_DATA_BIT(maskLine, x)) {
+                    values[x - x0] += GET_DATA_BYTE(line, x);
+                }
+            }
+        }
+        return;
+    }
+    // Whole words of each row are added to 16 bit counters in memory order,
+    // which the compiler can vectorize; the order is sorted out at the end.
+    int first = x0 >> 2;
+    int last = (x0 + width + 3) >> 2;
+    int n = 4 * (last - first);
+    std::vector<l_uint16> counts(n);
+    for (int block = 0; block < height; block += kByteRowsPerBlock) {
+        int rows = std::min(kByteRowsPerBlock, height - block);
+        std::fill(counts.begin(), counts.end(), 0);
+        for (int y = block; y < block + rows; ++y) {
+            const l_uint8 *bytes = reinterpret_cast<const l_uint8 *>(
+                        pixGetData(pix) + (y0 + y) * pixGetWpl(pix) + first);
+            for (int k = 0; k < n; ++k) {
+                counts[k] += bytes[k];
+            }
+        }
+        for (int x = 0; x < width; ++x) {
+            int column = x0 - 4 * first + x;
+#ifdef L_BIG_ENDIAN
+            values[x] += counts[column];
+#else
+            values[x] += counts[column ^ 3];
+#endif
+        }
+    }
+}
+
+}
+
+void pixProjection(l_uint32 *values, Pix *pix, Pix *mask, ProjectionMode mode,
+                   int x, int y, int width, int height)
+{
+    if (width <= 0 || height <= 0) {
+        return;
+    }
+    if (pixGetDepth(pix) == 1) {
+        if (mode == Horizontal) {
+            projectBitColumns(values, pix, mask, x, y, width, height);
+        } else {
+            projectBitRows(values, pix, mask, x, y, width, height);
+        }
+    } else {
+        if (mode == Horizontal) {
+            projectByteColumns(values, pix, mask, x, y, width, height);
+        } else {
+            projectByteRows(values, pix, mask, x, y, width, height);
+        }
+    }
+}
+
+}
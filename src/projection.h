@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2012 Christoph Schulz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef PROJECTION_H
+#define PROJECTION_H
+
+#include <allheaders.h>
+
+namespace binding {
+
+enum ProjectionMode
+{
+    Horizontal = 1,
+    Vertical = 2
+};
+
+// Sums the pixels of pix (1 or 8 bpp) in the rectangle (x, y, width, height)
+// for each column (Horizontal) or row (Vertical) into values, which must
+// have room for width or height entries. If mask (1 bpp, same size as pix)
+// is given, only pixels where it is set count. The rectangle must lie
+// inside pix.
+void pixProjection(l_uint32 *values, Pix *pix, Pix *mask, ProjectionMode mode,
+                   int x, int y, int width, int height);
+
+}
+
+#endif
@@ -0,0 +1,277 @@
+/*
+ * Copyright (c) 2012 Christoph Schulz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "resample.h"
+#include "util.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace binding {
+
+namespace {
+
+// Images with fewer rows than this per band are not split further.
+const int kMinRowsPerBand = 64;
+const int kMaxBands = 8;
+
+// The weights of source pixels [first[i], first[i] + size) for each
+// destination pixel i, stored in weights[i * size...].
+struct FilterBank {
+    int size;
+    std::vector<int> first;
+    std::vector<float> weights;
+};
+
+// The destination rows [y0, y1) of one pass from pixs to pixd.
+struct Band {
+    const FilterBank *bank;
+    Pix *pixs;
+    Pix *pixd;
+    int y0;
+    int y1;
+};
+
+float support(ResampleFilter filter)
+{
+    return filter == RESAMPLE_BILINEAR ? 1.0f : 3.0f;
+}
+
+float sinc(float x)
+{
+    if (x == 0) {
+        return 1;
+    }
+    x *= 3.14159265f;
+    return std::sin(x) / x;
+}
+
+float weight(ResampleFilter filter, float x)
+{
+    if (filter == RESAMPLE_BILINEAR) {
+        return std::max(0.0f, 1.0f - std::fabs(x));
+    }
+    return (x > -3.0f && x < 3.0f) ? sinc(x) * sinc(x / 3) : 0.0f;
+}
+
+// The part of source pixel j that lies within [left, right).
+float coverage(int j, float left, float right)
+{
+    return std::max(0.0f, std::min(j + 1.0f, right) - std::max(static_cast<float>(j), left));
+}
+
+// Computes the weights for scaling src pixels to dst pixels. When shrinking,
+// the filter is stretched to cover all source pixels. The area filter
+// weighs the source pixels by how much of them a destination pixel covers,
+// when enlarging too.
+void makeFilterBank(FilterBank &bank, ResampleFilter filter, int src, int dst)
+{
+    float scale = static_cast<float>(src) / dst;
+    float stretch = std::max(scale, 1.0f);
+    bool area = filter == RESAMPLE_AREA;
+    float radius = area ? 0.5f * scale : support(filter) * stretch;
+    bank.size = static_cast<int>(std::ceil(radius)) * 2 + 1;
+    bank.first.resize(dst);
+    bank.weights.assign(dst * bank.size, 0.0f);
+    for (int i = 0; i < dst; ++i) {
+        float center = (i + 0.5f) * scale;
+        int first;
+        int last;
+        if (area) {
+            first = std::max(static_cast<int>(std::floor(center - radius)), 0);
+            last = std::min(static_cast<int>(std::ceil(center + radius)), src);
+        } else {
+            first = std::max(static_cast<int>(center - radius + 0.5f), 0);
+            last = std::min(static_cast<int>(center + radius + 0.5f), src);
+        }
+        last = std::min(last, first + bank.size);
+        float *weights = &bank.weights[i * bank.size];
+        float total = 0;
+        for (int j = first; j < last; ++j) {
+            weights[j - first] = area ? coverage(j, center - radius, center + radius)
+                                      : weight(filter, (j - center + 0.5f) / stretch);
+            total += weights[j - first];
+        }
+        if (total != 0) {
+            for (int j = first; j < last; ++j) {
+                weights[j - first] /= total;
+            }
+        }
+        // Keep all taps inside the source; the extra ones have no weight.
+        bank.first[i] = std::min(first, std::max(src - bank.size, 0));
+        if (bank.first[i] != first) {
+            std::rotate(weights, weights + bank.size - (first - bank.first[i]),
+                        weights + bank.size);
+        }
+    }
+    // Sources narrower than the filter are read with fewer taps.
+    if (bank.size > src) {
+        std::vector<float> weights(dst * src);
+        for (int i = 0; i < dst; ++i) {
+            std::copy(&bank.weights[i * bank.size], &bank.weights[i * bank.size] + src,
+                      &weights[i * src]);
+        }
+        bank.weights.swap(weights);
+        bank.size = src;
+    }
+}
+
+inline l_uint8 toByte(float value)
+{
+    return static_cast<l_uint8>(std::min(std::max(value + 0.5f, 0.0f), 255.0f));
+}
+
+inline l_uint8 *rowBytes(Pix *pix, int y)
+{
+    return reinterpret_cast<l_uint8 *>(pixGetData(pix) + y * pixGetWpl(pix));
+}
+
+// Scales the rows [y0, y1) of pixs horizontally into pixd.
+void *horizontalPass(void *arg)
+{
+    const Band &band = *static_cast<Band *>(arg);
+    const FilterBank &bank = *band.bank;
+    int ws = pixGetWidth(band.pixs);
+    int wd = pixGetWidth(band.pixd);
+    bool gray = pixGetDepth(band.pixs) == 8;
+    std::vector<float> line(gray ? ws : 0);
+    for (int y = band.y0; y < band.y1; ++y) {
+        if (gray) {
+            const l_uint32 *lines = pixGetData(band.pixs) + y * pixGetWpl(band.pixs);
+            l_uint32 *lined = pixGetData(band.pixd) + y * pixGetWpl(band.pixd);
+            for (int x = 0; x < ws; ++x) {
+                line[x] = GET_DATA_BYTE(lines, x);
+            }
+            for (int x = 0; x < wd; ++x) {
+                const float *weights = &bank.weights[x * bank.size];
+                const float *src = &line[bank.first[x]];
+                float sum = 0;
+                for (int k = 0; k < bank.size; ++k) {
+                    sum += weights[k] * src[k];
+                }
+                SET_DATA_BYTE(lined, x, toByte(sum));
+            }
+        } else {
+            // The bytes of each pixel are filtered alike, in memory order.
+            const l_uint8 *rows = rowBytes(band.pixs, y);
+            l_uint8 *rowd = rowBytes(band.pixd, y);
+            for (int x = 0; x < wd; ++x) {
+                const float *weights = &bank.weights[x * bank.size];
+                const l_uint8 *src = rows + 4 * bank.first[x];
+                float sum[4] = {0, 0, 0, 0};
+                for (int k = 0; k < bank.size; ++k) {
+                    for (int c = 0; c < 4; ++c) {
+                        sum[c] += weights[k] * src[4 * k + c];
+                    }
+                }
+                for (int c = 0; c < 4; ++c) {
+                    rowd[4 * x + c] = toByte(sum[c]);
+                }
+            }
+        }
+    }
+    return 0;
+}
+
+// Scales pixs vertically into the rows [y0, y1) of pixd. This works on
+// whole rows of bytes; the order of the bytes within the words does not
+// matter here.
+void *verticalPass(void *arg)
+{
+    const Band &band = *static_cast<Band *>(arg);
+    const FilterBank &bank = *band.bank;
+    int n = 4 * std::min(pixGetWpl(band.pixs), pixGetWpl(band.pixd));
+    std::vector<float> sum(n);
+    for (int y = band.y0; y < band.y1; ++y) {
+        const float *weights = &bank.weights[y * bank.size];
+        std::fill(sum.begin(), sum.end(), 0.0f);
+        for (int k = 0; k < bank.size; ++k) {
+            if (weights[k] == 0) {
+                continue;
+            }
+            const l_uint8 *row = rowBytes(band.pixs, bank.first[y] + k);
+            float weight = weights[k];
+            for (int i = 0; i < n; ++i) {
+                sum[i] += weight * row[i];
+            }
+        }
+        l_uint8 *rowd = rowBytes(band.pixd, y);
+        for (int i = 0; i < n; ++i) {
+            rowd[i] = toByte(sum[i]);
+        }
+    }
+    return 0;
+}
+
+// Runs pass over the rows of pixd in bands, each on its own thread.
+void runPass(void *(*pass)(void *), const FilterBank &bank, Pix *pixs, Pix *pixd)
+{
+    int height = pixGetHeight(pixd);
+    int count = std::max(1, std::min(std::min(numProcessors(), kMaxBands),
+                                     height / kMinRowsPerBand));
+    std::vector<Band> bands(count);
+    std::vector<void *> args(count);
+    for (int i = 0; i < count; ++i) {
+        bands[i].bank = &bank;
+        bands[i].pixs = pixs;
+        bands[i].pixd = pixd;
+        bands[i].y0 = height * i / count;
+        bands[i].y1 = height * (i + 1) / count;
+        args[i] = &bands[i];
+    }
+    runThreads(pass, &args[0], count);
+}
+
+}
+
+Pix *resample(Pix *pixs, int width, int height,
+              ResampleFilter filterX, ResampleFilter filterY)
+{
+    if (pixs == NULL || pixGetColormap(pixs) != NULL ||
+            (pixGetDepth(pixs) != 8 && pixGetDepth(pixs) != 32) ||
+            width < 1 || height < 1) {
+        return NULL;
+    }
+    int ws = pixGetWidth(pixs);
+    int hs = pixGetHeight(pixs);
+    int depth = pixGetDepth(pixs);
+    FilterBank bankX;
+    FilterBank bankY;
+    makeFilterBank(bankX, filterX, ws, width);
+    makeFilterBank(bankY, filterY, hs, height);
+    Pix *pixt = pixCreateNoInit(width, hs, depth);
+    Pix *pixd = pixCreateNoInit(width, height, depth);
+    if (pixt == NULL || pixd == NULL) {
+        pixDestroy(&pixt);
+        pixDestroy(&pixd);
+        return NULL;
+    }
+    runPass(horizontalPass, bankX, pixs, pixt);
+    runPass(verticalPass, bankY, pixt, pixd);
+    pixDestroy(&pixt);
+    pixCopyResolution(pixd, pixs);
+    pixScaleResolution(pixd, static_cast<float>(width) / ws,
+                       static_cast<float>(height) / hs);
+    pixCopyInputFormat(pixd, pixs);
+    return pixd;
+}
+
+}
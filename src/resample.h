@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) 2012 Christoph Schulz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef RESAMPLE_H
+#define RESAMPLE_H
+
+#include <allheaders.h>
+
+namespace binding {
+
+enum ResampleFilter {
+    RESAMPLE_AREA,      // Average of the covered pixels, weighted by coverage.
+    RESAMPLE_BILINEAR,  // Triangle, widened when shrinking.
+    RESAMPLE_LANCZOS3,  // Windowed sinc over three lobes.
+};
+
+// Scales pixs (8 or 32 bpp, without colormap) to width x height pixels,
+// with a separable filter for each direction. Returns NULL on error.
+Pix *resample(Pix *pixs, int width, int height,
+              ResampleFilter filterX, ResampleFilter filterY);
+
+}
+
+#endif
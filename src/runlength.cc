@@ -0,0 +1,314 @@
+/*
+ * Copyright (c) 2012 Christoph Schulz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "runlength.h"
+#include <algorithm>
+
+namespace binding {
+
+namespace {
+
+inline int countLeadingZeros(l_uint32 word)
+{
+#ifdef __GNUC__
+    return __builtin_clz(word);
+#else
+    int n = 0;
+    for (; !(word & 0x80000000); word <<= 1) {
+        ++n;
+    }
+    return n;
+#endif
+}
+
+// Sets the bits [x0, x1) of a row of a 1 bpp image.
+void setBits(l_uint32 *line, int x0, int x1)
+{
+    int first = x0 >> 5;
+    int last = (x1 - 1) >> 5;
+    l_uint32 head = 0xffffffff >> (x0 & 31);
+    l_uint32 tail = 0xffffffff << (31 - ((x1 - 1) & 31));
+    if (first == last) {
+        line[first] |= head & tail;
+    } else {
+        line[first] |= head;
+        std::fill(line + first + 1, line + last, 0xffffffff);
+        line[last] |= tail;
+    }
+}
+
+int findRoot(std::vector<int> &parent, int i)
+{
+    while (parent[i] != i) {
+        parent[i] = parent[parent[i]];
+        i = parent[i];
+    }
+    return i;
+}
+
+}
+
+RunLength::RunLength(int width, int height)
+    : width_(width), height_(height), rowStart_(1, 0)
+{
+    rowStart_.reserve(height + 1);
+}
+
+RunLength *RunLength::FromPix(Pix *pix)
+{
+    if (pix == NULL || pixGetDepth(pix) != 1) {
+        return NULL;
+    }
+    int width = pixGetWidth(pix);
+    int height = pixGetHeight(pix);
+    int wpl = pixGetWpl(pix);
+    RunLength *runs = new RunLength(width, height);
+    // Bits beyond the width in the last word of each row are ignored.
+    l_uint32 lastMask = 0xffffffff << ((32 - (width & 31)) & 31);
+    for (int y = 0; y < height; ++y) {
+        const l_uint32 *line = pixGetData(pix) + y * wpl;
+        bool inRun = false;
+        int start = 0;
+        for (int i = 0; i < wpl; ++i) {
+            l_uint32 word = i == wpl - 1 ? line[i] & lastMask : line[i];
+            // Most words are all background, or all inside a run.
+            if (word == (inRun ? 0xffffffff : 0)) {
+                continue;
+            }
+            for (int pos = 0; pos < 32; ) {
+                l_uint32 bits = (inRun ? ~word : word) << pos;
+                if (bits == 0) {
+                    break;
+                }
+                pos += countLeadingZeros(bits);
+                if (inRun) {
+                    runs->AddRun(start, 32 * i + pos);
+                } else {
+                    start = 32 * i + pos;
+                }
+                inRun = !inRun;
+            }
+        }
+        if (inRun) {
+            runs->AddRun(start, width);
+        }
+        runs->EndRow();
+    }
+    return runs;
+}
+
+Pix *RunLength::ToPix() const
+{
+    Pix *pixd = pixCreate(width_, height_, 1);
+    if (pixd == NULL) {
+        return NULL;
+    }
+    for (int y = 0; y < height_; ++y) {
+        l_uint32 *line = pixGetData(pixd) + y * pixGetWpl(pixd);
+        for (int k = rowStart_[y]; k < rowStart_[y + 1]; ++k) {
+            setBits(line, runs_[2 * k], runs_[2 * k + 1]);
+        }
+    }
+    return pixd;
+}
+
+int RunLength::Width() const
+{
+    return width_;
+}
+
+int RunLength::Height() const
+{
+    return height_;
+}
+
+int RunLength::RunCount() const
+{
+    return rowStart_.back();
+}
+
+void RunLength::ProjectColumns(std::vector<l_uint32> &values) const
+{
+    // Count where runs start and end, then sum up from the left.
+    std::vector<int> steps(width_ + 1, 0);
+    for (size_t i = 0; i < runs_.size(); i += 2) {
+        steps[runs_[i]]++;
+        steps[runs_[i + 1]]--;
+    }
+    values.resize(width_);
+    int count = 0;
+    for (int x = 0; x < width_; ++x) {
+        count += steps[x];
+        values[x] = count;
+    }
+}
+
+void RunLength::ProjectRows(std::vector<l_uint32> &values) const
+{
+    values.assign(height_, 0);
+    for (int y = 0; y < height_; ++y) {
+        for (int k = rowStart_[y]; k < rowStart_[y + 1]; ++k) {
+            values[y] += runs_[2 * k + 1] - runs_[2 * k];
+        }
+    }
+}
+
+Box *RunLength::BoundingBox() const
+{
+    int x0 = width_;
+    int x1 = 0;
+    int y0 = -1;
+    int y1 = 0;
+    for (int y = 0; y < height_; ++y) {
+        if (rowStart_[y] == rowStart_[y + 1]) {
+            continue;
+        }
+        // Runs are sorted, so only the outer ones matter.
+        x0 = std::min(x0, runs_[2 * rowStart_[y]]);
+        x1 = std::max(x1, runs_[2 * rowStart_[y + 1] - 1]);
+        if (y0 < 0) {
+            y0 = y;
+        }
+        y1 = y + 1;
+    }
+    if (y0 < 0) {
+        return NULL;
+    }
+    return boxCreate(x0, y0, x1 - x0, y1 - y0);
+}
+
+Boxa *RunLength::ConnectedComponents(int connectivity) const
+{
+    if (connectivity != 4 && connectivity != 8) {
+        return NULL;
+    }
+    // Runs of neighboring rows touch if they overlap, or also if they only
+    // meet at a corner for 8-connectivity.
+    int reach = connectivity == 8 ? 1 : 0;
+    int n = RunCount();
+    std::vector<int> parent(n);
+    for (int k = 0; k < n; ++k) {
+        parent[k] = k;
+    }
+    for (int y = 1; y < height_; ++y) {
+        int a = rowStart_[y - 1];
+        int b = rowStart_[y];
+        while (a < rowStart_[y] && b < rowStart_[y + 1]) {
+            if (runs_[2 * a] < runs_[2 * b + 1] + reach && runs_[2 * b] < runs_[2 * a + 1] + reach) {
+                int rootA = findRoot(parent, a);
+                int rootB = findRoot(parent, b);
+                // Keep the earliest run as root, so it names the component.
+                parent[std::max(rootA, rootB)] = std::min(rootA, rootB);
+            }
+            if (runs_[2 * a + 1] < runs_[2 * b + 1]) {
+                ++a;
+            } else {
+                ++b;
+            }
+        }
+    }
+
+    // Components are numbered by their first run in raster order, which is
+    // where pixConnCompBB finds them too.
+    std::vector<int> index(n, -1);
+    std::vector<int> boxes;
+    for (int y = 0; y < height_; ++y) {
+        for (int k = rowStart_[y]; k < rowStart_[y + 1]; ++k) {
+            int root = findRoot(parent, k);
+            if (index[root] < 0) {
+                index[root] = static_cast<int>(boxes.size() / 4);
+                boxes.push_back(runs_[2 * k]);
+                boxes.push_back(y);
+                boxes.push_back(runs_[2 * k + 1]);
+                boxes.push_back(y + 1);
+            }
+            int *box = &boxes[4 * index[root]];
+            box[0] = std::min(box[0], runs_[2 * k]);
+            box[2] = std::max(box[2], runs_[2 * k + 1]);
+            box[3] = y + 1;
+        }
+    }
+    int count = static_cast<int>(boxes.size() / 4);
+    Boxa *boxa = boxaCreate(count);
+    for (int i = 0; i < count; ++i) {
+        int *box = &boxes[4 * i];
+        boxaAddBox(boxa, boxCreate(box[0], box[1], box[2] - box[0], box[3] - box[1]), L_INSERT);
+    }
+    return boxa;
+}
+
+RunLength *RunLength::Combine(const RunLength &other, Op op) const
+{
+    if (width_ != other.width_ || height_ != other.height_) {
+        return NULL;
+    }
+    RunLength *result = new RunLength(width_, height_);
+    for (int y = 0; y < height_; ++y) {
+        // Walk the run boundaries of both rows from left to right, tracking
+        // whether each side is inside a run.
+        int a = 2 * rowStart_[y];
+        int aEnd = 2 * rowStart_[y + 1];
+        int b = 2 * other.rowStart_[y];
+        int bEnd = 2 * other.rowStart_[y + 1];
+        bool inA = false;
+        bool inB = false;
+        bool in = false;
+        int start = 0;
+        while (a < aEnd || b < bEnd) {
+            int x = std::min(a < aEnd ? runs_[a] : width_, b < bEnd ? other.runs_[b] : width_);
+            for (; a < aEnd && runs_[a] == x; ++a) {
+                inA = !inA;
+            }
+            for (; b < bEnd && other.runs_[b] == x; ++b) {
+                inB = !inB;
+            }
+            bool inResult = op == OP_AND ? inA && inB : op == OP_OR ? inA || inB : inA != inB;
+            if (inResult && !in) {
+                start = x;
+            } else if (!inResult && in) {
+                result->AddRun(start, x);
+            }
+            in = inResult;
+        }
+        result->EndRow();
+    }
+    return result;
+}
+
+void RunLength::AddRun(int x0, int x1)
+{
+    if (x0 >= x1) {
+        return;
+    }
+    if (runs_.size() > 2u * rowStart_.back() && runs_.back() == x0) {
+        runs_.back() = x1;
+    } else {
+        runs_.push_back(x0);
+        runs_.push_back(x1);
+    }
+}
+
+void RunLength::EndRow()
+{
+    rowStart_.push_back(static_cast<int>(runs_.size() / 2));
+}
+
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2012 Christoph Schulz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef RUNLENGTH_H
+#define RUNLENGTH_H
+
+#include <allheaders.h>
+#include <vector>
+
+namespace binding {
+
+// A binary image kept as the runs of foreground pixels in each row, so that
+// operations cost time by the amount of ink rather than the page area. The
+// runs of row y are the half open ranges [runs_[2k], runs_[2k + 1]) for
+// rowStart_[y] <= k < rowStart_[y + 1], left to right and never touching.
+class RunLength
+{
+public:
+    enum Op {
+        OP_AND,
+        OP_OR,
+        OP_XOR,
+    };
+
+    // Collects the runs of a 1 bpp image. Returns NULL on error.
+    static RunLength *FromPix(Pix *pix);
+    // Returns a new 1 bpp image with the runs drawn.
+    Pix *ToPix() const;
+
+    int Width() const;
+    int Height() const;
+    int RunCount() const;
+
+    // Counts the foreground pixels of each column, or each row.
+    void ProjectColumns(std::vector<l_uint32> &values) const;
+    void ProjectRows(std::vector<l_uint32> &values) const;
+    // Returns the bounding box of the foreground, or NULL if there is none.
+    Box *BoundingBox() const;
+    // Returns the bounding boxes of the 4 or 8 connected components, in the
+    // same order as pixConnCompBB.
+    Boxa *ConnectedComponents(int connectivity) const;
+    // Combines the pixels with those of other, which must have the same size.
+    RunLength *Combine(const RunLength &other, Op op) const;
+
+private:
+    RunLength(int width, int height);
+
+    void AddRun(int x0, int x1);
+    void EndRow();
+
+    int width_;
+    int height_;
+    std::vector<int> rowStart_;
+    std::vector<int> runs_;
+};
+
+}
+
+#endif
@@ -0,0 +1,242 @@
+/*
+ * Copyright (c) 2012 Christoph Schulz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "runlengthimage.h"
+#include "image.h"
+#include "util.h"
+#include <algorithm>
+#include <vector>
+
+using namespace v8;
+using namespace node;
+
+namespace binding {
+
+Persistent<FunctionTemplate> RunLengthImage::constructor_template;
+
+bool RunLengthImage::HasInstance(Handle<Value> val)
+{
+    if (!val->IsObject()) {
+        return false;
+    }
+    return constructor_template->HasInstance(val->ToObject());
+}
+
+void RunLengthImage::Init(Handle<Object> target)
+{
+    constructor_template = Persistent<FunctionTemplate>::New(FunctionTemplate::New(New));
+    constructor_template->SetClassName(String::NewSymbol("RunLengthImage"));
+    constructor_template->InstanceTemplate()->SetInternalFieldCount(1);
+    Local<ObjectTemplate> proto = constructor_template->PrototypeTemplate();
+    proto->SetAccessor(String::NewSymbol("width"), GetWidth);
+    proto->SetAccessor(String::NewSymbol("height"), GetHeight);
+    proto->SetAccessor(String::NewSymbol("runCount"), GetRunCount);
+    proto->Set(String::NewSymbol("or"),
+               FunctionTemplate::New(Or)->GetFunction());
+    proto->Set(String::NewSymbol("and"),
+               FunctionTemplate::New(And)->GetFunction());
+    proto->Set(String::NewSymbol("xor"),
+               FunctionTemplate::New(Xor)->GetFunction());
+    proto->Set(String::NewSymbol("projection"),
+               FunctionTemplate::New(Projection)->GetFunction());
+    proto->Set(String::NewSymbol("connectedComponents"),
+               FunctionTemplate::New(ConnectedComponents)->GetFunction());
+    proto->Set(String::NewSymbol("boundingBox"),
+               FunctionTemplate::New(BoundingBox)->GetFunction());
+    proto->Set(String::NewSymbol("toImage"),
+               FunctionTemplate::New(ToImage)->GetFunction());
+    target->Set(String::NewSymbol("RunLengthImage"),
+                Persistent<Function>::New(constructor_template->GetFunction()));
+}
+
+Handle<Value> RunLengthImage::New(RunLength *runs)
+{
+    HandleScope scope;
+    Local<Object> instance = constructor_template->GetFunction()->NewInstance();
+    RunLengthImage *obj = ObjectWrap::Unwrap<RunLengthImage>(instance);
+    obj->runs_ = runs;
+    if (obj->runs_) {
+        V8::AdjustAmountOfExternalAllocatedMemory(obj->size());
+    }
+    return scope.Close(instance);
+}
+
+Handle<Value> RunLengthImage::New(const Arguments &args)
+{
+    HandleScope scope;
+    RunLength *runs = NULL;
+    if (args.Length() == 1 && Image::HasInstance(args[0])) {
+        runs = RunLength::FromPix(Image::Pixels(args[0]->ToObject()));
+        if (runs == NULL) {
+            return THROW(TypeError, "expected binarized image");
+        }
+    } else if (args.Length() != 0) {
+        return THROW(TypeError, "expected (image: Image) or no arguments at all");
+    }
+    RunLengthImage *obj = new RunLengthImage(runs);
+    obj->Wrap(args.This());
+    return args.This();
+}
+
+Handle<Value> RunLengthImage::GetWidth(Local<String> prop, const AccessorInfo &info)
+{
+    HandleScope scope;
+    RunLengthImage *obj = ObjectWrap::Unwrap<RunLengthImage>(info.This());
+    return scope.Close(Number::New(obj->runs_ ? obj->runs_->Width() : 0));
+}
+
+Handle<Value> RunLengthImage::GetHeight(Local<String> prop, const AccessorInfo &info)
+{
+    HandleScope scope;
+    RunLengthImage *obj = ObjectWrap::Unwrap<RunLengthImage>(info.This());
+    return scope.Close(Number::New(obj->runs_ ? obj->runs_->Height() : 0));
+}
+
+Handle<Value> RunLengthImage::GetRunCount(Local<String> prop, const AccessorInfo &info)
+{
+    HandleScope scope;
+    RunLengthImage *obj = ObjectWrap::Unwrap<RunLengthImage>(info.This());
+    return scope.Close(Number::New(obj->runs_ ? obj->runs_->RunCount() : 0));
+}
+
+Handle<Value> RunLengthImage::Or(const Arguments &args)
+{
+    return Combine(args, RunLength::OP_OR);
+}
+
+Handle<Value> RunLengthImage::And(const Arguments &args)
+{
+    return Combine(args, RunLength::OP_AND);
+}
+
+Handle<Value> RunLengthImage::Xor(const Arguments &args)
+{
+    return Combine(args, RunLength::OP_XOR);
+}
+
+Handle<Value> RunLengthImage::Combine(const Arguments &args, RunLength::Op op)
+{
+    HandleScope scope;
+    RunLengthImage *obj = ObjectWrap::Unwrap<RunLengthImage>(args.This());
+    if (RunLengthImage::HasInstance(args[0])) {
+        RunLengthImage *other = ObjectWrap::Unwrap<RunLengthImage>(args[0]->ToObject());
+        RunLength *runs = NULL;
+        if (obj->runs_ && other->runs_) {
+            runs = obj->runs_->Combine(*other->runs_, op);
+        }
+        if (runs == NULL) {
+            return THROW(TypeError, "expected images of the same size");
+        }
+        return scope.Close(RunLengthImage::New(runs));
+    } else {
+        return THROW(TypeError, "expected (image: RunLengthImage)");
+    }
+}
+
+Handle<Value> RunLengthImage::Projection(const Arguments &args)
+{
+    HandleScope scope;
+    RunLengthImage *obj = ObjectWrap::Unwrap<RunLengthImage>(args.This());
+    if (args[0]->IsString() && obj->runs_) {
+        String::AsciiValue mode(args[0]->ToString());
+        std::vector<l_uint32> values;
+        if (strcmp("horizontal", *mode) == 0) {
+            obj->runs_->ProjectColumns(values);
+        } else if (strcmp("vertical", *mode) == 0) {
+            obj->runs_->ProjectRows(values);
+        } else {
+            return THROW(Error, "expected mode to be 'horizontal' or 'vertical'");
+        }
+        void *data;
+        Local<Object> result = createTypedArray("Uint32Array", static_cast<int>(values.size()), &data);
+        std::copy(values.begin(), values.end(), static_cast<l_uint32 *>(data));
+        return scope.Close(result);
+    } else {
+        return THROW(TypeError, "expected (mode: String)");
+    }
+}
+
+Handle<Value> RunLengthImage::ConnectedComponents(const Arguments &args)
+{
+    HandleScope scope;
+    RunLengthImage *obj = ObjectWrap::Unwrap<RunLengthImage>(args.This());
+    if (args[0]->IsInt32() && obj->runs_) {
+        BOXA *boxa = obj->runs_->ConnectedComponents(args[0]->Int32Value());
+        if (!boxa) {
+            return THROW(TypeError, "error while computing connected components");
+        }
+        Local<Object> boxes = Array::New();
+        for (int i = 0; i < boxa->n; ++i) {
+            boxes->Set(i, createBox(boxa->box[i]));
+        }
+        boxaDestroy(&boxa);
+        return scope.Close(boxes);
+    } else {
+        return THROW(TypeError, "expected (connectivity: Int32)");
+    }
+}
+
+Handle<Value> RunLengthImage::BoundingBox(const Arguments &args)
+{
+    HandleScope scope;
+    RunLengthImage *obj = ObjectWrap::Unwrap<RunLengthImage>(args.This());
+    Box *box = obj->runs_ ? obj->runs_->BoundingBox() : NULL;
+    if (box == NULL) {
+        return scope.Close(Null());
+    }
+    Handle<Object> result = createBox(box);
+    boxDestroy(&box);
+    return scope.Close(result);
+}
+
+Handle<Value> RunLengthImage::ToImage(const Arguments &args)
+{
+    HandleScope scope;
+    RunLengthImage *obj = ObjectWrap::Unwrap<RunLengthImage>(args.This());
+    Pix *pixd = obj->runs_ ? obj->runs_->ToPix() : NULL;
+    if (pixd == NULL) {
+        return THROW(TypeError, "error while converting to image");
+    }
+    return scope.Close(Image::New(pixd));
+}
+
+RunLengthImage::RunLengthImage(RunLength *runs)
+    : runs_(runs)
+{
+    if (runs_) {
+        V8::AdjustAmountOfExternalAllocatedMemory(size());
+    }
+}
+
+RunLengthImage::~RunLengthImage()
+{
+    if (runs_) {
+        V8::AdjustAmountOfExternalAllocatedMemory(-size());
+        delete runs_;
+    }
+}
+
+int RunLengthImage::size() const
+{
+    return (runs_->Height() + 1 + 2 * runs_->RunCount()) * sizeof(int);
+}
+
+}
@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2012 Christoph Schulz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef RUNLENGTHIMAGE_H
+#define RUNLENGTHIMAGE_H
+
+#include <v8.h>
+#include <node.h>
+#include "runlength.h"
+
+namespace binding {
+
+// A binary image as runs of foreground pixels (see RunLength), for pages
+// that are mostly white.
+class RunLengthImage : public node::ObjectWrap
+{
+public:
+    static v8::Persistent<v8::FunctionTemplate> constructor_template;
+
+    static bool HasInstance(v8::Handle<v8::Value> val);
+
+    static void Init(v8::Handle<v8::Object> target);
+
+    // Takes ownership of runs.
+    static v8::Handle<v8::Value> New(RunLength *runs);
+
+private:
+    static v8::Handle<v8::Value> New(const v8::Arguments& args);
+
+    // Accessors.
+    static v8::Handle<v8::Value> GetWidth(v8::Local<v8::String> prop, const v8::AccessorInfo &info);
+    static v8::Handle<v8::Value> GetHeight(v8::Local<v8::String> prop, const v8::AccessorInfo &info);
+    static v8::Handle<v8::Value> GetRunCount(v8::Local<v8::String> prop, const v8::AccessorInfo &info);
+
+    // Methods.
+    static v8::Handle<v8::Value> Or(const v8::Arguments& args);
+    static v8::Handle<v8::Value> And(const v8::Arguments& args);
+    static v8::Handle<v8::Value> Xor(const v8::Arguments& args);
+    static v8::Handle<v8::Value> Projection(const v8::Arguments& args);
+    static v8::Handle<v8::Value> ConnectedComponents(const v8::Arguments& args);
+    static v8::Handle<v8::Value> BoundingBox(const v8::Arguments& args);
+    static v8::Handle<v8::Value> ToImage(const v8::Arguments& args);
+
+    static v8::Handle<v8::Value> Combine(const v8::Arguments& args, RunLength::Op op);
+
+    RunLengthImage(RunLength *runs);
+    ~RunLengthImage();
+
+    int size() const;
+
+    RunLength *runs_;
+};
+
+}
+
+#endif
@@ -22,6 +22,8 @@
 #include "tesseract.h"
 #include "image.h"
 #include "util.h"
+#include <node_buffer.h>
+#include <cstdio>
 #include <sstream>
 #include <algorithm>
 #include <cmath>
@@ -30,6 +32,7 @@
 #include <image.h>
 #include <tesseractclass.h>
 #include <params.h>
+#include <osdetect.h>
 #include "Matrix.h"
 
 using namespace v8;
@@ -45,6 +48,7 @@ void Tesseract::Init(Handle<Object> target)
     Local<ObjectTemplate> proto = constructor_template->PrototypeTemplate();
     proto->SetAccessor(String::NewSymbol("image"), GetImage, SetImage);
     proto->SetAccessor(String::NewSymbol("rectangle"), GetRectangle, SetRectangle);
+    proto->SetAccessor(String::NewSymbol("blocks"), GetBlocks, SetBlocks);
     proto->SetAccessor(String::NewSymbol("pageSegMode"), GetPageSegMode, SetPageSegMode);
     proto->SetAccessor(String::NewSymbol("symbolWhitelist"), GetSymbolWhitelist, SetSymbolWhitelist);
     tesseract::Tesseract* tesseract_ = new tesseract::Tesseract;
@@ -76,8 +80,14 @@ void Tesseract::Init(Handle<Object> target)
                FunctionTemplate::New(Clear)->GetFunction());
     proto->Set(String::NewSymbol("clearAdaptiveClassifier"),
                FunctionTemplate::New(ClearAdaptiveClassifier)->GetFunction());
+    proto->Set(String::NewSymbol("exportAdaptiveClassifier"),
+               FunctionTemplate::New(ExportAdaptiveClassifier)->GetFunction());
+    proto->Set(String::NewSymbol("importAdaptiveClassifier"),
+               FunctionTemplate::New(ImportAdaptiveClassifier)->GetFunction());
     proto->Set(String::NewSymbol("thresholdImage"),
                FunctionTemplate::New(ThresholdImage)->GetFunction());
+    proto->Set(String::NewSymbol("detectOrientation"),
+               FunctionTemplate::New(DetectOrientation)->GetFunction());
     proto->Set(String::NewSymbol("findRegions"),
                FunctionTemplate::New(FindRegions)->GetFunction());
     proto->Set(String::NewSymbol("findParagraphs"),
@@ -193,6 +203,56 @@ void Tesseract::SetRectangle(Local<String> prop, Local<Value> value, const Acces
     }
 }
 
+Handle<Value> Tesseract::GetBlocks(Local<String> prop, const AccessorInfo &info)
+{
+    HandleScope scope;
+    Tesseract* obj = ObjectWrap::Unwrap<Tesseract>(info.This());
+    if (obj->blocks_.IsEmpty()) {
+        return scope.Close(Null());
+    }
+    return scope.Close(obj->blocks_);
+}
+
+void Tesseract::SetBlocks(Local<String> prop, Local<Value> value, const AccessorInfo &info)
+{
+    HandleScope scope;
+    Tesseract* obj = ObjectWrap::Unwrap<Tesseract>(info.This());
+    if (value->IsArray() || value->IsNull()) {
+        // The blocks are in image coordinates, like the rectangle itself;
+        // the boxes found within them are, like all results, relative to
+        // the rectangle.
+        BOXA *boxa = NULL;
+        if (value->IsArray()) {
+            Local<Array> blocks = Local<Array>::Cast(value);
+            boxa = boxaCreate(blocks->Length());
+            for (uint32_t i = 0; i < blocks->Length(); ++i) {
+                BOX *box = toBox(blocks->Get(i));
+                if (!box) {
+                    boxaDestroy(&boxa);
+                    THROW(TypeError, "blocks must be Objects with numeric x, y, "
+                          "width and height properties");
+                    return;
+                }
+                boxaAddBox(boxa, box, L_INSERT);
+            }
+        }
+        if (!obj->blocks_.IsEmpty()) {
+            obj->blocks_.Dispose();
+            obj->blocks_.Clear();
+        }
+        if (value->IsNull()) {
+            obj->api_.SetBlocks(NULL);
+            return;
+        }
+        obj->blocks_ = Persistent<Array>::New(Local<Array>::Cast(value));
+        obj->api_.SetBlocks(boxa);
+        boxaDestroy(&boxa);
+    } else {
+        THROW(TypeError, "value must be null or an Array of Objects with "
+              "x, y, width and height properties");
+    }
+}
+
 Handle<Value> Tesseract::GetPageSegMode(Local<String> prop, const AccessorInfo &info)
 {
     HandleScope scope;
@@ -284,6 +344,7 @@ void Tesseract::SetSymbolWhitelist(Local<String> prop, Local<Value> value, const
     if (value->IsString()) {
         String::AsciiValue whitelist(value);
         obj->api_.SetVariable("tessedit_char_whitelist", *whitelist);
+        obj->api_.ClearResults();
     } else {
         THROW(TypeError, "value must be of type string");
     }
@@ -296,6 +357,8 @@ void Tesseract::SetVariable(Local<String> prop, Local<Value> value, const Access
     String::AsciiValue name(prop);
     String::AsciiValue val(value);
     obj->api_.SetVariable(*name, *val);
+    // The results held for the image may depend on the variable.
+    obj->api_.ClearResults();
 }
 
 Handle<Value> Tesseract::GetIntVariable(Local<String> prop, const AccessorInfo &info)
@@ -354,6 +417,54 @@ Handle<Value> Tesseract::ClearAdaptiveClassifier(const Arguments &args)
     return args.This();
 }
 
+Handle<Value> Tesseract::ExportAdaptiveClassifier(const Arguments &args)
+{
+    HandleScope scope;
+    Tesseract* obj = ObjectWrap::Unwrap<Tesseract>(args.This());
+    // Tesseract serializes to FILE*, so go through a temporary file.
+    FILE *file = tmpfile();
+    if (!file) {
+        return THROW(Error, "cannot create temporary file");
+    }
+    if (!obj->api_.WriteAdaptiveClassifier(file) || fflush(file) != 0) {
+        fclose(file);
+        return THROW(Error, "cannot write adaptive classifier");
+    }
+    long length = ftell(file);
+    Buffer *buffer = Buffer::New(length);
+    rewind(file);
+    size_t read = fread(Buffer::Data(buffer), 1, length, file);
+    fclose(file);
+    if (read != static_cast<size_t>(length)) {
+        return THROW(Error, "cannot write adaptive classifier");
+    }
+    return scope.Close(buffer->handle_);
+}
+
+Handle<Value> Tesseract::ImportAdaptiveClassifier(const Arguments &args)
+{
+    HandleScope scope;
+    Tesseract* obj = ObjectWrap::Unwrap<Tesseract>(args.This());
+    if (args.Length() != 1 || !Buffer::HasInstance(args[0])) {
+        return THROW(TypeError, "expected Buffer from exportAdaptiveClassifier()");
+    }
+    Local<Object> buffer = args[0]->ToObject();
+    FILE *file = tmpfile();
+    if (!file) {
+        return THROW(Error, "cannot create temporary file");
+    }
+    size_t length = Buffer::Length(buffer);
+    bool ok = fwrite(Buffer::Data(buffer), 1, length, file) == length;
+    rewind(file);
+    ok = ok && obj->api_.ReadAdaptiveClassifier(file);
+    fclose(file);
+    if (!ok) {
+        return THROW(Error, "buffer does not hold an adaptive classifier "
+                     "for the languages of this instance");
+    }
+    return args.This();
+}
+
 Handle<Value> Tesseract::ThresholdImage(const Arguments &args)
 {
     HandleScope scope;
@@ -366,6 +477,52 @@ Handle<Value> Tesseract::ThresholdImage(const Arguments &args)
     }
 }
 
+Handle<Value> Tesseract::DetectOrientation(const Arguments &args)
+{
+    HandleScope scope;
+    Tesseract* obj = ObjectWrap::Unwrap<Tesseract>(args.This());
+    bool rotate = false;
+    int maxBlobs = kMaxCharactersToTry;
+    for (int i = 0; i < args.Length(); ++i) {
+        if (args[i]->IsBoolean()) {
+            rotate = args[i]->BooleanValue();
+        } else if (args[i]->IsInt32() && args[i]->Int32Value() > 0) {
+            maxBlobs = args[i]->Int32Value();
+        } else {
+            return THROW(TypeError, "expected ([rotate: Boolean], [maxBlobs: Int32])");
+        }
+    }
+    OSResults osr;
+    if (!obj->api_.DetectOS(&osr, maxBlobs)) {
+        return scope.Close(Null());
+    }
+    OSBestResult &best = osr.best_result;
+    int degrees = OrientationIdToValue(best.orientation_id);
+    double margin = 0;
+    obj->api_.GetDoubleVariable("min_orientation_margin", &margin);
+    bool rotated = false;
+    if (rotate && degrees != 0 && best.oconfidence >= margin && !obj->image_.IsEmpty()) {
+        // The orientation is the clockwise rotation that makes the text upright.
+        Pix *pixd = pixRotateOrth(Image::Pixels(obj->image_), degrees / 90);
+        if (pixd == NULL) {
+            return THROW(Error, "error while rotating image");
+        }
+        obj->image_.Dispose();
+        obj->image_ = Persistent<Object>::New(Image::New(pixd)->ToObject());
+        obj->api_.SetImage(Image::Pixels(obj->image_));
+        rotated = true;
+    }
+    Local<Object> result = Object::New();
+    result->Set(String::NewSymbol("orientation"), Int32::New(degrees));
+    result->Set(String::NewSymbol("orientationConfidence"), Number::New(best.oconfidence));
+    const char *script = osr.unicharset != NULL
+        ? osr.unicharset->get_script_from_script_id(best.script_id) : "";
+    result->Set(String::NewSymbol("script"), String::New(script));
+    result->Set(String::NewSymbol("scriptConfidence"), Number::New(best.sconfidence));
+    result->Set(String::NewSymbol("rotated"), Boolean::New(rotated));
+    return scope.Close(result);
+}
+
 Handle<Value> Tesseract::FindRegions(const Arguments &args)
 {
     HandleScope scope;
@@ -486,9 +643,11 @@ Handle<Value> Tesseract::TransformResult(tesseract::PageIteratorLevel level, con
     if (args.Length() >= 1 && args[0]->IsBoolean()) {
         recognize = args[0]->BooleanValue();
     }
+    // Results of the same image and rectangle are reused: layout analysis
+    // runs once for both modes and recognition once until a setting changes.
     tesseract::PageIterator *it = 0;
     if (recognize) {
-        if (api_.Recognize(NULL) != 0) {
+        if (!api_.IsRecognized() && api_.Recognize(NULL) != 0) {
             return THROW(Error, "Internal tesseract error");
         }
         it = api_.GetIterator();
@@ -499,6 +658,9 @@ Handle<Value> Tesseract::TransformResult(tesseract::PageIteratorLevel level, con
     if (it == NULL) {
         return scope.Close(results);
     }
+    // Map boxes back from the thresholded image, which is scaled down if
+    // tessedit_target_xheight is set.
+    float scale = api_.GetThresholdedImageScaleFactor();
     int index = 0;
     do {
         if (it->Empty(level)) {
@@ -507,6 +669,10 @@ Handle<Value> Tesseract::TransformResult(tesseract::PageIteratorLevel level, con
         Handle<Object> result = Object::New();
         int left, top, right, bottom;
         if (it->BoundingBoxInternal(level, &left, &top, &right, &bottom)) {
+            left = floor(left / scale);
+            top = floor(top / scale);
+            right = ceil(right / scale);
+            bottom = ceil(bottom / scale);
             // Extract image coordiante box.
             Handle<Object> box = Object::New();
             box->Set(String::NewSymbol("x"), Int32::New(left));
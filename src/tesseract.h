@@ -42,6 +42,8 @@ private:
     static void SetImage(v8::Local<v8::String> prop, v8::Local<v8::Value> value, const v8::AccessorInfo &info);
     static v8::Handle<v8::Value> GetRectangle(v8::Local<v8::String> prop, const v8::AccessorInfo &info);
     static void SetRectangle(v8::Local<v8::String> prop, v8::Local<v8::Value> value, const v8::AccessorInfo &info);
+    static v8::Handle<v8::Value> GetBlocks(v8::Local<v8::String> prop, const v8::AccessorInfo &info);
+    static void SetBlocks(v8::Local<v8::String> prop, v8::Local<v8::Value> value, const v8::AccessorInfo &info);
     static v8::Handle<v8::Value> GetPageSegMode(v8::Local<v8::String> prop, const v8::AccessorInfo &info);
     static void SetPageSegMode(v8::Local<v8::String> prop, v8::Local<v8::Value> value, const v8::AccessorInfo &info);
     static v8::Handle<v8::Value> GetSymbolWhitelist(v8::Local<v8::String> prop, const v8::AccessorInfo &info);
@@ -57,7 +59,10 @@ private:
     // Methods.
     static v8::Handle<v8::Value> Clear(const v8::Arguments& args);
     static v8::Handle<v8::Value> ClearAdaptiveClassifier(const v8::Arguments& args);
+    static v8::Handle<v8::Value> ExportAdaptiveClassifier(const v8::Arguments& args);
+    static v8::Handle<v8::Value> ImportAdaptiveClassifier(const v8::Arguments& args);
     static v8::Handle<v8::Value> ThresholdImage(const v8::Arguments& args);
+    static v8::Handle<v8::Value> DetectOrientation(const v8::Arguments& args);
     static v8::Handle<v8::Value> FindRegions(const v8::Arguments& args);
     static v8::Handle<v8::Value> FindParagraphs(const v8::Arguments &args);
     static v8::Handle<v8::Value> FindTextLines(const v8::Arguments& args);
@@ -74,6 +79,7 @@ private:
     tesseract::TessBaseAPI api_;
     v8::Persistent<v8::Object> image_;
     v8::Persistent<v8::Object> rectangle_;
+    v8::Persistent<v8::Array> blocks_;
 };
 
 }
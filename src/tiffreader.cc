@@ -0,0 +1,522 @@
+/*
+ * Copyright (c) 2012 Christoph Schulz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "tiffreader.h"
+#include <algorithm>
+#include <cstring>
+
+namespace binding {
+
+namespace {
+
+// Directories beyond this many pages are ignored (which also ends cycles).
+const int kMaxPages = 65536;
+// Limits for the size of a page and the number of values in an entry, to
+// reject broken files before allocating for them.
+const l_uint32 kMaxDimension = 1 << 16;
+const l_uint32 kMaxValues = 1 << 24;
+
+enum Tag {
+    TAG_IMAGE_WIDTH = 256,
+    TAG_IMAGE_LENGTH = 257,
+    TAG_BITS_PER_SAMPLE = 258,
+    TAG_COMPRESSION = 259,
+    TAG_PHOTOMETRIC = 262,
+    TAG_FILL_ORDER = 266,
+    TAG_STRIP_OFFSETS = 273,
+    TAG_SAMPLES_PER_PIXEL = 277,
+    TAG_ROWS_PER_STRIP = 278,
+    TAG_STRIP_BYTE_COUNTS = 279,
+    TAG_X_RESOLUTION = 282,
+    TAG_Y_RESOLUTION = 283,
+    TAG_PLANAR_CONFIG = 284,
+    TAG_RESOLUTION_UNIT = 296,
+    TAG_PREDICTOR = 317,
+    TAG_COLOR_MAP = 320,
+    TAG_TILE_WIDTH = 322,
+};
+
+enum Compression {
+    COMPRESSION_NONE = 1,
+    COMPRESSION_LZW = 5,
+    COMPRESSION_PACKBITS = 32773,
+};
+
+enum Photometric {
+    PHOTOMETRIC_WHITE_IS_ZERO = 0,
+    PHOTOMETRIC_BLACK_IS_ZERO = 1,
+    PHOTOMETRIC_RGB = 2,
+    PHOTOMETRIC_PALETTE = 3,
+};
+
+int typeSize(int type)
+{
+    switch (type) {
+    case 1:  // BYTE
+        return 1;
+    case 3:  // SHORT
+        return 2;
+    case 4:  // LONG
+        return 4;
+    case 5:  // RATIONAL
+        return 8;
+    default:
+        return 0;
+    }
+}
+
+bool decodePackBits(const l_uint8 *in, size_t length, l_uint8 *out, size_t expected)
+{
+    const l_uint8 *end = in + length;
+    size_t pos = 0;
+    while (in < end && pos < expected) {
+        int n = static_cast<signed char>(*in++);
+        if (n >= 0) {
+            size_t count = std::min<size_t>(n + 1, std::min<size_t>(end - in, expected - pos));
+            memcpy(out + pos, in, count);
+            in += count;
+            pos += count;
+        } else if (n != -128 && in < end) {
+            size_t count = std::min<size_t>(1 - n, expected - pos);
+            memset(out + pos, *in++, count);
+            pos += count;
+        }
+    }
+    return pos == expected;
+}
+
+// Decodes TIFF flavored LZW: codes of 9 to 12 bits, most significant bit
+// first, which grow one code early.
+bool decodeLzw(const l_uint8 *in, size_t length, l_uint8 *out, size_t expected)
+{
+    const int kClear = 256;
+    const int kEnd = 257;
+    const int kMaxCodes = 4096;
+    std::vector<l_uint16> prefix(kMaxCodes);
+    std::vector<l_uint16> size(kMaxCodes, 1);
+    std::vector<l_uint8> suffix(kMaxCodes);
+    std::vector<l_uint8> first(kMaxCodes);
+    for (int i = 0; i < 256; ++i) {
+        suffix[i] = first[i] = static_cast<l_uint8>(i);
+    }
+    size_t pos = 0;
+    size_t bitPos = 0;
+    int width = 9;
+    int next = kEnd + 1;
+    int previous = -1;
+    while (pos < expected && bitPos + width <= length * 8) {
+        int code = 0;
+        for (int i = 0; i < width; ++i, ++bitPos) {
+            code = (code << 1) | ((in[bitPos >> 3] >> (7 - (bitPos & 7))) & 1);
+        }
+        if (code == kEnd) {
+            break;
+        } else if (code == kClear) {
+            width = 9;
+            next = kEnd + 1;
+            previous = -1;
+            continue;
+        }
+        if (previous < 0) {
+            if (code > 255) {
+                return false;
+            }
+        } else if (code <= next && next < kMaxCodes) {
+            prefix[next] = static_cast<l_uint16>(previous);
+            suffix[next] = first[code == next ? previous : code];
+            first[next] = first[previous];
+            size[next] = size[previous] + 1;
+            ++next;
+            if (next >= (1 << width) - 1 && width < 12) {
+                ++width;
+            }
+        } else if (code >= next) {
+            return false;
+        }
+        // Write the string of code backwards from its last byte.
+        size_t n = size[code];
+        for (int c = code, k = static_cast<int>(n) - 1; k >= 0; c = prefix[c], --k) {
+            if (pos + k < expected) {
+                out[pos + k] = suffix[c];
+            }
+        }
+        pos = std::min(pos + n, expected);
+        previous = code;
+    }
+    return pos == expected;
+}
+
+inline l_uint8 reverseBits(l_uint8 byte)
+{
+    byte = static_cast<l_uint8>((byte & 0xf0) >> 4 | (byte & 0x0f) << 4);
+    byte = static_cast<l_uint8>((byte & 0xcc) >> 2 | (byte & 0x33) << 2);
+    return static_cast<l_uint8>((byte & 0xaa) >> 1 | (byte & 0x55) << 1);
+}
+
+}
+
+TiffReader *TiffReader::Open(const char *filename, std::string &error)
+{
+    FILE *file = fopen(filename, "rb");
+    if (file == NULL) {
+        error = "cannot open file";
+        return NULL;
+    }
+    TiffReader *reader = new TiffReader(file, NULL, 0);
+    if (!reader->ReadHeader(error)) {
+        delete reader;
+        return NULL;
+    }
+    return reader;
+}
+
+TiffReader *TiffReader::Open(const l_uint8 *data, size_t length, std::string &error)
+{
+    TiffReader *reader = new TiffReader(NULL, data, length);
+    if (!reader->ReadHeader(error)) {
+        delete reader;
+        return NULL;
+    }
+    return reader;
+}
+
+TiffReader::TiffReader(FILE *file, const l_uint8 *data, size_t length)
+    : file_(file), data_(data), length_(length), bigEndian_(false)
+{
+}
+
+TiffReader::~TiffReader()
+{
+    if (file_) {
+        fclose(file_);
+    }
+}
+
+int TiffReader::PageCount() const
+{
+    return static_cast<int>(pages_.size());
+}
+
+bool TiffReader::ReadHeader(std::string &error)
+{
+    l_uint8 header[8];
+    if (!Read(0, header, sizeof(header)) ||
+            !((header[0] == 'I' && header[1] == 'I') || (header[0] == 'M' && header[1] == 'M'))) {
+        error = "not a TIFF";
+        return false;
+    }
+    bigEndian_ = header[0] == 'M';
+    if (Get16(header + 2) != 42) {
+        error = "not a TIFF (or a BigTIFF)";
+        return false;
+    }
+    // Collect the directories without looking at them yet.
+    l_uint32 offset = Get32(header + 4);
+    while (offset != 0 && pages_.size() < static_cast<size_t>(kMaxPages)) {
+        l_uint8 count[2];
+        l_uint8 next[4];
+        if (std::find(pages_.begin(), pages_.end(), offset) != pages_.end() ||
+                !Read(offset, count, sizeof(count)) ||
+                !Read(offset + 2 + 12 * size_t(Get16(count)), next, sizeof(next))) {
+            break;
+        }
+        pages_.push_back(offset);
+        offset = Get32(next);
+    }
+    if (pages_.empty()) {
+        error = "TIFF has no pages";
+        return false;
+    }
+    return true;
+}
+
+bool TiffReader::Read(size_t offset, void *dst, size_t length)
+{
+    if (file_) {
+        return fseek(file_, static_cast<long>(offset), SEEK_SET) == 0 &&
+                fread(dst, 1, length, file_) == length;
+    } else if (offset <= length_ && length <= length_ - offset) {
+        memcpy(dst, data_ + offset, length);
+        return true;
+    } else {
+        return false;
+    }
+}
+
+bool TiffReader::ReadValues(const Entry &entry, std::vector<l_uint32> &values)
+{
+    int size = typeSize(entry.type);
+    if (size == 0 || entry.count == 0 || entry.count > kMaxValues) {
+        return false;
+    }
+    std::vector<l_uint8> bytes(size * entry.count);
+    if (bytes.size() <= 4) {
+        memcpy(&bytes[0], entry.value, bytes.size());
+    } else if (!Read(Get32(entry.value), &bytes[0], bytes.size())) {
+        return false;
+    }
+    // Rationals become two values each, the numerator and the denominator.
+    int step = size == 8 ? 4 : size;
+    values.resize(bytes.size() / step);
+    for (size_t i = 0; i < values.size(); ++i) {
+        const l_uint8 *p = &bytes[i * step];
+        values[i] = step == 1 ? *p : step == 2 ? Get16(p) : Get32(p);
+    }
+    return true;
+}
+
+l_uint32 TiffReader::Get16(const l_uint8 *p) const
+{
+    return bigEndian_ ? (p[0] << 8) | p[1] : p[0] | (p[1] << 8);
+}
+
+l_uint32 TiffReader::Get32(const l_uint8 *p) const
+{
+    return bigEndian_ ? (Get16(p) << 16) | Get16(p + 2) : Get16(p) | (Get16(p + 2) << 16);
+}
+
+Pix *TiffReader::ReadPage(int index, std::string &error)
+{
+    if (index < 0 || index >= PageCount()) {
+        error = "page index out of range";
+        return NULL;
+    }
+    l_uint8 countBytes[2];
+    if (!Read(pages_[index], countBytes, sizeof(countBytes))) {
+        error = "truncated TIFF";
+        return NULL;
+    }
+    std::vector<l_uint8> entryBytes(12 * Get16(countBytes));
+    if (!entryBytes.empty() && !Read(pages_[index] + 2, &entryBytes[0], entryBytes.size())) {
+        error = "truncated TIFF";
+        return NULL;
+    }
+
+    // Gather the fields of the page, with the defaults of the specification.
+    l_uint32 width = 0;
+    l_uint32 height = 0;
+    l_uint32 bitsPerSample = 1;
+    l_uint32 samplesPerPixel = 1;
+    l_uint32 compression = COMPRESSION_NONE;
+    l_uint32 photometric = PHOTOMETRIC_WHITE_IS_ZERO;
+    l_uint32 fillOrder = 1;
+    l_uint32 rowsPerStrip = 0xffffffff;
+    l_uint32 planarConfig = 1;
+    l_uint32 predictor = 1;
+    l_uint32 resolutionUnit = 2;
+    float resolution[2] = { 0, 0 };
+    std::vector<l_uint32> stripOffsets;
+    std::vector<l_uint32> stripByteCounts;
+    std::vector<l_uint32> colorMap;
+    for (size_t i = 0; i < entryBytes.size(); i += 12) {
+        Entry entry;
+        entry.tag = Get16(&entryBytes[i]);
+        entry.type = Get16(&entryBytes[i + 2]);
+        entry.count = Get32(&entryBytes[i + 4]);
+        memcpy(entry.value, &entryBytes[i + 8], sizeof(entry.value));
+        std::vector<l_uint32> values;
+        if (entry.tag == TAG_TILE_WIDTH) {
+            error = "tiled TIFF is not supported";
+            return NULL;
+        } else if (!ReadValues(entry, values)) {
+            continue;
+        }
+        switch (entry.tag) {
+        case TAG_IMAGE_WIDTH:
+            width = values[0];
+            break;
+        case TAG_IMAGE_LENGTH:
+            height = values[0];
+            break;
+        case TAG_BITS_PER_SAMPLE:
+            bitsPerSample = values[0];
+            if (static_cast<size_t>(std::count(values.begin(), values.end(), bitsPerSample)) !=
+                    values.size()) {
+                error = "TIFF samples of different sizes are not supported";
+                return NULL;
+            }
+            break;
+        case TAG_COMPRESSION:
+            compression = values[0];
+            break;
+        case TAG_PHOTOMETRIC:
+            photometric = values[0];
+            break;
+        case TAG_FILL_ORDER:
+            fillOrder = values[0];
+            break;
+        case TAG_STRIP_OFFSETS:
+            stripOffsets.swap(values);
+            break;
+        case TAG_SAMPLES_PER_PIXEL:
+            samplesPerPixel = values[0];
+            break;
+        case TAG_ROWS_PER_STRIP:
+            rowsPerStrip = std::max<l_uint32>(values[0], 1);
+            break;
+        case TAG_STRIP_BYTE_COUNTS:
+            stripByteCounts.swap(values);
+            break;
+        case TAG_X_RESOLUTION:
+        case TAG_Y_RESOLUTION:
+            if (values.size() == 2 && values[1] != 0) {
+                resolution[entry.tag - TAG_X_RESOLUTION] = static_cast<float>(values[0]) / values[1];
+            }
+            break;
+        case TAG_PLANAR_CONFIG:
+            planarConfig = values[0];
+            break;
+        case TAG_RESOLUTION_UNIT:
+            resolutionUnit = values[0];
+            break;
+        case TAG_PREDICTOR:
+            predictor = values[0];
+            break;
+        case TAG_COLOR_MAP:
+            colorMap.swap(values);
+            break;
+        }
+    }
+
+    // Check that this is a kind of page we can read.
+    if (width == 0 || height == 0 || width > kMaxDimension || height > kMaxDimension) {
+        error = "invalid TIFF page size";
+        return NULL;
+    }
+    bool validBits = bitsPerSample == 1 || bitsPerSample == 2 ||
+            bitsPerSample == 4 || bitsPerSample == 8;
+    bool gray = samplesPerPixel == 1 && (photometric == PHOTOMETRIC_WHITE_IS_ZERO ||
+                                         photometric == PHOTOMETRIC_BLACK_IS_ZERO);
+    // The color map size is only computed for a valid sample size, which
+    // keeps the shift in range.
+    bool palette = samplesPerPixel == 1 && photometric == PHOTOMETRIC_PALETTE &&
+            validBits && colorMap.size() == 3u << bitsPerSample;
+    bool rgb = (samplesPerPixel == 3 || samplesPerPixel == 4) &&
+            photometric == PHOTOMETRIC_RGB && bitsPerSample == 8;
+    if (!((gray || palette) && validBits) && !rgb) {
+        error = "TIFF pixel format is not supported";
+        return NULL;
+    }
+    if (compression != COMPRESSION_NONE && compression != COMPRESSION_LZW &&
+            compression != COMPRESSION_PACKBITS) {
+        error = "TIFF compression is not supported";
+        return NULL;
+    }
+    if (planarConfig != 1 || (predictor != 1 && !(predictor == 2 && bitsPerSample == 8))) {
+        error = "TIFF sample layout is not supported";
+        return NULL;
+    }
+    l_uint32 numStrips = (height + std::min(rowsPerStrip, height) - 1) / std::min(rowsPerStrip, height);
+    rowsPerStrip = std::min(rowsPerStrip, height);
+    if (stripOffsets.size() < numStrips ||
+            (compression != COMPRESSION_NONE && stripByteCounts.size() < numStrips)) {
+        error = "TIFF strips are missing";
+        return NULL;
+    }
+
+    int depth = samplesPerPixel == 1 ? bitsPerSample : 32;
+    Pix *pixd = pixCreateNoInit(width, height, depth);
+    if (pixd == NULL) {
+        error = "out of memory";
+        return NULL;
+    }
+    if (palette) {
+        int n = 1 << bitsPerSample;
+        PixColormap *cmap = pixcmapCreate(bitsPerSample);
+        for (int i = 0; i < n; ++i) {
+            pixcmapAddColor(cmap, colorMap[i] >> 8, colorMap[n + i] >> 8, colorMap[2 * n + i] >> 8);
+        }
+        pixSetColormap(pixd, cmap);
+    }
+    if (resolutionUnit == 3) {
+        resolution[0] *= 2.54f;
+        resolution[1] *= 2.54f;
+    }
+    pixSetResolution(pixd, static_cast<int>(resolution[0] + 0.5f),
+                     static_cast<int>(resolution[1] + 0.5f));
+
+    // Leptonica has black as 1 in binary and as 0 in gray images.
+    l_uint8 invert = gray && ((bitsPerSample == 1) == (photometric == PHOTOMETRIC_BLACK_IS_ZERO)) ? 0xff : 0;
+    size_t rowBytes = (size_t(width) * bitsPerSample * samplesPerPixel + 7) / 8;
+    std::vector<l_uint8> raw;
+    std::vector<l_uint8> strip;
+    for (l_uint32 s = 0; s < numStrips; ++s) {
+        l_uint32 y0 = s * rowsPerStrip;
+        l_uint32 rows = std::min(rowsPerStrip, height - y0);
+        strip.resize(rows * rowBytes);
+        size_t rawLength = compression == COMPRESSION_NONE ? strip.size() : stripByteCounts[s];
+        if (compression == COMPRESSION_NONE && s < stripByteCounts.size()) {
+            rawLength = std::min<size_t>(rawLength, stripByteCounts[s]);
+        }
+        raw.resize(rawLength);
+        bool ok = raw.empty() || Read(stripOffsets[s], &raw[0], raw.size());
+        if (ok && fillOrder == 2) {
+            for (size_t i = 0; i < raw.size(); ++i) {
+                raw[i] = reverseBits(raw[i]);
+            }
+        }
+        if (ok) {
+            switch (compression) {
+            case COMPRESSION_NONE:
+                ok = raw.size() == strip.size();
+                if (ok) {
+                    strip.swap(raw);
+                }
+                break;
+            case COMPRESSION_LZW:
+                ok = decodeLzw(raw.empty() ? NULL : &raw[0], raw.size(), &strip[0], strip.size());
+                break;
+            default:
+                ok = decodePackBits(raw.empty() ? NULL : &raw[0], raw.size(), &strip[0], strip.size());
+                break;
+            }
+        }
+        if (!ok) {
+            pixDestroy(&pixd);
+            error = "TIFF strip is truncated or corrupt";
+            return NULL;
+        }
+        for (l_uint32 r = 0; r < rows; ++r) {
+            l_uint8 *row = &strip[r * rowBytes];
+            l_uint32 *line = pixGetData(pixd) + (y0 + r) * pixGetWpl(pixd);
+            if (predictor == 2) {
+                for (size_t i = samplesPerPixel; i < rowBytes; ++i) {
+                    row[i] = static_cast<l_uint8>(row[i] + row[i - samplesPerPixel]);
+                }
+            }
+            if (depth == 32) {
+                for (l_uint32 x = 0; x < width; ++x, row += samplesPerPixel) {
+                    composeRGBPixel(row[0], row[1], row[2], line + x);
+                }
+            } else {
+                for (size_t i = 0; i < rowBytes; ++i) {
+                    SET_DATA_BYTE(line, i, row[i] ^ invert);
+                }
+            }
+        }
+    }
+    if (depth < 32) {
+        pixSetPadBits(pixd, 0);
+    }
+    return pixd;
+}
+
+}
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2012 Christoph Schulz
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef TIFFREADER_H
+#define TIFFREADER_H
+
+#include <allheaders.h>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace binding {
+
+// Random access to the pages of a TIFF file or buffer. Only the directory
+// chain is read up front; each page is read and decoded when asked for.
+// Supports strips of bilevel, gray, palette and RGB(A) pages with 8 bit
+// samples, uncompressed or compressed with PackBits or LZW.
+class TiffReader
+{
+public:
+    // Opens the given file, or the length bytes at data, which must stay
+    // valid until the reader is deleted. Returns NULL and sets error if
+    // this is not a TIFF.
+    static TiffReader *Open(const char *filename, std::string &error);
+    static TiffReader *Open(const l_uint8 *data, size_t length, std::string &error);
+
+    ~TiffReader();
+
+    int PageCount() const;
+
+    // Decodes page index. Returns NULL and sets error on failure. Pages must
+    // not be read from two threads at once.
+    Pix *ReadPage(int index, std::string &error);
+
+private:
+    struct Entry {
+        int tag;
+        int type;
+        l_uint32 count;
+        l_uint8 value[4];
+    };
+
+    TiffReader(FILE *file, const l_uint8 *data, size_t length);
+
+    bool ReadHeader(std::string &error);
+    bool Read(size_t offset, void *dst, size_t length);
+    bool ReadValues(const Entry &entry, std::vector<l_uint32> &values);
+    l_uint32 Get16(const l_uint8 *p) const;
+    l_uint32 Get32(const l_uint8 *p) const;
+
+    FILE *file_;
+    const l_uint8 *data_;
+    size_t length_;
+    bool bigEndian_;
+    std::vector<l_uint32> pages_;   // The offset of the directory of each page.
+};
+
+}
+
+#endif
@@ -20,7 +20,15 @@
  * SOFTWARE.
  */
 #include "util.h"
+#include <climits>
 #include <cmath>
+#include <vector>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
 
 using namespace v8;
 
@@ -34,6 +42,17 @@ Handle<Object> createBox(Box* box)
     return result;
 }
 
+Local<Object> createTypedArray(const char* type, int length, void** data)
+{
+    HandleScope scope;
+    Local<Function> constructor = Local<Function>::Cast(
+                Context::GetCurrent()->Global()->Get(String::NewSymbol(type)));
+    Handle<Value> argv[1] = { Int32::New(length) };
+    Local<Object> array = constructor->NewInstance(1, argv);
+    *data = array->GetIndexedPropertiesExternalArrayData();
+    return scope.Close(array);
+}
+
 Box* toBox(const Arguments &args, int start, int* end)
 {
     if (args[start]->IsNumber() && args[start + 1]->IsNumber()
@@ -63,3 +82,113 @@ Box* toBox(const Arguments &args, int start, int* end)
         return 0;
     }
 }
+
+static bool getCoordinate(Handle<Object> object, const char *name, double &value)
+{
+    Local<Value> property = object->Get(String::NewSymbol(name));
+    if (!property->IsNumber()) {
+        return false;
+    }
+    value = property->NumberValue();
+    // Also false for NaN.
+    return value >= INT_MIN && value <= INT_MAX;
+}
+
+Box* toBox(Handle<Value> value)
+{
+    if (!value->IsObject()) {
+        return 0;
+    }
+    Handle<Object> object = value->ToObject();
+    double x, y, width, height;
+    if (!getCoordinate(object, "x", x) || !getCoordinate(object, "y", y) ||
+            !getCoordinate(object, "width", width) || !getCoordinate(object, "height", height)) {
+        return 0;
+    }
+    return boxCreate(floor(x), floor(y), ceil(width), ceil(height));
+}
+
+#ifdef _WIN32
+typedef HANDLE Thread;
+
+static bool startThread(Thread *thread, void *(*func)(void *), void *arg)
+{
+    *thread = CreateThread(0, 0, (LPTHREAD_START_ROUTINE) func, arg, 0, 0);
+    return *thread != 0;
+}
+
+static void joinThread(Thread thread)
+{
+    WaitForSingleObject(thread, INFINITE);
+    CloseHandle(thread);
+}
+
+int numProcessors()
+{
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors;
+}
+#else
+typedef pthread_t Thread;
+
+static bool startThread(Thread *thread, void *(*func)(void *), void *arg)
+{
+    return pthread_create(thread, 0, func, arg) == 0;
+}
+
+static void joinThread(Thread thread)
+{
+    pthread_join(thread, 0);
+}
+
+int numProcessors()
+{
+    return sysconf(_SC_NPROCESSORS_ONLN);
+}
+#endif
+
+struct Worker {
+    Thread thread;
+    bool started;
+    void *(*func)(void *);
+    void *arg;
+};
+
+Worker *startWorker(void *(*func)(void *), void *arg)
+{
+    Worker *worker = new Worker;
+    worker->func = func;
+    worker->arg = arg;
+    worker->started = startThread(&worker->thread, func, arg);
+    return worker;
+}
+
+void joinWorker(Worker *worker)
+{
+    if (worker->started) {
+        joinThread(worker->thread);
+    } else {
+        worker->func(worker->arg);
+    }
+    delete worker;
+}
+
+void runThreads(void *(*func)(void *), void **args, int count)
+{
+    std::vector<Thread> threads(count);
+    std::vector<bool> started(count, false);
+    for (int i = 1; i < count; ++i) {
+        started[i] = startThread(&threads[i], func, args[i]);
+    }
+    if (count > 0) {
+        func(args[0]);
+    }
+    for (int i = 1; i < count; ++i) {
+        if (started[i]) {
+            joinThread(threads[i]);
+        } else {
+            func(args[i]);
+        }
+    }
+}
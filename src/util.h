@@ -31,5 +31,24 @@
 
 v8::Handle<v8::Object> createBox(Box* box);
 Box* toBox(const v8::Arguments &args, int start, int* end = 0);
+// Returns the box of an object with numeric x, y, width and height
+// properties, or 0 if value is no such object.
+Box* toBox(v8::Handle<v8::Value> value);
+// Creates a typed array (e.g. "Float32Array") of length elements and
+// stores a pointer to its backing store in data.
+v8::Local<v8::Object> createTypedArray(const char* type, int length, void** data);
+
+// Returns the number of processors that are online.
+int numProcessors();
+// Calls func with each of the count args on a thread of its own, and returns
+// when all calls are done. Calls that get no thread run on the caller's.
+void runThreads(void *(*func)(void *), void **args, int count);
+
+struct Worker;
+// Starts calling func(arg) in the background. If no thread can be started,
+// the call is made by joinWorker instead.
+Worker *startWorker(void *(*func)(void *), void *arg);
+// Waits until the call of worker is done and frees worker.
+void joinWorker(Worker *worker);
 
 #endif
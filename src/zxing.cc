@@ -38,6 +38,8 @@ using namespace node;
 
 namespace binding {
 
+Persistent<FunctionTemplate> ZXing::constructor_template;
+
 class PixSource : public zxing::LuminanceSource
 {
 public:
@@ -147,17 +149,30 @@ const zxing::BarcodeFormat::Value ZXing::BARCODEFORMATS[] = {
 
 const size_t ZXing::BARCODEFORMATS_LENGTH = 11;
 
+bool ZXing::HasInstance(Handle<Value> val)
+{
+    if (!val->IsObject()) {
+        return false;
+    }
+    return constructor_template->HasInstance(val->ToObject());
+}
+
 void ZXing::Init(Handle<Object> target)
 {
-    Local<FunctionTemplate> constructor_template = FunctionTemplate::New(New);
+    constructor_template = Persistent<FunctionTemplate>::New(FunctionTemplate::New(New));
     constructor_template->SetClassName(String::NewSymbol("ZXing"));
     constructor_template->InstanceTemplate()->SetInternalFieldCount(1);
     Local<ObjectTemplate> proto = constructor_template->PrototypeTemplate();
     proto->SetAccessor(String::NewSymbol("image"), GetImage, SetImage);
     proto->SetAccessor(String::NewSymbol("formats"), GetFormats, SetFormats);
     proto->SetAccessor(String::NewSymbol("tryHarder"), GetTryHarder, SetTryHarder);
+    proto->SetAccessor(String::NewSymbol("parallelRows"), GetParallelRows, SetParallelRows);
+    proto->SetAccessor(String::NewSymbol("adaptiveOrder"), GetAdaptiveOrder, SetAdaptiveOrder);
+    proto->SetAccessor(String::NewSymbol("formatCounts"), GetFormatCounts);
     proto->Set(String::NewSymbol("findCode"),
                FunctionTemplate::New(FindCode)->GetFunction());
+    proto->Set(String::NewSymbol("resetFormatCounts"),
+               FunctionTemplate::New(ResetFormatCounts)->GetFunction());
     target->Set(String::NewSymbol("ZXing"),
                 Persistent<Function>::New(constructor_template->GetFunction()));
 }
@@ -224,8 +239,12 @@ void ZXing::SetFormats(Local<String> prop, Local<Value> value, const AccessorInf
     if (value->IsObject()) {
         Local<Object> format = value->ToObject();
         bool tryHarder = obj->hints_.getTryHarder();
+        bool parallelRows = obj->hints_.getParallelRows();
+        bool adaptiveOrder = obj->hints_.getAdaptiveOrder();
         obj->hints_.clear();
         obj->hints_.setTryHarder(tryHarder);
+        obj->hints_.setParallelRows(parallelRows);
+        obj->hints_.setAdaptiveOrder(adaptiveOrder);
         for (size_t i = 0; i < BARCODEFORMATS_LENGTH; ++i) {
             if (format->Get(String::NewSymbol(zxing::BarcodeFormat::barcodeFormatNames[BARCODEFORMATS[i]]))->BooleanValue()) {
                 obj->hints_.addFormat(BARCODEFORMATS[i]);
@@ -254,6 +273,54 @@ void ZXing::SetTryHarder(Local<String> prop, Local<Value> value, const AccessorI
     }
 }
 
+Handle<Value> ZXing::GetParallelRows(Local<String> prop, const AccessorInfo &info)
+{
+    HandleScope scope;
+    ZXing* obj = ObjectWrap::Unwrap<ZXing>(info.This());
+    return scope.Close(Boolean::New(obj->hints_.getParallelRows()));
+}
+
+void ZXing::SetParallelRows(Local<String> prop, Local<Value> value, const AccessorInfo &info)
+{
+    HandleScope scope;
+    ZXing* obj = ObjectWrap::Unwrap<ZXing>(info.This());
+    if (value->IsBoolean()) {
+        obj->hints_.setParallelRows(value->BooleanValue());
+    } else {
+        THROW(TypeError, "value must be of type bool");
+    }
+}
+
+Handle<Value> ZXing::GetAdaptiveOrder(Local<String> prop, const AccessorInfo &info)
+{
+    HandleScope scope;
+    ZXing* obj = ObjectWrap::Unwrap<ZXing>(info.This());
+    return scope.Close(Boolean::New(obj->hints_.getAdaptiveOrder()));
+}
+
+void ZXing::SetAdaptiveOrder(Local<String> prop, Local<Value> value, const AccessorInfo &info)
+{
+    HandleScope scope;
+    ZXing* obj = ObjectWrap::Unwrap<ZXing>(info.This());
+    if (value->IsBoolean()) {
+        obj->hints_.setAdaptiveOrder(value->BooleanValue());
+    } else {
+        THROW(TypeError, "value must be of type bool");
+    }
+}
+
+Handle<Value> ZXing::GetFormatCounts(Local<String> prop, const AccessorInfo &info)
+{
+    HandleScope scope;
+    ZXing* obj = ObjectWrap::Unwrap<ZXing>(info.This());
+    Local<Object> counts = Object::New();
+    for (size_t i = 0; i < BARCODEFORMATS_LENGTH; ++i) {
+        counts->Set(String::NewSymbol(zxing::BarcodeFormat::barcodeFormatNames[BARCODEFORMATS[i]]),
+                Integer::NewFromUnsigned(obj->reader_->getHits(BARCODEFORMATS[i])));
+    }
+    return scope.Close(counts);
+}
+
 Handle<Value> ZXing::FindCode(const Arguments &args)
 {
     HandleScope scope;
@@ -261,31 +328,21 @@ Handle<Value> ZXing::FindCode(const Arguments &args)
     if (obj->image_.IsEmpty()) {
         return THROW(Error, "No image set");
     }
-    try {
-        zxing::Ref<PixSource> source(new PixSource(Image::Pixels(obj->image_)));
-        zxing::Ref<zxing::Binarizer> binarizer(new zxing::HybridBinarizer(source));
-        zxing::Ref<zxing::BinaryBitmap> binary(new zxing::BinaryBitmap(binarizer));
-        zxing::Ref<zxing::Result> result(obj->reader_->decode(binary, obj->hints_));
-        Local<Object> object = Object::New();
-        std::string resultStr = result->getText()->getText();
-        object->Set(String::NewSymbol("type"), String::New(zxing::BarcodeFormat::barcodeFormatNames[result->getBarcodeFormat()]));
-        object->Set(String::NewSymbol("data"), String::New(resultStr.c_str()));
-        object->Set(String::NewSymbol("buffer"), node::Buffer::New((char*)resultStr.data(), resultStr.length())->handle_);
-        Local<Array> points = Array::New();
-        for (int i = 0; i < result->getResultPoints()->size(); ++i) {
-            Local<Object> point = Object::New();
-            point->Set(String::NewSymbol("x"), Number::New(result->getResultPoints()[i]->getX()));
-            point->Set(String::NewSymbol("y"), Number::New(result->getResultPoints()[i]->getY()));
-            points->Set(i, point);
+    bool raw = false;
+    if (args.Length() >= 1) {
+        if (!args[0]->IsBoolean()) {
+            return THROW(TypeError, "expected ([raw: Boolean])");
         }
-        object->Set(String::NewSymbol("points"), points);
-        return scope.Close(object);
-    } catch (const zxing::ReaderException& e) {
-        if (strcmp(e.what(), "No code detected") == 0) {
+        raw = args[0]->BooleanValue();
+    }
+    try {
+        zxing::Ref<zxing::Result> result(obj->Decode(Image::Pixels(obj->image_)));
+        if (!result) {
             return scope.Close(Null());
-        } else {
-            return THROW(Error, e.what());
         }
+        return scope.Close(raw ? RawResultToObject(result) : ResultToObject(result));
+    } catch (const zxing::ReaderException& e) {
+        return THROW(Error, e.what());
     } catch (const zxing::IllegalArgumentException& e) {
         return THROW(Error, e.what());
     } catch (const zxing::Exception& e) {
@@ -297,6 +354,77 @@ Handle<Value> ZXing::FindCode(const Arguments &args)
     }
 }
 
+Handle<Value> ZXing::ResetFormatCounts(const Arguments &args)
+{
+    HandleScope scope;
+    ZXing* obj = ObjectWrap::Unwrap<ZXing>(args.This());
+    obj->reader_->resetHits();
+    return args.This();
+}
+
+zxing::Ref<zxing::Result> ZXing::Decode(Pix *pix)
+{
+    zxing::Ref<PixSource> source(new PixSource(pix));
+    zxing::Ref<zxing::Binarizer> binarizer(new zxing::HybridBinarizer(source));
+    zxing::Ref<zxing::BinaryBitmap> binary(new zxing::BinaryBitmap(binarizer));
+    try {
+        return reader_->decode(binary, hints_);
+    } catch (const zxing::ReaderException& e) {
+        if (strcmp(e.what(), "No code detected") == 0) {
+            return zxing::Ref<zxing::Result>();
+        }
+        throw;
+    }
+}
+
+Local<Object> ZXing::ResultToObject(zxing::Ref<zxing::Result> result, int offsetX, int offsetY)
+{
+    HandleScope scope;
+    Local<Object> object = Object::New();
+    const std::string &resultStr = result->getText()->getText();
+    object->Set(String::NewSymbol("type"), String::New(zxing::BarcodeFormat::barcodeFormatNames[result->getBarcodeFormat()]));
+    object->Set(String::NewSymbol("data"), String::New(resultStr.data(), resultStr.length()));
+    object->Set(String::NewSymbol("buffer"), node::Buffer::New((char*)resultStr.data(), resultStr.length())->handle_);
+    Local<Array> points = Array::New();
+    for (int i = 0; i < result->getResultPoints()->size(); ++i) {
+        Local<Object> point = Object::New();
+        point->Set(String::NewSymbol("x"), Number::New(result->getResultPoints()[i]->getX() + offsetX));
+        point->Set(String::NewSymbol("y"), Number::New(result->getResultPoints()[i]->getY() + offsetY));
+        points->Set(i, point);
+    }
+    object->Set(String::NewSymbol("points"), points);
+    return scope.Close(object);
+}
+
+Local<Object> ZXing::RawResultToObject(zxing::Ref<zxing::Result> result, int offsetX, int offsetY)
+{
+    HandleScope scope;
+    Local<Object> object = Object::New();
+    object->Set(String::NewSymbol("type"), String::New(zxing::BarcodeFormat::barcodeFormatNames[result->getBarcodeFormat()]));
+    // QR codes convert their text to UTF-8, so they keep the undecoded bytes
+    // of all segments apart. The text of other formats holds them as is.
+    const std::string &payload = result->getPayload().empty()
+            ? result->getText()->getText() : result->getPayload();
+    node::Buffer *buffer = node::Buffer::New(payload.data(), payload.length());
+    object->Set(String::NewSymbol("buffer"), buffer->handle_);
+    zxing::ArrayRef< zxing::Ref<zxing::ResultPoint> > &resultPoints = result->getResultPoints();
+    int count = resultPoints ? resultPoints->size() : 0;
+    float *coords;
+    Local<Object> points = createTypedArray("Float32Array", 2 * count, reinterpret_cast<void**>(&coords));
+    for (int i = 0; i < count; ++i) {
+        coords[2 * i] = resultPoints[i]->getX() + offsetX;
+        coords[2 * i + 1] = resultPoints[i]->getY() + offsetY;
+    }
+    object->Set(String::NewSymbol("points"), points);
+    if (!result->getECLevel().empty()) {
+        object->Set(String::NewSymbol("ecLevel"), String::New(result->getECLevel().c_str()));
+    }
+    if (!result->getCharset().empty()) {
+        object->Set(String::NewSymbol("charset"), String::New(result->getCharset().c_str()));
+    }
+    return scope.Close(object);
+}
+
 ZXing::ZXing()
     : hints_(zxing::DecodeHints::DEFAULT_HINT), reader_(new zxing::MultiFormatReader)
 {
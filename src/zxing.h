@@ -26,14 +26,32 @@
 #include <node.h>
 #include <zxing/DecodeHints.h>
 #include <zxing/MultiFormatReader.h>
+#include <zxing/Result.h>
+#include <allheaders.h>
 
 namespace binding {
 
 class ZXing : public node::ObjectWrap
 {
 public:
+    static v8::Persistent<v8::FunctionTemplate> constructor_template;
+
+    static bool HasInstance(v8::Handle<v8::Value> val);
+
     static void Init(v8::Handle<v8::Object> target);
 
+    // Decodes pix with the current hints. Returns an empty ref if no code was found.
+    zxing::Ref<zxing::Result> Decode(Pix *pix);
+
+    // Converts result to a JS object, translating points by (offsetX, offsetY).
+    static v8::Local<v8::Object> ResultToObject(zxing::Ref<zxing::Result> result,
+                                                int offsetX = 0, int offsetY = 0);
+
+    // Like ResultToObject, but returns the payload bytes as a Buffer and the
+    // points as a Float32Array (x0, y0, x1, y1, ...) without creating strings.
+    static v8::Local<v8::Object> RawResultToObject(zxing::Ref<zxing::Result> result,
+                                                   int offsetX = 0, int offsetY = 0);
+
 private:
     static v8::Handle<v8::Value> New(const v8::Arguments& args);
 
@@ -44,9 +62,15 @@ private:
     static void SetFormats(v8::Local<v8::String> prop, v8::Local<v8::Value> value, const v8::AccessorInfo &info);
     static v8::Handle<v8::Value> GetTryHarder(v8::Local<v8::String> prop, const v8::AccessorInfo &info);
     static void SetTryHarder(v8::Local<v8::String> prop, v8::Local<v8::Value> value, const v8::AccessorInfo &info);
+    static v8::Handle<v8::Value> GetParallelRows(v8::Local<v8::String> prop, const v8::AccessorInfo &info);
+    static void SetParallelRows(v8::Local<v8::String> prop, v8::Local<v8::Value> value, const v8::AccessorInfo &info);
+    static v8::Handle<v8::Value> GetAdaptiveOrder(v8::Local<v8::String> prop, const v8::AccessorInfo &info);
+    static void SetAdaptiveOrder(v8::Local<v8::String> prop, v8::Local<v8::Value> value, const v8::AccessorInfo &info);
+    static v8::Handle<v8::Value> GetFormatCounts(v8::Local<v8::String> prop, const v8::AccessorInfo &info);
 
     // Methods.
     static v8::Handle<v8::Value> FindCode(const v8::Arguments& args);
+    static v8::Handle<v8::Value> ResetFormatCounts(const v8::Arguments& args);
 
     ZXing();
     ~ZXing();
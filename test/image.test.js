@@ -14,6 +14,226 @@ var writeImage = function(basename, image){
     }
 }
 
+// Gray erosion (pick = Math.min) or dilation (pick = Math.max) of a gray
+// image with a width x height brick, computed pixel by pixel on its raw data.
+// Pixels outside the image are ignored.
+var grayMorphReference = function(image, width, height, pick){
+    var w = image.width, h = image.height;
+    var src = image.toBuffer();
+    var rows = new Buffer(w * h);
+    var dst = new Buffer(w * h);
+    for (var y = 0; y < h; ++y) {
+        for (var x = 0; x < w; ++x) {
+            var value = src[y * w + x];
+            for (var i = Math.max(0, x - (width >> 1)); i <= Math.min(w - 1, x + (width >> 1)); ++i)
+                value = pick(value, src[y * w + i]);
+            rows[y * w + x] = value;
+        }
+    }
+    for (var y = 0; y < h; ++y) {
+        for (var x = 0; x < w; ++x) {
+            var value = rows[y * w + x];
+            for (var j = Math.max(0, y - (height >> 1)); j <= Math.min(h - 1, y + (height >> 1)); ++j)
+                value = pick(value, rows[j * w + x]);
+            dst[y * w + x] = value;
+        }
+    }
+    return dst;
+}
+
+// Binary erosion or dilation of a 1 bpp image with a width x height brick,
+// as raw 8 bpp data (0 where the result is on), computed pixel by pixel.
+// Like leptonica, the brick has its origin at (width / 2, height / 2) and
+// erosion takes the pixels outside the image as off.
+var binaryMorphReference = function(image, width, height, erode){
+    var w = image.width, h = image.height;
+    var src = image.toBuffer();
+    var left = erode ? width >> 1 : width - 1 - (width >> 1);
+    var top = erode ? height >> 1 : height - 1 - (height >> 1);
+    var rows = new Buffer(w * h);
+    var dst = new Buffer(w * h);
+    for (var y = 0; y < h; ++y) {
+        for (var x = 0; x < w; ++x) {
+            var on = erode;
+            for (var i = x - left; i < x - left + width && on == erode; ++i)
+                on = i >= 0 && i < w && src[y * w + i] == 0;
+            rows[y * w + x] = on;
+        }
+    }
+    for (var y = 0; y < h; ++y) {
+        for (var x = 0; x < w; ++x) {
+            var on = erode;
+            for (var j = y - top; j < y - top + height && on == erode; ++j)
+                on = j >= 0 && j < h && rows[j * w + x] == 1;
+            dst[y * w + x] = on ? 0 : 255;
+        }
+    }
+    return dst;
+}
+
+// Binary closing with a width x height brick that, like pixCloseSafeBrick(),
+// does not erode pixels near the edges: the image is closed inside a margin
+// of off pixels, which is cropped away afterwards.
+var binarySafeCloseReference = function(image, width, height){
+    var margin = Math.max(width, height);
+    var padded = new dv.Image(image.width + 2 * margin, image.height + 2 * margin, 1);
+    padded.drawImage(image, margin, margin, image.width, image.height);
+    return padded.close(width, height).crop(margin, margin, image.width, image.height);
+}
+
+// Separable blur of a gray image as raw 8 bpp data, computed pixel by pixel.
+// The horizontal kernels are applied to the rows in turn, and the vertical
+// ones to the columns, with the pixels at the edges repeated. Like the
+// binding, the rows are rounded to bytes once and the columns after each
+// kernel.
+var blurReference = function(image, horizontal, vertical){
+    var w = image.width, h = image.height;
+    var src = image.toBuffer();
+    var convolve = function(get, n, kernel){
+        var radius = (kernel.length - 1) / 2;
+        var out = [];
+        for (var i = 0; i < n; ++i) {
+            var sum = 0;
+            for (var k = -radius; k <= radius; ++k)
+                sum += kernel[k + radius] * get(Math.min(Math.max(i + k, 0), n - 1));
+            out.push(sum);
+        }
+        return out;
+    };
+    var toByte = function(value){
+        return Math.min(Math.floor(value + 0.5), 255);
+    };
+    var dst = new Buffer(w * h);
+    for (var y = 0; y < h; ++y) {
+        var row = Array.prototype.slice.call(src, y * w, (y + 1) * w);
+        horizontal.forEach(function(kernel){
+            row = convolve(function(x){ return row[x]; }, w, kernel);
+        });
+        for (var x = 0; x < w; ++x)
+            dst[y * w + x] = toByte(row[x]);
+    }
+    vertical.forEach(function(kernel){
+        for (var x = 0; x < w; ++x) {
+            var column = convolve(function(y){ return dst[y * w + x]; }, h, kernel);
+            for (var y = 0; y < h; ++y)
+                dst[y * w + x] = toByte(column[y]);
+        }
+    });
+    return dst;
+}
+
+var boxKernel = function(radius){
+    var kernel = [];
+    for (var k = -radius; k <= radius; ++k)
+        kernel.push(1 / (2 * radius + 1));
+    return kernel;
+}
+
+// Gaussian blur as the binding does it: up to a sigma of 3 with a kernel
+// reaching three sigmas, above with three boxes of odd sizes whose
+// variances, (size^2 - 1) / 12, add up to about sigma^2.
+var gaussianBlurReference = function(image, sigma){
+    var kernels = [];
+    if (sigma <= 3) {
+        var radius = Math.ceil(3 * sigma), kernel = [], total = 0;
+        for (var k = -radius; k <= radius; ++k) {
+            kernel.push(Math.exp(-0.5 * k * k / (sigma * sigma)));
+            total += kernel[kernel.length - 1];
+        }
+        kernels.push(kernel.map(function(weight){ return weight / total; }));
+    } else {
+        var lower = Math.floor(Math.sqrt(4 * sigma * sigma + 1));
+        if (lower % 2 == 0)
+            --lower;
+        var numLower = Math.round((12 * sigma * sigma - 3 * lower * lower - 12 * lower - 9) /
+                                  (-4 * lower - 4));
+        for (var i = 0; i < 3; ++i)
+            kernels.push(boxKernel(i < numLower ? (lower - 1) / 2 : (lower + 1) / 2));
+    }
+    return blurReference(image, kernels, kernels);
+}
+
+// Checks that two raw images differ by at most tolerance (default one)
+// levels per byte, which is what float rounding may change.
+var shouldNearlyEqual = function(actual, expected, tolerance){
+    actual.length.should.equal(expected.length);
+    for (var i = 0; i < actual.length; ++i) {
+        if (Math.abs(actual[i] - expected[i]) > (tolerance || 1))
+            actual[i].should.equal(expected[i], 'byte ' + i);
+    }
+}
+
+// The weights of the source pixels [first, first + weights.length) for each
+// of dst pixels scaled from src ones. 'area' weighs source pixels by how
+// much of them the destination pixel covers, the others center their
+// filter on it and widen it when shrinking.
+var resampleWeights = function(filter, src, dst){
+    var scale = src / dst;
+    var sinc = function(x){
+        return x == 0 ? 1 : Math.sin(Math.PI * x) / (Math.PI * x);
+    };
+    var banks = [];
+    for (var i = 0; i < dst; ++i) {
+        var first, last, weight;
+        if (filter == 'area') {
+            var left = i * scale, right = (i + 1) * scale;
+            first = Math.floor(left);
+            last = Math.min(Math.ceil(right), src);
+            weight = function(j){
+                return Math.max(0, Math.min(j + 1, right) - Math.max(j, left));
+            };
+        } else {
+            var center = (i + 0.5) * scale, stretch = Math.max(scale, 1);
+            var radius = (filter == 'bilinear' ? 1 : 3) * stretch;
+            first = Math.max(Math.floor(center - radius), 0);
+            last = Math.min(Math.ceil(center + radius), src);
+            weight = function(j){
+                var x = (j + 0.5 - center) / stretch;
+                if (filter == 'bilinear')
+                    return Math.max(0, 1 - Math.abs(x));
+                return Math.abs(x) < 3 ? sinc(x) * sinc(x / 3) : 0;
+            };
+        }
+        var weights = [], total = 0;
+        for (var j = first; j < last; ++j) {
+            weights.push(weight(j));
+            total += weights[weights.length - 1];
+        }
+        banks.push({first: first, weights: weights.map(function(w){ return w / total; })});
+    }
+    return banks;
+}
+
+// Scaling of a gray image to width x height as raw 8 bpp data, computed
+// pixel by pixel: first along the rows and then along the columns, rounding
+// to bytes after each.
+var resampleReference = function(image, width, height, filterX, filterY){
+    var w = image.width, h = image.height;
+    var src = image.toBuffer();
+    var toByte = function(value){
+        return Math.min(Math.max(Math.floor(value + 0.5), 0), 255);
+    };
+    var apply = function(bank, get){
+        var sum = 0;
+        for (var k = 0; k < bank.weights.length; ++k)
+            sum += bank.weights[k] * get(bank.first + k);
+        return toByte(sum);
+    };
+    var banksX = resampleWeights(filterX, w, width);
+    var banksY = resampleWeights(filterY, h, height);
+    var rows = new Buffer(width * h);
+    for (var y = 0; y < h; ++y) {
+        for (var x = 0; x < width; ++x)
+            rows[y * width + x] = apply(banksX[x], function(i){ return src[y * w + i]; });
+    }
+    var dst = new Buffer(width * height);
+    for (var y = 0; y < height; ++y) {
+        for (var x = 0; x < width; ++x)
+            dst[y * width + x] = apply(banksY[y], function(j){ return rows[j * width + x]; });
+    }
+    return dst;
+}
+
 describe('Image', function(){
     before(function(){
         this.gray = new dv.Image('png', fs.readFileSync(__dirname + '/fixtures/dave.png'));
@@ -85,6 +305,33 @@ describe('Image', function(){
     it('should #unsharp()', function(){
         writeImage('gray-unsharp.png', this.gray.unsharpMasking(6, 2.5));
     })
+    it('should #gaussianBlur()', function(){
+        writeImage('gray-gaussian-blur.png', this.gray.gaussianBlur(2));
+        writeImage('gray-gaussian-blur-large.png', this.gray.gaussianBlur(12));
+        writeImage('rgb-gaussian-blur.png', this.rgb.gaussianBlur(3));
+        // The 669 rows are blurred in bands of their own on machines with
+        // several processors, so this also covers the rows around the bands.
+        shouldNearlyEqual(this.gray.gaussianBlur(2).toBuffer(), gaussianBlurReference(this.gray, 2));
+        shouldNearlyEqual(this.gray.gaussianBlur(12).toBuffer(), gaussianBlurReference(this.gray, 12));
+        var target = new dv.Image(this.gray);
+        target.gaussianBlur(2, target).should.equal(target);
+        target.toBuffer().toString('base64').should.equal(
+            this.gray.gaussianBlur(2).toBuffer().toString('base64'));
+        (function(){
+            this.gray.threshold(128).gaussianBlur(2);
+        }).bind(this).should.throw();
+    })
+    it('should #boxBlur()', function(){
+        writeImage('gray-box-blur.png', this.gray.boxBlur(5, 3));
+        shouldNearlyEqual(this.gray.boxBlur(5, 3).toBuffer(),
+                          blurReference(this.gray, [boxKernel(5)], [boxKernel(3)]));
+        shouldNearlyEqual(this.gray.boxBlur(0, 40).toBuffer(),
+                          blurReference(this.gray, [], [boxKernel(40)]));
+        this.gray.boxBlur(0, 0).toBuffer().toString('base64').should.equal(
+            this.gray.toBuffer().toString('base64'));
+        var target = new dv.Image(this.rgb);
+        this.rgb.boxBlur(4, 4, target).should.equal(target);
+    })
     it('should #rotate()', function(){
         writeImage('gray-rotate.png', this.gray.rotate(-0.703125));
         writeImage('gray-rotate45.png', this.gray.rotate(45));
@@ -92,6 +339,38 @@ describe('Image', function(){
     it('should #scale()', function(){
         writeImage('gray-scale2.png', this.gray.scale(2.0, 2.0));
         writeImage('gray-scale05.png', this.gray.scale(0.5));
+        writeImage('gray-scale-lanczos.png', this.gray.scale(0.37, 'lanczos'));
+        writeImage('rgb-scale-bilinear.png', this.rgb.scale(1.5, 0.75, 'bilinear'));
+        var scaled = this.gray.scale(0.25, 'area');
+        scaled.width.should.equal(Math.round(this.gray.width * 0.25));
+        scaled.height.should.equal(Math.round(this.gray.height * 0.25));
+        // Both passes round to bytes, so float rounding may add up to two.
+        var gray = this.gray;
+        var checkScale = function(image, scaleX, scaleY, filter, filterX, filterY){
+            var width = Math.round(image.width * scaleX), height = Math.round(image.height * scaleY);
+            var scaled = filter ? image.scale(scaleX, scaleY, filter) : image.scale(scaleX, scaleY);
+            scaled.width.should.equal(width);
+            scaled.height.should.equal(height);
+            shouldNearlyEqual(scaled.toBuffer(),
+                              resampleReference(image, width, height, filterX, filterY), 2);
+        };
+        checkScale(gray, 0.37, 0.37, null, 'area', 'area');
+        checkScale(gray, 0.37, 0.37, 'lanczos', 'lanczos', 'lanczos');
+        // Small images have most of their pixels near the edges, where the
+        // taps of the filters are shifted inside the image.
+        var small = gray.crop(170, 300, 61, 47);
+        checkScale(small, 2, 2, null, 'bilinear', 'bilinear');
+        checkScale(small, 2.5, 0.6, null, 'bilinear', 'area');
+        checkScale(small, 2.5, 2.5, 'area', 'area', 'area');
+        checkScale(small, 0.45, 1.7, 'lanczos', 'lanczos', 'lanczos');
+        checkScale(gray.crop(170, 300, 5, 3), 1.4, 2, 'lanczos', 'lanczos', 'lanczos');
+        var binary = this.gray.threshold(128);
+        binary.scale(0.5).depth.should.equal(1);
+        binary.scale(0.25, 'area').depth.should.equal(8);
+        binary.scale(0.5, 0.25, 'area').depth.should.equal(8);
+        (function(){
+            this.gray.scale(0.5, 'cubic');
+        }).bind(this).should.throw();
     })
     it('should #crop()', function(){
         writeImage('gray-crop.png', this.gray.crop(100, 100, 100, 100));
@@ -117,6 +396,41 @@ describe('Image', function(){
     it('should #erode()', function(){
         writeImage('gray-erode.png', this.gray.erode(3, 3));
     })
+    it('should #erode() and #dilate() with large bricks', function(){
+        var eroded = this.gray.erode(41, 41);
+        eroded.toBuffer().toString('base64').should.equal(
+            grayMorphReference(this.gray, 41, 41, Math.min).toString('base64'));
+        this.gray.dilate(17, 5).toBuffer().toString('base64').should.equal(
+            grayMorphReference(this.gray, 17, 5, Math.max).toString('base64'));
+        writeImage('gray-erode41.png', eroded);
+    })
+    it('should #erode() and #dilate() binary images with large bricks', function(){
+        var binary = this.gray.threshold(128);
+        [[43, 1], [22, 1], [1, 61], [1, 30], [15, 9], [16, 7]].forEach(function(size){
+            binary.erode(size[0], size[1]).toBuffer().toString('base64').should.equal(
+                binaryMorphReference(binary, size[0], size[1], true).toString('base64'),
+                'erode ' + size);
+            binary.dilate(size[0], size[1]).toBuffer().toString('base64').should.equal(
+                binaryMorphReference(binary, size[0], size[1], false).toString('base64'),
+                'dilate ' + size);
+        });
+        writeImage('gray-threshold-close61.png', binary.close(61, 61));
+    })
+    it('should #morphSequence()', function(){
+        var binary = this.gray.threshold(128);
+        binary.morphSequence('o1.50 + c3.3 + d5.1').toBuffer().toString('base64').should.equal(
+            binarySafeCloseReference(binary.open(1, 50), 3, 3).dilate(5, 1).toBuffer().toString('base64'));
+        var full = binary.or(binary.invert());
+        full.morphSequence('c5.5').toBuffer().toString('base64').should.equal(
+            full.toBuffer().toString('base64'));
+        full.morphSequence('c70.3').toBuffer().toString('base64').should.equal(
+            binarySafeCloseReference(full, 70, 3).toBuffer().toString('base64'));
+        this.gray.morphSequence('o1.51 + c3.3 + d5.1').toBuffer().toString('base64').should.equal(
+            this.gray.open(1, 51).close(3, 3).dilate(5, 1).toBuffer().toString('base64'));
+        (function(){
+            binary.morphSequence('q5.5');
+        }).should.throw();
+    })
     it('should #dilate()', function(){
         writeImage('gray-dilate.png', this.gray.dilate(3, 3));
     })
@@ -137,6 +451,38 @@ describe('Image', function(){
         skew.angle.should.equal(-0.703125);
         skew.confidence.should.equal(4.957831859588623);
     })
+    it('should #compress()', function(){
+        var images = [this.gray, this.rgb, this.rgba, this.textpage.threshold(128)];
+        for (var i = 0; i < images.length; i++) {
+            var compressed = images[i].compress();
+            compressed.width.should.equal(images[i].width);
+            compressed.height.should.equal(images[i].height);
+            compressed.depth.should.equal(images[i].depth);
+            compressed.decompress().toBuffer().toString('base64').should.equal(
+                images[i].toBuffer().toString('base64'));
+        }
+        var compressed = new dv.CompressedImage(this.textpage);
+        compressed.byteLength.should.be.below(this.textpage.width * this.textpage.height / 2);
+        var decompressed = compressed.decompress();
+        var pixels = decompressed.toBuffer().toString('base64');
+        // Each call makes a new image, so changing one leaves the next alone.
+        decompressed.fillBox(0, 0, 100, 100, 0);
+        compressed.decompress().should.not.equal(decompressed);
+        compressed.decompress().toBuffer().toString('base64').should.equal(pixels);
+        writeImage('textpage-decompressed.png', decompressed);
+    })
+    it('should #deskew()', function(){
+        var threshold = this.gray.otsuAdaptiveThreshold(16, 16, 0, 0, 0.1);
+        var deskewed = threshold.image.deskew();
+        deskewed.angle.should.equal(-0.703125);
+        deskewed.confidence.should.equal(4.957831859588623);
+        deskewed = this.textpage.rotate(2).deskew();
+        deskewed.angle.should.be.within(-2.1, -1.9);
+        deskewed.confidence.should.be.above(3);
+        deskewed.image.width.should.equal(this.textpage.width);
+        deskewed.image.deskew().angle.should.be.within(-0.1, 0.1);
+        writeImage('textpage-deskew.png', deskewed.image);
+    })
     it('should #connectedComponents()', function(){
         var binaryImage = this.textpage.otsuAdaptiveThreshold(32, 32, 0, 0, 0.1).image;
         var boxes = binaryImage.connectedComponents(4);
@@ -198,6 +544,22 @@ describe('Image', function(){
         horizontal.length.should.equal(400);
         var vertical = this.gray.threshold(254).projection('vertical');
         vertical.length.should.equal(669);
+        vertical.should.be.an.instanceof(Uint32Array);
+    })
+    it('should #projection() within a box and mask', function() {
+        var binary = this.gray.threshold(128);
+        var slice = Array.prototype.slice;
+        ['horizontal', 'vertical'].forEach(function(mode) {
+            slice.call(binary.projection(mode, 33, 17, 150, 200)).should.deep.equal(
+                slice.call(binary.crop(33, 17, 150, 200).projection(mode)));
+            slice.call(this.gray.projection(mode, 33, 17, 150, 200)).should.deep.equal(
+                slice.call(this.gray.crop(33, 17, 150, 200).projection(mode)));
+            var mask = new dv.Image(binary).invert();
+            slice.call(binary.projection(mode, mask)).should.deep.equal(
+                slice.call(binary.and(mask).projection(mode)));
+            this.gray.projection(mode, mask, 390, 660, 100, 100).length.should.equal(
+                mode == 'horizontal' ? 10 : 9);
+        }, this);
     })
     it('should #applyCurve() and #setMasked()', function() {
         var curve = new Array(256);
@@ -209,3 +571,130 @@ describe('Image', function(){
         writeImage('gray-setmasked.png', new dv.Image(this.gray).setMasked(mask, 255));
     })
 })
+
+describe('RunLengthImage', function(){
+    before(function(){
+        var textpage = new dv.Image('png', fs.readFileSync(__dirname + '/fixtures/textpage300.png'));
+        this.binary = textpage.otsuAdaptiveThreshold(32, 32, 0, 0, 0.1).image;
+        this.runs = this.binary.toRunLength();
+    })
+    it('should #toImage()', function(){
+        this.runs.width.should.equal(this.binary.width);
+        this.runs.height.should.equal(this.binary.height);
+        this.runs.runCount.should.be.above(0);
+        this.runs.toImage().toBuffer().toString('base64').should.equal(
+            this.binary.toBuffer().toString('base64'));
+    })
+    it('should #projection()', function(){
+        var slice = Array.prototype.slice;
+        slice.call(this.runs.projection('horizontal')).should.deep.equal(
+            slice.call(this.binary.projection('horizontal')));
+        slice.call(this.runs.projection('vertical')).should.deep.equal(
+            slice.call(this.binary.projection('vertical')));
+    })
+    it('should #connectedComponents() and #boundingBox()', function(){
+        this.runs.connectedComponents(4).should.deep.equal(this.binary.connectedComponents(4));
+        this.runs.connectedComponents(8).should.deep.equal(this.binary.connectedComponents(8));
+        var box = this.runs.boundingBox();
+        box.x.should.be.within(0, this.binary.width);
+        (new dv.RunLengthImage(new dv.Image(10, 10, 1)).boundingBox() === null).should.be.true;
+    })
+    it('should #or(), #and(), #xor()', function(){
+        var other = this.binary.dilate(3, 3);
+        var otherRuns = new dv.RunLengthImage(other);
+        var ops = ['or', 'and', 'xor'];
+        for (var i = 0; i < ops.length; i++) {
+            this.runs[ops[i]](otherRuns).toImage().toBuffer().toString('base64').should.equal(
+                this.binary[ops[i]](other).toBuffer().toString('base64'));
+        }
+        (function(){
+            this.runs.or(new dv.RunLengthImage(new dv.Image(10, 10, 1)));
+        }).bind(this).should.throw();
+    })
+})
+
+describe('ImageReader', function(){
+    before(function(){
+        this.filename = __dirname + '/fixtures/multipage.tif';
+    })
+    it('should #next() through all pages', function(){
+        var reader = new dv.ImageReader('tiff', fs.readFileSync(this.filename));
+        reader.pageCount.should.equal(3);
+        var depths = [];
+        for (var image = reader.next(); image !== null; image = reader.next()) {
+            image.width.should.equal(400);
+            image.height.should.equal(300);
+            depths.push(image.depth);
+            writeImage('multipage-' + depths.length + '.png', image);
+        }
+        depths.should.deep.equal([1, 8, 32]);
+    })
+    it('should decode the pixels of each page', function(){
+        // The pages hold the same part of textpage300.png: thresholded at 128
+        // and PackBits compressed, gray with LZW and a horizontal predictor,
+        // and with LZW in the red and green channels of a blue RGB page.
+        var textpage = new dv.Image('png', fs.readFileSync(__dirname + '/fixtures/textpage300.png'));
+        var gray = textpage.crop(300, 300, 400, 300);
+        var reader = new dv.ImageReader('tiff', fs.readFileSync(this.filename));
+        reader.next().toBuffer().toString('base64').should.equal(
+            gray.threshold(128).toBuffer().toString('base64'));
+        reader.next().toBuffer().toString('base64').should.equal(
+            gray.toBuffer().toString('base64'));
+        var rgb = reader.next();
+        rgb.toGray(1, 0, 0).toBuffer().toString('base64').should.equal(
+            gray.toBuffer().toString('base64'));
+        rgb.toGray(0, 1, 0).toBuffer().toString('base64').should.equal(
+            gray.toBuffer().toString('base64'));
+        rgb.toGray(0, 0, 1).toBuffer().toString('base64').should.equal(
+            new dv.Image(400, 300, 8).invert().toBuffer().toString('base64'));
+    })
+    it('should #page() in any order', function(){
+        var reader = new dv.ImageReader('tiff', this.filename);
+        var last = reader.page(2);
+        last.depth.should.equal(32);
+        reader.page(0).depth.should.equal(1);
+        reader.next().depth.should.equal(8);
+        reader.page(2).toBuffer().toString('base64').should.equal(
+            last.toBuffer().toString('base64'));
+        (reader.next() === null).should.be.true;
+        (function(){
+            reader.page(3);
+        }).should.throw();
+        (function(){
+            new dv.ImageReader('tiff', fs.readFileSync(__dirname + '/fixtures/dave.png'));
+        }).should.throw();
+    })
+})
+
+describe('pixPool', function(){
+    before(function(){
+        this.gray = new dv.Image('png', fs.readFileSync(__dirname + '/fixtures/textpage300.png')).toGray();
+    })
+    after(function(){
+        dv.pixPool.configure({ capacity: 64 << 20, minBufferSize: 64 << 10 });
+    })
+    it('should reuse buffers', function(){
+        dv.pixPool.configure({ capacity: 64 << 20, minBufferSize: 64 << 10 });
+        dv.pixPool.clear();
+        dv.pixPool.stats().bytesHeld.should.equal(0);
+        this.gray.scale(0.5);
+        var before = dv.pixPool.stats();
+        before.bytesHeld.should.be.above(0);
+        before.buffersHeld.should.be.above(0);
+        this.gray.scale(0.5);
+        dv.pixPool.stats().hits.should.be.above(before.hits);
+    })
+    it('should #configure() its capacity', function(){
+        this.gray.scale(0.5);
+        dv.pixPool.configure({ capacity: 0 });
+        var stats = dv.pixPool.stats();
+        stats.capacity.should.equal(0);
+        stats.bytesHeld.should.equal(0);
+        stats.buffersHeld.should.equal(0);
+        this.gray.scale(0.5);
+        dv.pixPool.stats().bytesHeld.should.equal(0);
+        (function(){
+            dv.pixPool.configure({ capacity: -1 });
+        }).should.throw();
+    })
+})
@@ -48,6 +48,31 @@ describe('Tesseract', function(){
     it('should set #image', function(){
         this.tesseract.image = this.textPage300;
     })
+    it('should #thresholdImage()', function(){
+        var binary = this.tesseract.thresholdImage();
+        binary.depth.should.equal(1);
+        binary.width.should.equal(this.textPage300.width);
+        binary.height.should.equal(this.textPage300.height);
+        // Grey images are packed 32 pixels at a time with SIMD, colour
+        // images one pixel at a time. The grey channels give the same result.
+        this.tesseract.image = this.textPage300.toColor();
+        this.tesseract.thresholdImage().toBuffer().toString('base64')
+            .should.equal(binary.toBuffer().toString('base64'));
+        this.tesseract.image = this.textPage300;
+    })
+    it('should #thresholdImage() within #rectangle', function(){
+        var rectangle = {x: 33, y: 17, width: 701, height: 400};
+        this.tesseract.rectangle = rectangle;
+        var binary = this.tesseract.thresholdImage();
+        binary.depth.should.equal(1);
+        binary.width.should.equal(701);
+        binary.height.should.equal(400);
+        this.tesseract.image = this.textPage300.toColor();
+        this.tesseract.rectangle = rectangle;
+        this.tesseract.thresholdImage().toBuffer().toString('base64')
+            .should.equal(binary.toBuffer().toString('base64'));
+        this.tesseract.image = this.textPage300;
+    })
     it('should set/get #symbolWhitelist', function(){
         this.tesseract.symbolWhitelist = '0123456789';
         this.tesseract.symbolWhitelist.should.equal('0123456789');
@@ -105,6 +130,61 @@ describe('Tesseract', function(){
     it('should #findSymbols(false)', function(){
         writeImageBoxes('textpage300-symbols.png', this.textPage300, this.tesseract.findSymbols(false));
     })
+    it('should #findTextLines(false) within #blocks', function(){
+        this.tesseract.image = this.textPage300;
+        var region = this.tesseract.findRegions(false)[0].box;
+        this.tesseract.blocks = [region];
+        this.tesseract.blocks.should.have.length(1);
+        var lines = this.tesseract.findTextLines(false);
+        lines.should.not.be.empty;
+        lines.forEach(function(line){
+            line.box.x.should.be.within(region.x, region.x + region.width);
+            line.box.y.should.be.within(region.y, region.y + region.height);
+            (line.box.x + line.box.width).should.be.at.most(region.x + region.width);
+            (line.box.y + line.box.height).should.be.at.most(region.y + region.height);
+        });
+        this.tesseract.findTextLines().should.have.length(lines.length);
+        this.tesseract.blocks = null;
+        should.not.exist(this.tesseract.blocks);
+        this.tesseract.findTextLines(false).length.should.be.above(lines.length);
+    })
+    it('should #findTextLines(false) within #blocks and #rectangle', function(){
+        this.tesseract.image = this.textPage300;
+        var region = this.tesseract.findRegions(false)[0].box;
+        // Blocks are in image coordinates, the results relative to the rectangle.
+        var rectangle = {x: Math.max(region.x - 20, 0), y: Math.max(region.y - 20, 0),
+                         width: region.width + 40, height: region.height + 40};
+        this.tesseract.rectangle = rectangle;
+        this.tesseract.blocks = [region];
+        var lines = this.tesseract.findTextLines(false);
+        lines.should.not.be.empty;
+        lines.forEach(function(line){
+            line.box.x.should.be.at.least(region.x - rectangle.x);
+            line.box.y.should.be.at.least(region.y - rectangle.y);
+            (line.box.x + line.box.width).should.be.at.most(region.x - rectangle.x + region.width);
+            (line.box.y + line.box.height).should.be.at.most(region.y - rectangle.y + region.height);
+        });
+        this.tesseract.blocks = null;
+        this.tesseract.image = this.textPage300;
+    })
+    it('should reject invalid #blocks', function(){
+        var tesseract = this.tesseract;
+        var block = {x: 10, y: 20, width: 300, height: 200};
+        tesseract.blocks = [block];
+        [[5], [null], [{x: 10, y: 20, width: 300}], [block, {x: 10, y: 20, width: '300', height: 200}],
+         [{x: NaN, y: 20, width: 300, height: 200}]].forEach(function(blocks){
+            (function(){
+                tesseract.blocks = blocks;
+            }).should.throw(TypeError);
+            tesseract.blocks.should.have.length(1);
+            tesseract.blocks[0].should.equal(block);
+        });
+        (function(){
+            tesseract.blocks = block;
+        }).should.throw(TypeError);
+        tesseract.blocks = null;
+        should.not.exist(tesseract.blocks);
+    })
     it('should #findText(\'plain\')', function(){
         this.tesseract.image = this.textPage300;
         compareTextParagraph(this.tesseract.findText('plain'));
@@ -139,3 +219,186 @@ describe('Tesseract', function(){
         this.tesseract.findText('hocr', 0);
     })
 })
+
+describe('Tesseract benchmark', function(){
+    before(function(){
+        this.tesseract = new dv.Tesseract();
+    })
+    var pages = ['textpage300', 'formpage300'];
+    it('should recognize textpage300', function(){
+        this.timeout(60000);
+        this.slow(10000);
+        this.tesseract.image = new dv.Image("png", fs.readFileSync(__dirname + '/fixtures/textpage300.png'));
+        var result = this.tesseract.findText('plain', true);
+        compareTextParagraph(result.text);
+        result.confidence.should.be.above(90);
+    })
+    it('should recognize formpage300', function(){
+        this.timeout(60000);
+        this.slow(10000);
+        this.tesseract.image = new dv.Image("png", fs.readFileSync(__dirname + '/fixtures/formpage300.png'));
+        var text = this.tesseract.findText('plain').toLowerCase();
+        ['lorem', 'ipsum', 'dolor', 'consetetur', 'sadipscing', 'elitr', 'nonumy',
+         'eirmod', 'tempor', 'invidunt', 'labore', 'dolore', 'magna', 'aliquyam'].forEach(function(word){
+            text.should.contain(word);
+        });
+    })
+    it('should recognize the same text with the legacy class pruner', function(){
+        this.timeout(60000);
+        this.slow(20000);
+        this.tesseract.image = new dv.Image("png", fs.readFileSync(__dirname + '/fixtures/textpage300.png'));
+        this.tesseract.classify_simd_class_pruner.should.equal(true);
+        this.tesseract.clearAdaptiveClassifier();
+        var text = this.tesseract.findText('plain');
+        // Setting a variable discards the results held for the image.
+        this.tesseract.classify_simd_class_pruner = false;
+        this.tesseract.clearAdaptiveClassifier();
+        this.tesseract.findText('plain').should.equal(text);
+        this.tesseract.classify_simd_class_pruner = true;
+    })
+    it('should recognize the same text without the dawg lookup tables', function(){
+        this.timeout(60000);
+        this.slow(20000);
+        this.tesseract.image = new dv.Image("png", fs.readFileSync(__dirname + '/fixtures/textpage300.png'));
+        this.tesseract.dawg_lookup_tables.should.equal(true);
+        this.tesseract.clearAdaptiveClassifier();
+        var text = this.tesseract.findText('plain');
+        this.tesseract.dawg_lookup_tables = false;
+        this.tesseract.clearAdaptiveClassifier();
+        this.tesseract.findText('plain').should.equal(text);
+        this.tesseract.dawg_lookup_tables = true;
+    })
+    it('should continue from an imported adaptive classifier', function(){
+        this.timeout(60000);
+        this.slow(20000);
+        var image = new dv.Image("png", fs.readFileSync(__dirname + '/fixtures/formpage300.png'));
+        this.tesseract.image = image;
+        this.tesseract.clearAdaptiveClassifier();
+        this.tesseract.findText('plain');
+        var snapshot = this.tesseract.exportAdaptiveClassifier();
+        snapshot.should.be.an.instanceof(Buffer);
+        var other = new dv.Tesseract();
+        other.importAdaptiveClassifier(snapshot);
+        other.exportAdaptiveClassifier().length.should.equal(snapshot.length);
+        other.image = image;
+        var text = other.findText('plain');
+        text.should.equal(this.tesseract.findText('plain'));
+        (function(){
+            other.importAdaptiveClassifier(new Buffer('not a classifier'));
+        }).should.throw();
+        // A truncated snapshot leaves the classifier as it was.
+        other.importAdaptiveClassifier(snapshot);
+        (function(){
+            other.importAdaptiveClassifier(snapshot.slice(0, snapshot.length - 100));
+        }).should.throw();
+        other.exportAdaptiveClassifier().length.should.equal(snapshot.length);
+        other.image = image;
+        other.findText('plain').should.equal(text);
+    })
+    it('should #detectOrientation() and rotate the image upright', function(){
+        this.timeout(60000);
+        this.slow(20000);
+        var image = new dv.Image("png", fs.readFileSync(__dirname + '/fixtures/textpage300.png'));
+        this.tesseract.image = image.rotate(180);
+        var osd = this.tesseract.detectOrientation(50);
+        osd.orientation.should.equal(180);
+        osd.script.should.equal('Latin');
+        osd.rotated.should.be.false;
+        this.tesseract.detectOrientation(true).rotated.should.be.true;
+        this.tesseract.image.width.should.equal(image.width);
+        this.tesseract.detectOrientation().orientation.should.equal(0);
+        compareTextParagraph(this.tesseract.findText('plain'));
+    })
+    it('should #detectOrientation() and rotate a quarter-turned image upright', function(){
+        this.timeout(120000);
+        this.slow(40000);
+        var image = new dv.Image("png", fs.readFileSync(__dirname + '/fixtures/textpage300.png'));
+        // Image#rotate keeps the size, so the page is put on a white square
+        // first to turn it without cropping.
+        var size = Math.max(image.width, image.height);
+        var square = new dv.Image(size, size, 8).invert();
+        square.drawImage(image, 0, 0, image.width, image.height);
+        // Turned clockwise, the page needs the opposite turn to be upright.
+        var turns = [{angle: 90, orientation: 270}, {angle: -90, orientation: 90}];
+        for (var i = 0; i < turns.length; ++i) {
+            this.tesseract.image = square.rotate(turns[i].angle);
+            var osd = this.tesseract.detectOrientation(true);
+            osd.orientation.should.equal(turns[i].orientation);
+            osd.rotated.should.be.true;
+            this.tesseract.detectOrientation().orientation.should.equal(0);
+            compareTextParagraph(this.tesseract.findText('plain'));
+        }
+    })
+    it('should scale a 600dpi page down to #tessedit_target_xheight', function(){
+        this.timeout(60000);
+        this.slow(20000);
+        var image = new dv.Image("png", fs.readFileSync(__dirname + '/fixtures/textpage300.png')).scale(2);
+        this.tesseract.image = image;
+        this.tesseract.tessedit_target_xheight = 22;
+        compareTextParagraph(this.tesseract.findText('plain'));
+        this.tesseract.thresholdImage().width.should.be.below(image.width * 0.6);
+        this.tesseract.findWords().forEach(function(word){
+            (word.box.x + word.box.width).should.be.at.most(image.width);
+            (word.box.y + word.box.height).should.be.at.most(image.height);
+        });
+        this.tesseract.findTextLines().pop().box.y.should.be.above(image.height / 2);
+        this.tesseract.tessedit_target_xheight = 0;
+    })
+    it('should recognize text lines in parallel', function(){
+        this.timeout(60000);
+        this.slow(20000);
+        var textpage = new dv.Image("png", fs.readFileSync(__dirname + '/fixtures/textpage300.png'));
+        this.tesseract.tessedit_parallel_threads = 4;
+        this.tesseract.image = textpage;
+        var text = this.tesseract.findText('plain');
+        compareTextParagraph(text);
+        // Every page starts from an empty classifier, so the text of a page
+        // doesn't depend on the pages before it.
+        this.tesseract.image = new dv.Image("png", fs.readFileSync(__dirname + '/fixtures/formpage300.png'));
+        this.tesseract.findText('plain');
+        this.tesseract.image = textpage;
+        this.tesseract.findText('plain').should.equal(text);
+        this.tesseract.tessedit_parallel_threads = 0;
+    })
+    it('should keep an imported adaptive classifier when recognizing in parallel', function(){
+        this.timeout(60000);
+        this.slow(20000);
+        var image = new dv.Image("png", fs.readFileSync(__dirname + '/fixtures/textpage300.png'));
+        this.tesseract.image = image;
+        this.tesseract.clearAdaptiveClassifier();
+        this.tesseract.findText('plain');
+        var snapshot = this.tesseract.exportAdaptiveClassifier();
+        var other = new dv.Tesseract();
+        other.importAdaptiveClassifier(snapshot);
+        other.tessedit_parallel_threads = 4;
+        other.image = image;
+        compareTextParagraph(other.findText('plain'));
+        other.exportAdaptiveClassifier().length.should.be.at.least(snapshot.length);
+    })
+    it('should recognize the same text with many engines on many threads', function(){
+        this.timeout(300000);
+        this.slow(60000);
+        var images = pages.map(function(page){
+            return new dv.Image("png", fs.readFileSync(__dirname + '/fixtures/' + page + '.png'));
+        });
+        // Each engine recognizes on 8 threads, with 7 worker engines that
+        // share its dawgs and those of the other engines.
+        var engines = [new dv.Tesseract(), new dv.Tesseract(), new dv.Tesseract()];
+        engines.forEach(function(tesseract){
+            tesseract.tessedit_parallel_threads = 8;
+        });
+        var expected = images.map(function(image){
+            engines[0].image = image;
+            return engines[0].findText('plain');
+        });
+        compareTextParagraph(expected[0]);
+        for (var run = 0; run < 3; ++run) {
+            engines.forEach(function(tesseract, i){
+                images.forEach(function(image, j){
+                    tesseract.image = image;
+                    tesseract.findText('plain').should.equal(expected[j], 'Engine ' + i + ', ' + pages[j]);
+                });
+            });
+        }
+    })
+})
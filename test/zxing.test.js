@@ -9,6 +9,7 @@ describe('ZXing', function(){
         this.barcode1 = new dv.Image("png", fs.readFileSync(__dirname + '/fixtures/barcode1.png'));
         this.barcode2 = new dv.Image("png", fs.readFileSync(__dirname + '/fixtures/barcode2.png'));
         this.barcode3 = new dv.Image("png", fs.readFileSync(__dirname + '/fixtures/barcode3.png'));
+        this.qrcodeMixed = new dv.Image("png", fs.readFileSync(__dirname + '/fixtures/qrcode-mixed.png'));
     })
     it('should have no #image set', function(){
         should.not.exist(this.zxing.image);
@@ -23,6 +24,15 @@ describe('ZXing', function(){
     it('should have #tryHarder', function(){
         should.exist(this.zxing.tryHarder);
     })
+    it('should have #parallelRows', function(){
+        should.exist(this.zxing.parallelRows);
+    })
+    it('should have #adaptiveOrder', function(){
+        this.zxing.adaptiveOrder.should.equal(false);
+    })
+    it('should have #formatCounts', function(){
+        this.zxing.formatCounts.QR_CODE.should.equal(0);
+    })
     describe('#findCode()', function(){
         it('should find nothing', function(){
             this.zxing.image = this.textpage300;
@@ -51,6 +61,38 @@ describe('ZXing', function(){
             should.exist(code.points);
         })
     })
+    describe('#findCode(true)', function(){
+        it('should find nothing', function(){
+            this.zxing.image = this.textpage300;
+            var code = this.zxing.findCode(true);
+            should.not.exist(code);
+        })
+        it('should find raw ITF-10', function(){
+            this.zxing.image = this.barcode1;
+            var code = this.zxing.findCode(true);
+            code.type.should.equal('ITF');
+            code.buffer.toString().should.equal('1234567890');
+            should.not.exist(code.data);
+            code.points.should.be.an.instanceof(Float32Array);
+            (code.points.length % 2).should.equal(0);
+        })
+        it('should find raw PDF417', function(){
+            this.zxing.image = this.barcode3;
+            var code = this.zxing.findCode(true);
+            code.type.should.equal('PDF_417');
+            code.buffer.toString().should.equal('This PDF417 barcode has error correction level 4');
+            code.points.should.be.an.instanceof(Float32Array);
+            should.exist(code.ecLevel);
+        })
+        it('should find raw QR code with mixed segments', function(){
+            // Numeric, alphanumeric, Kanji (Shift_JIS) and byte (UTF-8) segments.
+            this.zxing.image = this.qrcodeMixed;
+            var code = this.zxing.findCode(true);
+            code.type.should.equal('QR_CODE');
+            code.buffer.toString('hex').should.equal('30313233343536373839303132' +
+                '48454c4c4f20574f524c44' + '93fa967b' + 'c3a974c3a9');
+        })
+    })
     describe('#findCode() with tryHarder', function(){
         before(function(){
             this.zxing.tryHarder = true;
@@ -68,4 +110,103 @@ describe('ZXing', function(){
             should.exist(code.points);
         })
     })
+    describe('#findCode() with adaptiveOrder', function(){
+        before(function(){
+            this.zxing.adaptiveOrder = true;
+            this.zxing.resetFormatCounts();
+        })
+        after(function(){
+            this.zxing.adaptiveOrder = false;
+        })
+        it('should count found formats', function(){
+            this.zxing.image = this.barcode3;
+            this.zxing.findCode().type.should.equal('PDF_417');
+            this.zxing.image = this.barcode1;
+            this.zxing.findCode().type.should.equal('ITF');
+            this.zxing.findCode().type.should.equal('ITF');
+            this.zxing.formatCounts.ITF.should.equal(2);
+            this.zxing.formatCounts.PDF_417.should.equal(1);
+        })
+        it('should find PDF417 after ITF', function(){
+            this.zxing.image = this.barcode3;
+            this.zxing.findCode().type.should.equal('PDF_417');
+        })
+        it('should reset #formatCounts', function(){
+            this.zxing.resetFormatCounts();
+            this.zxing.formatCounts.ITF.should.equal(0);
+        })
+    })
+    describe('#findCode() with parallelRows', function(){
+        before(function(){
+            this.zxing.parallelRows = true;
+        })
+        after(function(){
+            this.zxing.parallelRows = false;
+        })
+        it('should find nothing', function(){
+            this.zxing.image = this.textpage300
+            var code = this.zxing.findCode();
+            should.not.exist(code);
+        })
+        it('should find ITF-14', function(){
+            this.zxing.image = this.barcode2;
+            var code = this.zxing.findCode();
+            code.type.should.equal('ITF');
+            code.data.should.equal('12345678901231');
+            should.exist(code.points);
+        })
+    })
+})
+
+describe('BarcodeTracker', function(){
+    before(function(){
+        this.zxing = new dv.ZXing();
+        this.tracker = new dv.BarcodeTracker(this.zxing);
+        this.textpage300 = new dv.Image("png", fs.readFileSync(__dirname + '/fixtures/textpage300.png'));
+        this.barcode1 = new dv.Image("png", fs.readFileSync(__dirname + '/fixtures/barcode1.png'));
+    })
+    it('should have #zxing set', function(){
+        this.tracker.zxing.should.equal(this.zxing);
+    })
+    it('should have #fullSearchInterval', function(){
+        this.tracker.fullSearchInterval.should.equal(5);
+    })
+    it('should have #changeThreshold', function(){
+        should.exist(this.tracker.changeThreshold);
+    })
+    describe('#track()', function(){
+        it('should find nothing', function(){
+            var code = this.tracker.track(this.textpage300);
+            should.not.exist(code);
+        })
+        it('should find ITF-10', function(){
+            this.tracker.reset();
+            var code = this.tracker.track(this.barcode1);
+            code.type.should.equal('ITF');
+            code.data.should.equal('1234567890');
+            should.exist(code.points);
+        })
+        it('should keep tracking ITF-10', function(){
+            var code = this.tracker.track(this.barcode1);
+            code.type.should.equal('ITF');
+            code.data.should.equal('1234567890');
+        })
+        it('should search the whole frame at the interval', function(){
+            this.tracker.reset();
+            this.tracker.fullSearchInterval = 3;
+            var before = this.tracker.fullSearches;
+            for (var i = 0; i < 7; i++) {
+                var code = this.tracker.track(this.barcode1);
+                code.data.should.equal('1234567890');
+            }
+            // Frames 1, 4 and 7.
+            this.tracker.fullSearches.should.equal(before + 3);
+            this.tracker.fullSearchInterval = 5;
+        })
+        it('should lose ITF-10 after #reset()', function(){
+            this.tracker.reset();
+            var code = this.tracker.track(this.textpage300);
+            should.not.exist(code);
+        })
+    })
 })